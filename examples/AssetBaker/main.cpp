@@ -0,0 +1,119 @@
+/*
+* NessEngine asset baker - a command line tool to bake resources into an asset pack file.
+* the pack contains textures that are already decoded, so loading them in the game is just mapping the file and uploading the pixels.
+* usage: AssetBaker <resources_dir> <manifest_file> <output_pack> [--color-key r g b]
+*	resources_dir:	the folder with all the resources (the same path you use with renderer.resources().set_resources_path())
+*	manifest_file:	text file with the resources to bake, one per line, relative to resources_dir (lines that start with '#' are comments).
+*					use the same names you use to load them in the game, for example "gui/font.ttf" or "hello_world.png".
+*	output_pack:	the pack file to create. in the game, call renderer.resources().mount_pack() with it.
+*	--color-key:	if you use color key in your game, set it here (color key is baked into the textures).
+* PLEASE NOTE: this project relays on the folder examples/ness-engine to be one step above the project dir. so make sure you include it as well.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+#define _WINDOWS
+#include <NessEngine.h>
+#include <tchar.h>
+#include <iostream>
+#include <fstream>
+
+// return the lower case extension of a file name
+std::string get_extension(const std::string& file_name)
+{
+	size_t dot = file_name.find_last_of('.');
+	if (dot == std::string::npos)
+		return "";
+	std::string ext = file_name.substr(dot + 1);
+	for (unsigned int i = 0; i < ext.length(); i++)
+		ext[i] = (char)tolower(ext[i]);
+	return ext;
+}
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	// check arguments
+	if (argc != 4 && argc != 8)
+	{
+		std::cout << "usage: AssetBaker <resources_dir> <manifest_file> <output_pack> [--color-key r g b]" << std::endl;
+		return 1;
+	}
+	std::string resources_dir = argv[1];
+	std::string manifest_file = argv[2];
+	std::string output_pack = argv[3];
+	bool use_color_key = (argc == 8);
+	Ness::Colorb color_key;
+	if (use_color_key)
+	{
+		color_key = Ness::Colorb((unsigned char)atoi(argv[5]), (unsigned char)atoi(argv[6]), (unsigned char)atoi(argv[7]));
+	}
+
+	// init the engine (we only need it for image decoding)
+	Ness::init();
+
+	// open manifest file
+	std::ifstream manifest(manifest_file.c_str());
+	if (!manifest.is_open())
+	{
+		std::cout << "failed to open manifest file: " << manifest_file << std::endl;
+		return 1;
+	}
+
+	try
+	{
+		// add all the resources
+		Ness::Resources::AssetPackWriter writer;
+		std::string line;
+		while (std::getline(manifest, line))
+		{
+			// remove spaces and line breaks from the edges and skip empty lines and comments
+			size_t start = line.find_first_not_of(" \t\r\n");
+			size_t end = line.find_last_not_of(" \t\r\n");
+			if (start == std::string::npos)
+				continue;
+			line = line.substr(start, end - start + 1);
+			if (line[0] == '#')
+				continue;
+
+			// add by type
+			std::string file_name = resources_dir + "/" + line;
+			std::string ext = get_extension(line);
+			if (ext == "ttf" || ext == "otf" || ext == "fon")
+			{
+				std::cout << "font:    " << line << std::endl;
+				writer.add_font(line, file_name);
+			}
+			else if (ext == "png" || ext == "jpg" || ext == "jpeg" || ext == "bmp" || ext == "tif" || ext == "tiff" || ext == "gif" || ext == "tga")
+			{
+				std::cout << "texture: " << line << std::endl;
+				SDL_Surface* surface = IMG_Load(file_name.c_str());
+				if (surface == nullptr)
+				{
+					std::cout << "failed to load image: " << file_name << " reason: " << IMG_GetError() << std::endl;
+					return 1;
+				}
+				if (use_color_key)
+				{
+					SDL_SetColorKey(surface, SDL_TRUE, SDL_MapRGB(surface->format, color_key.r, color_key.g, color_key.b));
+				}
+				writer.add_texture(line, surface);
+				SDL_FreeSurface(surface);
+			}
+			else
+			{
+				std::cout << "file:    " << line << std::endl;
+				writer.add_file(line, file_name);
+			}
+		}
+
+		// write the pack
+		writer.write(output_pack);
+		std::cout << "done! baked " << writer.get_entries_count() << " resources into " << output_pack << std::endl;
+	}
+	catch (std::exception& e)
+	{
+		std::cout << "error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,81 @@
+/*
+* NessEngine kind flags benchmark. loops over the 10k lights of a light node the way the light node checks if it needs
+* to redraw, once with ness_ptr_cast (dynamic cast and shared pointer copy for every light) and once with the renderable
+* kind flags (is_kind() and ness_kind_cast), and prints the average time per loop.
+* usage: KindFlagsBenchmark [lights_count] [loops_count]
+* note: run it in release mode, debug mode numbers are meaningless.
+* PLEASE NOTE: this project relays on the folder examples/ness-engine to be one step above the project dir. so make sure you include it as well.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+#define _WINDOWS
+#include <NessEngine.h>
+#include <tchar.h>
+#include <iostream>
+
+// convert performance counter ticks to milliseconds per loop
+double ticks_to_ms(Uint64 ticks, int loops)
+{
+	return ((double)ticks * 1000.0 / (double)SDL_GetPerformanceFrequency()) / (double)loops;
+}
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	// get arguments
+	int lights_count = (argc > 1) ? _ttoi(argv[1]) : 10000;
+	int loops_count = (argc > 2) ? _ttoi(argv[2]) : 1000;
+
+	// init and create a renderer
+	Ness::init();
+	Ness::Renderer renderer("Kind Flags Benchmark", Ness::Sizei(512, 512));
+
+	// create a light node with lots of lights
+	Ness::ScenePtr scene = renderer.create_scene();
+	Ness::LightNodePtr lightNode = scene->create_light_node();
+	for (int i = 0; i < lights_count; i++)
+	{
+		Ness::LightPtr light = lightNode->create_light("../ness-engine/resources/gfx/light_round.jpg");
+		light->set_position(Ness::Point((float)(rand() % 512), (float)(rand() % 512)));
+	}
+
+	// get the lights as generic renderables, like the light node stores them
+	Ness::RenderablesList sons;
+	for (unsigned int i = 0; i < lightNode->get_sons_count(); i++)
+	{
+		sons.push_back(lightNode->get_son(i));
+	}
+
+	// loop with dynamic casts
+	std::cout << "checking " << lights_count << " lights, " << loops_count << " loops per mode..." << std::endl;
+	unsigned int need_redraw = 0;
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (int loop = 0; loop < loops_count; loop++)
+	{
+		for (unsigned int i = 0; i < sons.size(); i++)
+		{
+			Ness::LightPtr light = ness_ptr_cast<Ness::Light>(sons[i]);
+			if (light && light->need_redraw())
+				need_redraw++;
+		}
+	}
+	double dynamic_cast_time = ticks_to_ms(SDL_GetPerformanceCounter() - start, loops_count);
+
+	// loop with kind flags
+	start = SDL_GetPerformanceCounter();
+	for (int loop = 0; loop < loops_count; loop++)
+	{
+		for (unsigned int i = 0; i < sons.size(); i++)
+		{
+			const Ness::RenderablePtr& curr = sons[i];
+			if (curr->is_kind(Ness::RENDERABLE_KIND_LIGHT) && Ness::ness_kind_cast<Ness::Light>(curr)->need_redraw())
+				need_redraw++;
+		}
+	}
+	double kind_flags_time = ticks_to_ms(SDL_GetPerformanceCounter() - start, loops_count);
+
+	// show results (need_redraw is printed so the compiler won't remove the loops)
+	std::cout << "ness_ptr_cast: " << dynamic_cast_time << " ms per loop" << std::endl;
+	std::cout << "kind flags:    " << kind_flags_time << " ms per loop" << std::endl;
+	std::cout << "(lights that need redraw: " << need_redraw << ")" << std::endl;
+	return 0;
+}
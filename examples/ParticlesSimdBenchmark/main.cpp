@@ -0,0 +1,131 @@
+/*
+* NessEngine particles pool benchmark. updates a pool of 100k particles with the scalar, SSE2 and AVX kernels
+* (see ParticlesKernels::set_simd_level()) and prints the average update time for every level.
+* for comparison, it also animates the same amount of particle entities (every particle with its own animators) in a particles node.
+* usage: ParticlesSimdBenchmark [particles_count] [updates_count]
+* note: levels that your cpu doesn't support fall back to the best supported level, the actual level is printed next to the result.
+*		run it in release mode, debug mode numbers are meaningless.
+* PLEASE NOTE: this project relays on the folder examples/ness-engine to be one step above the project dir. so make sure you include it as well.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+#define _WINDOWS
+#include <NessEngine.h>
+#include <tchar.h>
+#include <iostream>
+
+// return the name of a simd level
+const char* simd_level_name(Ness::ParticlesKernels::ESimdLevel level)
+{
+	switch (level)
+	{
+	case Ness::ParticlesKernels::SIMD_SSE2:
+		return "SSE2";
+	case Ness::ParticlesKernels::SIMD_AVX:
+		return "AVX";
+	default:
+		return "scalar";
+	}
+}
+
+// fill the pool with random particles that live long enough to survive the whole benchmark
+void fill_pool(Ness::ParticlesPool& pool)
+{
+	Ness::RandomGenerator random(1234);
+	pool.clear();
+	Ness::SParticleData data;
+	while (pool.get_count() < pool.get_capacity())
+	{
+		data.position = Ness::Point(random.rand_float(0.0f, 512.0f), random.rand_float(0.0f, 512.0f));
+		data.velocity = Ness::Point(random.rand_float(-50.0f, 50.0f), random.rand_float(-50.0f, 50.0f));
+		data.color_change = Ness::Color(0.0f, 0.0f, 0.0f, -0.001f);
+		data.scale_change = random.rand_float(-0.01f, 0.01f);
+		data.rotation_speed = random.rand_float(-90.0f, 90.0f);
+		data.time_to_live = 1000000.0f;
+		pool.emit(data, Ness::Point::ZERO, Ness::Size::ONE);
+	}
+}
+
+// update the pool a number of times with the given simd level and return the average milliseconds per update
+double run_benchmark(Ness::ParticlesPool& pool, Ness::ParticlesKernels::ESimdLevel level, int updates)
+{
+	Ness::ParticlesKernels::set_simd_level(level);
+	fill_pool(pool);
+
+	// warm up
+	pool.update(0.016f);
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (int i = 0; i < updates; i++)
+	{
+		pool.update(0.016f);
+	}
+	Uint64 total = SDL_GetPerformanceCounter() - start;
+	return ((double)total * 1000.0 / (double)SDL_GetPerformanceFrequency()) / (double)updates;
+}
+
+// animate a particles node with particle entities that move, rotate and scale (like the pooled particles) a number of times
+// and return the average milliseconds per update
+double run_entities_benchmark(Ness::Renderer& renderer, int particles_count, int updates)
+{
+	// create the particles node and fill it with particles that animate forever
+	Ness::ScenePtr scene = renderer.create_scene();
+	Ness::ParticlesNodePtr node = scene->create_particles_node(Ness::Size(512, 512));
+	node->pause_emitting(true);
+	Ness::RandomGenerator random(1234);
+	for (int i = 0; i < particles_count; i++)
+	{
+		Ness::ParticlePtr particle = ness_make_ptr<Ness::Particle>(&renderer);
+		particle->set_position(Ness::Point(random.rand_float(0.0f, 512.0f), random.rand_float(0.0f, 512.0f)));
+		particle->register_animator(ness_make_ptr<Ness::Animators::AnimatorMover>(particle, 
+			Ness::Point(random.rand_float(-50.0f, 50.0f), random.rand_float(-50.0f, 50.0f)), 0.0f));
+		particle->register_animator(ness_make_ptr<Ness::Animators::AnimatorRotator>(particle, random.rand_float(-90.0f, 90.0f), 0.0f));
+		float scale_change = random.rand_float(-0.01f, 0.01f);
+		particle->register_animator(ness_make_ptr<Ness::Animators::AnimatorScaler>(particle, Ness::Point(scale_change, scale_change), 0.0f));
+		node->add(particle);
+	}
+
+	// run a single frame so the renderer will have a time factor for the animators, then only animate the node (no rendering)
+	renderer.start_frame();
+	SDL_Delay(16);
+	renderer.end_frame();
+
+	// warm up
+	node->do_animation(&renderer);
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (int i = 0; i < updates; i++)
+	{
+		node->do_animation(&renderer);
+	}
+	Uint64 total = SDL_GetPerformanceCounter() - start;
+	return ((double)total * 1000.0 / (double)SDL_GetPerformanceFrequency()) / (double)updates;
+}
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	// get arguments
+	int particles_count = (argc > 1) ? _ttoi(argv[1]) : 100000;
+	int updates_count = (argc > 2) ? _ttoi(argv[2]) : 500;
+
+	// init the engine (the renderer is only needed for the particle entities)
+	Ness::init();
+	Ness::Renderer renderer("Particles SIMD Benchmark", Ness::Sizei(512, 512));
+	Ness::ParticlesPool pool(Ness::ManagedResources::ManagedTexturePtr(), (unsigned int)particles_count);
+
+	// run all levels
+	std::cout << "updating " << particles_count << " particles, " << updates_count << " updates per level..." << std::endl;
+	std::cout << "best supported level: " << simd_level_name(Ness::ParticlesKernels::get_supported_simd_level()) << std::endl;
+	Ness::ParticlesKernels::ESimdLevel levels[] = {Ness::ParticlesKernels::SIMD_NONE, Ness::ParticlesKernels::SIMD_SSE2, Ness::ParticlesKernels::SIMD_AVX};
+	for (int i = 0; i < 3; i++)
+	{
+		double time = run_benchmark(pool, levels[i], updates_count);
+		std::cout << simd_level_name(levels[i]) << " (using " << simd_level_name(Ness::ParticlesKernels::get_simd_level()) << "): "
+			<< time << " ms per update" << std::endl;
+	}
+
+	// run particle entities
+	double entities_time = run_entities_benchmark(renderer, particles_count, updates_count);
+	std::cout << "particle entities (" << particles_count << " entities): " << entities_time << " ms per update" << std::endl;
+	return 0;
+}
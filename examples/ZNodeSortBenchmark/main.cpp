@@ -0,0 +1,76 @@
+/*
+* NessEngine z-node sort benchmark. renders a z-node with many sprites that change their z-index every frame, once with the
+* default comparison sort and once with radix sort (see ZNode::set_radix_sort()), and prints the average time per frame.
+* usage: ZNodeSortBenchmark [sprites_count] [frames_count]
+* note: the times include rendering the sprites (which is the same for both modes), so the difference is the sort itself.
+*		run it in release mode, debug mode numbers are meaningless.
+* PLEASE NOTE: this project relays on the folder examples/ness-engine to be one step above the project dir. so make sure you include it as well.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+#define _WINDOWS
+#include <NessEngine.h>
+#include <tchar.h>
+#include <iostream>
+
+// render the znode for a number of frames and return the average milliseconds per frame.
+// before every frame all the sprites get a new random z-index (this part is not measured).
+double run_benchmark(Ness::Renderer& renderer, Ness::ScenePtr& scene, Ness::Containers::Vector<Ness::SpritePtr>& sprites, int frames)
+{
+	Uint64 total = 0;
+	for (int frame = 0; frame < frames; frame++)
+	{
+		// shuffle z-order
+		for (unsigned int i = 0; i < sprites.size(); i++)
+		{
+			sprites[i]->set_zindex((float)(rand() % 10000));
+		}
+
+		// render and measure
+		renderer.start_frame();
+		Uint64 start = SDL_GetPerformanceCounter();
+		scene->render();
+		total += SDL_GetPerformanceCounter() - start;
+		renderer.end_frame();
+	}
+	return ((double)total * 1000.0 / (double)SDL_GetPerformanceFrequency()) / (double)frames;
+}
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	// get arguments
+	int sprites_count = (argc > 1) ? _ttoi(argv[1]) : 50000;
+	int frames_count = (argc > 2) ? _ttoi(argv[2]) : 100;
+
+	// init and create a renderer
+	Ness::init();
+	Ness::Renderer renderer("ZNode Sort Benchmark", Ness::Sizei(512, 512));
+
+	// create a scene with a znode that reorder every frame
+	Ness::ScenePtr scene = renderer.create_scene();
+	Ness::ZNodePtr znode = scene->create_znode();
+	znode->set_reorder_interval(0.0f);
+
+	// create the sprites. they are small so rendering won't hide the sorting time
+	Ness::Containers::Vector<Ness::SpritePtr> sprites;
+	for (int i = 0; i < sprites_count; i++)
+	{
+		Ness::SpritePtr sprite = znode->create_sprite("../ness-engine/resources/gfx/Ness-Engine-Small.png");
+		sprite->set_size(Ness::Size(2, 2));
+		sprite->set_position(Ness::Point((float)(rand() % 510), (float)(rand() % 510)));
+		sprites.push_back(sprite);
+	}
+
+	// warm up, and then run both modes
+	std::cout << "sorting " << sprites_count << " sprites, " << frames_count << " frames per mode..." << std::endl;
+	run_benchmark(renderer, scene, sprites, 10);
+	znode->set_radix_sort(false);
+	double comparison_time = run_benchmark(renderer, scene, sprites, frames_count);
+	znode->set_radix_sort(true);
+	double radix_time = run_benchmark(renderer, scene, sprites, frames_count);
+
+	// show results
+	std::cout << "comparison sort: " << comparison_time << " ms per frame" << std::endl;
+	std::cout << "radix sort:      " << radix_time << " ms per frame" << std::endl;
+	return 0;
+}
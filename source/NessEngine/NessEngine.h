@@ -52,6 +52,7 @@
 #include "utils/events/application_events.h"
 #include "utils/events/events_poller.h"
 #include "utils/rendering/logo_show.h"
+#include "utils/threads/workers_pool.h"
 
 // include all renderables
 #include "renderable/renderable_api.h"
@@ -27,4 +27,5 @@
 #include "animator_scaler.h"
 #include "animator_rotator.h"
 #include "animator_mover.h"
-#include "animator_sprite_character.h"
\ No newline at end of file
+#include "animator_sprite_character.h"
+#include "tweens.h"
\ No newline at end of file
@@ -56,9 +56,10 @@ namespace Ness
 
 		protected:
 			AnimatorsQueue* m_animator_queue_parent;
+			unsigned int m_animator_queue_slot;		// our index inside the parent animators queue
 
 		public:
-			NESSENGINE_API AnimatorAPI() : m_animator_paused(false), m_animator_should_be_removed(false), m_animator_queue_parent(nullptr) {}
+			NESSENGINE_API AnimatorAPI() : m_animator_paused(false), m_animator_should_be_removed(false), m_animator_queue_parent(nullptr), m_animator_queue_slot(0) {}
 			NESSENGINE_API ~AnimatorAPI();
 
 			// pause/unpause animation without removing from animators queue
@@ -69,12 +70,21 @@ namespace Ness
 			NESSENGINE_API void __change_animator_queue(AnimatorsQueue* NewQueue);
 			NESSENGINE_API inline AnimatorsQueue* __get_animator_queue() {return m_animator_queue_parent;}
 
+			// set / get the index of this animator inside its animators queue (used internally by the queue)
+			NESSENGINE_API inline void __set_animator_queue_slot(unsigned int slot) {m_animator_queue_slot = slot;}
+			NESSENGINE_API inline unsigned int __get_animator_queue_slot() const {return m_animator_queue_slot;}
+
 			// remove this animator from the renderer animators queue (will no longer run)
 			NESSENGINE_API void remove_from_animation_queue() {m_animator_should_be_removed = true;}
 			NESSENGINE_API inline bool __should_be_removed() const {return m_animator_should_be_removed;}
 
 			// animate this object. when finish, if you want to remove animator call 'remove_from_animation_queue()'
 			NESSENGINE_API virtual void do_animation(Renderer* renderer) = 0;
+
+			// return true if this animator can run on a worker thread, in parallel to other thread-safe animators.
+			// an animator is thread-safe only if do_animation() touches nothing but its own members and its own target transformations
+			// (no adding/removing entities, no registering animators, and no other animator works on the same target or its sons).
+			NESSENGINE_API virtual bool is_thread_safe() const {return false;}
 		};
 
 		/**
@@ -91,6 +91,9 @@ namespace Ness
 				// set color
 				m_target->set_color((m_color_a * (1.0f - m_complete)) + (m_color_b * m_complete));
 			}
+
+			// thread-safe only if we don't need to remove the target when done
+			NESSENGINE_API virtual bool is_thread_safe() const {return !m_remove_when_done;}
 		};
 
 		// color shifter animator pointer
@@ -71,6 +71,9 @@ namespace Ness
 					this->remove_from_animation_queue();
 				}
 			}
+
+			// only changes the target opacity
+			NESSENGINE_API virtual bool is_thread_safe() const {return true;}
 		};
 
 		// fade-in animator pointer
@@ -116,6 +119,9 @@ namespace Ness
 					}
 				}
 			}
+
+			// thread-safe only if we don't need to remove the target when done
+			NESSENGINE_API virtual bool is_thread_safe() const {return !m_remove_when_done;}
 		};
 
 		// fade-out animator pointer
@@ -76,6 +76,9 @@ namespace Ness
 					}
 				}
 			}
+
+			// only changes the target transformations
+			NESSENGINE_API virtual bool is_thread_safe() const {return true;}
 		};
 
 		// fade-in animator pointer
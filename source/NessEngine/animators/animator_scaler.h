@@ -72,6 +72,9 @@ namespace Ness
 					this->remove_from_animation_queue();
 				}
 			}
+
+			// only changes the target transformations
+			NESSENGINE_API virtual bool is_thread_safe() const {return true;}
 		};
 
 		// fade-in animator pointer
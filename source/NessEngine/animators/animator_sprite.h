@@ -210,6 +210,9 @@ namespace Ness
 					}
 				}
 			}
+
+			// thread-safe only if we don't need to remove the sprite when done
+			NESSENGINE_API virtual bool is_thread_safe() const {return m_end_action != SPRITE_ANIM_END_REMOVE_SPRITE;}
 		};
 
 		// define the animator pointer
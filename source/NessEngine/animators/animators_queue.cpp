@@ -29,6 +29,7 @@
 #pragma once
 #include "../exceptions/exceptions.h"
 #include "animators_queue.h"
+#include "../renderer/renderer.h"
 #include <algorithm>
 
 namespace Ness
@@ -40,72 +41,203 @@ namespace Ness
 		{
 			for (unsigned int i = 0; i < m_animators.size(); ++i)
 			{
-				m_animators[i]->__change_animator_queue(nullptr);
+				if (m_animators[i].animator)
+					m_animators[i].animator->__change_animator_queue(nullptr);
 			}
 		}
 
-		// empty deleter that does nothing. 
-		// this is a way to create animator shared pointer that don't delete the object itself, so we'll be able to register anumator with a regular pointer
-		static void EmptyAnimatorDeleter(Animators::AnimatorAPI* anim)
-		{
-		}
-
 		// register an animator by regular pointer
 		void AnimatorsQueue::__register_animator_unsafe(Animators::AnimatorAPI* animator)
 		{
-			register_animator(Animators::AnimatorPtr(animator, EmptyAnimatorDeleter));
+			add_slot(animator, Animators::AnimatorPtr());
 		}
 
 		// remove an animator by regular pointer
 		void AnimatorsQueue::__remove_animator_unsafe(Animators::AnimatorAPI* animator)
 		{
-			remove_animator(Animators::AnimatorPtr(animator, EmptyAnimatorDeleter));
+			remove_slot(animator);
 		}
 
 		// register an animator
 		void AnimatorsQueue::register_animator(const Animators::AnimatorPtr& animator)
 		{
-			m_animators.push_back(animator);
-			animator->__change_animator_queue(this);
+			add_slot(animator.get(), animator);
 		}
 
 		// remove an animator
 		void AnimatorsQueue::remove_animator(const Animators::AnimatorPtr& animator)
+		{
+			remove_slot(animator.get());
+		}
+
+		void AnimatorsQueue::add_slot(Animators::AnimatorAPI* animator, const Animators::AnimatorPtr& owner)
+		{
+			// already in this queue?
+			if (animator->__get_animator_queue() == this)
+				return;
+
+			// will throw if in another queue
+			animator->__change_animator_queue(this);
+			animator->__set_animator_queue_slot((unsigned int)m_animators.size());
+			m_animators.push_back(SAnimatorSlot(animator, owner));
+		}
+
+		void AnimatorsQueue::remove_slot(Animators::AnimatorAPI* animator)
 		{
 			if (animator->__get_animator_queue() != this)
 			{
 				throw IllegalAction("Cannot remove animator, animator is not even in this queue!");
 			}
-			m_animators.erase(std::remove(m_animators.begin(), m_animators.end(), animator), m_animators.end());
+
+			// just empty the slot. the owner is kept until the slots are cleaned, so animators can safely remove themselves
+			m_animators[animator->__get_animator_queue_slot()].animator = nullptr;
 			animator->__change_animator_queue(nullptr);
+			m_removed_count++;
 		}
 
-		// remove all dead animators from list
-		bool remove_dead_animators(const Animators::AnimatorPtr& animator)
+		void AnimatorsQueue::clean_slots()
 		{
-			return animator->__should_be_removed();
+			// compact the slots and update the animators with their new slots
+			unsigned int count = 0;
+			for (unsigned int i = 0; i < m_animators.size(); ++i)
+			{
+				SAnimatorSlot& curr = m_animators[i];
+
+				// remove dead animators
+				if (curr.animator && curr.animator->__should_be_removed())
+				{
+					curr.animator->__change_animator_queue(nullptr);
+					curr.animator = nullptr;
+				}
+
+				// removed slot - keep the owner to release later
+				if (curr.animator == nullptr)
+				{
+					if (curr.owner)
+						m_released.push_back(curr.owner);
+					continue;
+				}
+
+				// move to its new slot
+				if (count != i)
+				{
+					m_animators[count] = curr;
+					curr.animator->__set_animator_queue_slot(count);
+				}
+				count++;
+			}
+			m_animators.erase(m_animators.begin() + count, m_animators.end());
+			m_removed_count = 0;
+
+			// release the removed animators only now, since destroying them may remove other animators from this queue
+			m_released.clear();
 		}
 
+		/**
+		* a task to run a chunk of thread-safe animators on a worker thread
+		*/
+		class AnimatorsChunkTask : public Utils::WorkerTask
+		{
+		private:
+			Animators::AnimatorAPI**	m_animators;
+			unsigned int				m_count;
+			Renderer*					m_renderer;
+
+		public:
+			AnimatorsChunkTask(Animators::AnimatorAPI** animators, unsigned int count, Renderer* renderer)
+				: m_animators(animators), m_count(count), m_renderer(renderer)
+			{ }
+
+			virtual void execute()
+			{
+				for (unsigned int i = 0; i < m_count; ++i)
+				{
+					m_animators[i]->do_animation(m_renderer);
+				}
+			}
+		};
+
 		// run all animators
 		void AnimatorsQueue::do_animations()
 		{
+			// parallel mode
+			if (m_parallel_animations && m_animators.size() >= m_parallel_min_count)
+			{
+				do_animations_parallel();
+				return;
+			}
+
 			// loop and animate all animators
 			bool gotAnimatorsToRemove = false;
 			for (unsigned int i = 0; i < m_animators.size(); ++i)
 			{
-				Animators::AnimatorPtr& curr = m_animators[i];
-				if (curr->is_animation_paused())
+				Animators::AnimatorAPI* curr = m_animators[i].animator;
+				if (curr == nullptr || curr->is_animation_paused())
 					continue;
 
 				curr->do_animation(m_animator_queue_renderer);
-				gotAnimatorsToRemove |= curr->__should_be_removed();
+				curr = m_animators[i].animator;
+				gotAnimatorsToRemove |= (curr && curr->__should_be_removed());
+			}
+
+			// remove all 'dead' and removed animators
+			if (gotAnimatorsToRemove || m_removed_count > 0)
+			{
+				clean_slots();
+			}
+		}
+
+		// run all animators, thread-safe animators in parallel
+		void AnimatorsQueue::do_animations_parallel()
+		{
+			// split to thread-safe and serial animators
+			m_parallel_batch.clear();
+			m_serial_batch.clear();
+			for (unsigned int i = 0; i < m_animators.size(); ++i)
+			{
+				Animators::AnimatorAPI* curr = m_animators[i].animator;
+				if (curr == nullptr || curr->is_animation_paused())
+					continue;
+
+				if (curr->is_thread_safe())
+					m_parallel_batch.push_back(curr);
+				else
+					m_serial_batch.push_back(i);
 			}
 
-			// remove all 'dead' animators
-			if (gotAnimatorsToRemove)
+			// run the thread-safe animators.
+			// we split them into more chunks than workers, so workers that finish early will take more chunks and balance the load.
+			unsigned int count = (unsigned int)m_parallel_batch.size();
+			if (count >= m_parallel_min_count)
 			{
-				m_animators.erase(std::remove_if(m_animators.begin(), m_animators.end(), remove_dead_animators), m_animators.end());
+				const Utils::WorkersPoolPtr& pool = m_animator_queue_renderer->get_workers_pool();
+				unsigned int chunks = (pool->get_threads_count() + 1) * 4;
+				unsigned int chunk_size = std::max((count + chunks - 1) / chunks, 64u);
+
+				// push all chunks but the first to the workers, and run the first one on this thread
+				for (unsigned int start = chunk_size; start < count; start += chunk_size)
+				{
+					pool->push_task(ness_make_ptr<AnimatorsChunkTask>(&m_parallel_batch[start], std::min(chunk_size, count - start), m_animator_queue_renderer));
+				}
+				AnimatorsChunkTask(&m_parallel_batch[0], std::min(chunk_size, count), m_animator_queue_renderer).execute();
+				pool->wait_all();
 			}
+			else if (count > 0)
+			{
+				AnimatorsChunkTask(&m_parallel_batch[0], count, m_animator_queue_renderer).execute();
+			}
+
+			// run the non thread-safe animators
+			for (unsigned int i = 0; i < m_serial_batch.size(); ++i)
+			{
+				// skip animators that were removed from the queue by previous animators
+				Animators::AnimatorAPI* curr = m_animators[m_serial_batch[i]].animator;
+				if (curr)
+					curr->do_animation(m_animator_queue_renderer);
+			}
+
+			// remove all 'dead' and removed animators
+			clean_slots();
 		}
 	};
 };
\ No newline at end of file
@@ -38,26 +38,42 @@ namespace Ness
 
 	namespace Animators
 	{
+		// a single animator inside an animators queue
+		struct SAnimatorSlot
+		{
+			AnimatorAPI*	animator;	// the animator in this slot (or nullptr if removed and waiting to be cleaned)
+			AnimatorPtr		owner;		// keep the animator alive (empty for animators registered with a regular pointer)
+
+			SAnimatorSlot(AnimatorAPI* Animator, const AnimatorPtr& Owner) : animator(Animator), owner(Owner) {}
+		};
 
 		/**
 		* an AnimatorsQueue is an object capable of holding, activating and managing animators.
-		* every object that need to hold and run animators must inherit from this class
+		* every object that need to hold and run animators must inherit from this class.
+		* every animator knows its slot in the queue, so registering and removing animators are O(1). removed slots are cleaned
+		* in a single pass at the end of do_animations().
 		*/
 		class AnimatorsQueue
 		{
 		private:
-			Containers::Vector<Animators::AnimatorPtr> m_animators;
+			Containers::Vector<SAnimatorSlot> m_animators;
 			Renderer* m_animator_queue_renderer;
+			unsigned int m_removed_count;							// how many slots were removed and waiting to be cleaned
+			Containers::Vector<Animators::AnimatorPtr> m_released;	// owners of removed animators, released after cleaning slots
+			bool m_parallel_animations;								// if true, thread-safe animators run in parallel on the renderer workers pool
+			unsigned int m_parallel_min_count;						// minimum thread-safe animators count to actually run in parallel
+			Containers::Vector<Animators::AnimatorAPI*> m_parallel_batch;	// thread-safe animators to run in parallel this frame
+			Containers::Vector<unsigned int> m_serial_batch;				// slots of non thread-safe animators to run after the parallel batch
 
 		public:
-			NESSENGINE_API AnimatorsQueue(Renderer* renderer) : m_animator_queue_renderer(renderer) {}
+			NESSENGINE_API AnimatorsQueue(Renderer* renderer) : m_animator_queue_renderer(renderer), m_removed_count(0), m_parallel_animations(false), m_parallel_min_count(512) {}
 			NESSENGINE_API ~AnimatorsQueue();
 
 			// register / remove an animator from this animators queue
 			NESSENGINE_API void register_animator(const Animators::AnimatorPtr& animator);
 			NESSENGINE_API void remove_animator(const Animators::AnimatorPtr& animator);
 
-			// register / remove an animator with regular pointer
+			// register / remove an animator with regular pointer (does not allocate anything)
 			// WARNING: it's your responsibility to remove animator once deleted or else you will cause seg-fault!
 			NESSENGINE_API void __register_animator_unsafe(Animators::AnimatorAPI* animator);
 			NESSENGINE_API void __remove_animator_unsafe(Animators::AnimatorAPI* animator);
@@ -66,6 +82,25 @@ namespace Ness
 			// run all the animators
 			NESSENGINE_API void do_animations();
 
+			// set parallel animations mode.
+			// in this mode, animators that are thread-safe (see AnimatorAPI::is_thread_safe()) are split into chunks and executed on the
+			// renderer workers pool, while the main thread runs a chunk as well. after all of them are done, the non thread-safe
+			// animators run serially on the main thread and then the dead animators are removed.
+			// MinCount is the minimum thread-safe animators needed to go parallel (below that, the threads overhead is not worth it).
+			NESSENGINE_API inline void set_parallel_animations(bool enable, unsigned int MinCount = 512) {m_parallel_animations = enable; m_parallel_min_count = MinCount;}
+			NESSENGINE_API inline bool is_parallel_animations() const {return m_parallel_animations;}
+
+		private:
+			// add / remove an animator slot
+			void add_slot(Animators::AnimatorAPI* animator, const Animators::AnimatorPtr& owner);
+			void remove_slot(Animators::AnimatorAPI* animator);
+
+			// clean removed slots and dead animators
+			void clean_slots();
+
+			// run all the animators with the thread-safe animators in parallel
+			void do_animations_parallel();
+
 		};
 	};
 };
\ No newline at end of file
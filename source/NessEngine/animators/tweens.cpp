@@ -0,0 +1,390 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+#include "tweens.h"
+#include "../renderable/renderable_api.h"
+#include "../renderer/renderer.h"
+#include "../exceptions/exceptions.h"
+
+namespace Ness
+{
+	namespace Animators
+	{
+		TweensManager::TweensManager() : m_next_id(1)
+		{
+			m_tweens[TWEEN_POSITION].channels = 2;
+			m_tweens[TWEEN_SCALE].channels = 2;
+			m_tweens[TWEEN_ROTATION].channels = 1;
+			m_tweens[TWEEN_OPACITY].channels = 1;
+			m_tweens[TWEEN_COLOR].channels = 4;
+		}
+
+		TweenId TweensManager::tween_position(const RenderablePtr& target, const Point& to, float duration, ETweenEasing easing, float delay, const TweenCallbackPtr& callback)
+		{
+			float values[2] = {to.x, to.y};
+			return add_tween(TWEEN_POSITION, target, values, duration, easing, delay, callback);
+		}
+
+		TweenId TweensManager::tween_scale(const RenderablePtr& target, const Size& to, float duration, ETweenEasing easing, float delay, const TweenCallbackPtr& callback)
+		{
+			float values[2] = {to.x, to.y};
+			return add_tween(TWEEN_SCALE, target, values, duration, easing, delay, callback);
+		}
+
+		TweenId TweensManager::tween_rotation(const RenderablePtr& target, float to, float duration, ETweenEasing easing, float delay, const TweenCallbackPtr& callback)
+		{
+			return add_tween(TWEEN_ROTATION, target, &to, duration, easing, delay, callback);
+		}
+
+		TweenId TweensManager::tween_opacity(const RenderablePtr& target, float to, float duration, ETweenEasing easing, float delay, const TweenCallbackPtr& callback)
+		{
+			return add_tween(TWEEN_OPACITY, target, &to, duration, easing, delay, callback);
+		}
+
+		TweenId TweensManager::tween_color(const RenderablePtr& target, const Color& to, float duration, ETweenEasing easing, float delay, const TweenCallbackPtr& callback)
+		{
+			float values[4] = {to.r, to.g, to.b, to.a};
+			return add_tween(TWEEN_COLOR, target, values, duration, easing, delay, callback);
+		}
+
+		TweenId TweensManager::add_tween(ETweenProperty prop, const RenderablePtr& target, const float* to, float duration, ETweenEasing easing, float delay, const TweenCallbackPtr& callback)
+		{
+			if (!target)
+			{
+				throw IllegalAction("Cannot tween an empty target!");
+			}
+
+			STweensArray& tweens = m_tweens[prop];
+			TweenId id = m_next_id++;
+			if (m_next_id == 0)
+				m_next_id = 1;
+
+			tweens.targets.push_back(target);
+			tweens.ids.push_back(id);
+			for (unsigned int c = 0; c < tweens.channels; ++c)
+			{
+				tweens.from.push_back(to[c]);
+				tweens.to.push_back(to[c]);
+				tweens.values.push_back(to[c]);
+			}
+			tweens.elapsed.push_back(0.0f);
+			tweens.delay.push_back(delay);
+			tweens.duration.push_back(duration > 0.0f ? duration : 0.0f);
+			tweens.progress.push_back(-1.0f);
+			tweens.easing.push_back((Uint8)easing);
+			tweens.started.push_back(0);
+			tweens.callbacks.push_back(callback);
+			return id;
+		}
+
+		void TweensManager::remove_tween(STweensArray& tweens, unsigned int index)
+		{
+			unsigned int last = (unsigned int)tweens.ids.size() - 1;
+			if (index != last)
+			{
+				tweens.targets[index] = tweens.targets[last];
+				tweens.ids[index] = tweens.ids[last];
+				for (unsigned int c = 0; c < tweens.channels; ++c)
+				{
+					tweens.from[index * tweens.channels + c] = tweens.from[last * tweens.channels + c];
+					tweens.to[index * tweens.channels + c] = tweens.to[last * tweens.channels + c];
+					tweens.values[index * tweens.channels + c] = tweens.values[last * tweens.channels + c];
+				}
+				tweens.elapsed[index] = tweens.elapsed[last];
+				tweens.delay[index] = tweens.delay[last];
+				tweens.duration[index] = tweens.duration[last];
+				tweens.progress[index] = tweens.progress[last];
+				tweens.easing[index] = tweens.easing[last];
+				tweens.started[index] = tweens.started[last];
+				tweens.callbacks[index] = tweens.callbacks[last];
+			}
+
+			tweens.targets.pop_back();
+			tweens.ids.pop_back();
+			tweens.from.resize(last * tweens.channels);
+			tweens.to.resize(last * tweens.channels);
+			tweens.values.resize(last * tweens.channels);
+			tweens.elapsed.pop_back();
+			tweens.delay.pop_back();
+			tweens.duration.pop_back();
+			tweens.progress.pop_back();
+			tweens.easing.pop_back();
+			tweens.started.pop_back();
+			tweens.callbacks.pop_back();
+		}
+
+		bool TweensManager::cancel(TweenId id)
+		{
+			for (unsigned int prop = 0; prop < TWEEN_PROPERTIES_COUNT; ++prop)
+			{
+				STweensArray& tweens = m_tweens[prop];
+				for (unsigned int i = 0; i < tweens.ids.size(); ++i)
+				{
+					if (tweens.ids[i] == id)
+					{
+						remove_tween(tweens, i);
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		void TweensManager::cancel_all(const RenderablePtr& target)
+		{
+			for (unsigned int prop = 0; prop < TWEEN_PROPERTIES_COUNT; ++prop)
+			{
+				STweensArray& tweens = m_tweens[prop];
+				for (unsigned int i = (unsigned int)tweens.ids.size(); i > 0; --i)
+				{
+					if (tweens.targets[i - 1] == target)
+					{
+						remove_tween(tweens, i - 1);
+					}
+				}
+			}
+		}
+
+		void TweensManager::clear()
+		{
+			for (unsigned int prop = 0; prop < TWEEN_PROPERTIES_COUNT; ++prop)
+			{
+				unsigned int channels = m_tweens[prop].channels;
+				m_tweens[prop] = STweensArray();
+				m_tweens[prop].channels = channels;
+			}
+		}
+
+		unsigned int TweensManager::get_active_count() const
+		{
+			unsigned int ret = 0;
+			for (unsigned int prop = 0; prop < TWEEN_PROPERTIES_COUNT; ++prop)
+			{
+				ret += (unsigned int)m_tweens[prop].ids.size();
+			}
+			return ret;
+		}
+
+		float TweensManager::apply_easing(ETweenEasing easing, float t)
+		{
+			switch (easing)
+			{
+			case EASE_IN_QUAD:
+				return t * t;
+			case EASE_OUT_QUAD:
+				return t * (2.0f - t);
+			case EASE_IN_OUT_QUAD:
+				return (t < 0.5f) ? (2.0f * t * t) : (-1.0f + (4.0f - 2.0f * t) * t);
+			case EASE_IN_CUBIC:
+				return t * t * t;
+			case EASE_OUT_CUBIC:
+				t -= 1.0f;
+				return t * t * t + 1.0f;
+			case EASE_IN_OUT_CUBIC:
+				if (t < 0.5f)
+					return 4.0f * t * t * t;
+				t = 2.0f * t - 2.0f;
+				return 0.5f * t * t * t + 1.0f;
+			case EASE_IN_SINE:
+				return 1.0f - cos(t * PI * 0.5f);
+			case EASE_OUT_SINE:
+				return sin(t * PI * 0.5f);
+			case EASE_IN_OUT_SINE:
+				return 0.5f * (1.0f - cos(t * PI));
+			default:
+				return t;
+			}
+		}
+
+		SRenderTransformations& TweensManager::get_touched_transformations(RenderableAPI* target)
+		{
+			auto existing = m_touched_index.find(target);
+			if (existing != m_touched_index.end())
+			{
+				return m_touched_trans[existing->second];
+			}
+
+			m_touched_index[target] = (unsigned int)m_touched.size();
+			m_touched.push_back(target);
+			m_touched_trans.push_back(target->get_transformation());
+			return m_touched_trans.back();
+		}
+
+		void TweensManager::read_property(ETweenProperty prop, const SRenderTransformations& trans, float* out)
+		{
+			switch (prop)
+			{
+			case TWEEN_POSITION:
+				out[0] = trans.position.x; out[1] = trans.position.y;
+				break;
+			case TWEEN_SCALE:
+				out[0] = trans.scale.x; out[1] = trans.scale.y;
+				break;
+			case TWEEN_ROTATION:
+				out[0] = trans.rotation;
+				break;
+			case TWEEN_OPACITY:
+				out[0] = trans.color.a;
+				break;
+			case TWEEN_COLOR:
+				out[0] = trans.color.r; out[1] = trans.color.g; out[2] = trans.color.b; out[3] = trans.color.a;
+				break;
+			default:
+				break;
+			}
+		}
+
+		void TweensManager::write_property(ETweenProperty prop, SRenderTransformations& trans, const float* in)
+		{
+			switch (prop)
+			{
+			case TWEEN_POSITION:
+				trans.position.x = in[0]; trans.position.y = in[1];
+				break;
+			case TWEEN_SCALE:
+				trans.scale.x = in[0]; trans.scale.y = in[1];
+				break;
+			case TWEEN_ROTATION:
+				trans.rotation = in[0];
+				break;
+			case TWEEN_OPACITY:
+				trans.color.a = in[0];
+				break;
+			case TWEEN_COLOR:
+				trans.color.r = in[0]; trans.color.g = in[1]; trans.color.b = in[2]; trans.color.a = in[3];
+				break;
+			default:
+				break;
+			}
+		}
+
+		void TweensManager::update_property(ETweenProperty prop, float time_factor)
+		{
+			STweensArray& tweens = m_tweens[prop];
+			unsigned int count = (unsigned int)tweens.ids.size();
+			if (count == 0)
+				return;
+			unsigned int channels = tweens.channels;
+
+			// advance time and calculate eased progress
+			float* elapsed = &tweens.elapsed[0];
+			const float* delay = &tweens.delay[0];
+			const float* duration = &tweens.duration[0];
+			float* progress = &tweens.progress[0];
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				elapsed[i] += time_factor;
+				float time = elapsed[i] - delay[i];
+				if (time < 0.0f)
+				{
+					progress[i] = -1.0f;
+					continue;
+				}
+				float t = (duration[i] > 0.0f && time < duration[i]) ? time / duration[i] : 1.0f;
+				progress[i] = apply_easing((ETweenEasing)tweens.easing[i], t);
+			}
+
+			// tweens that just started take their starting values from the target
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				if (!tweens.started[i] && progress[i] >= 0.0f)
+				{
+					read_property(prop, get_touched_transformations(tweens.targets[i].get()), &tweens.from[i * channels]);
+					tweens.started[i] = 1;
+				}
+			}
+
+			// interpolate all values
+			const float* from = &tweens.from[0];
+			const float* to = &tweens.to[0];
+			float* values = &tweens.values[0];
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				float p = progress[i] < 0.0f ? 0.0f : progress[i];
+				for (unsigned int c = 0; c < channels; ++c)
+				{
+					unsigned int index = i * channels + c;
+					values[index] = from[index] + (to[index] - from[index]) * p;
+				}
+			}
+
+			// write the values to the targets new transformations and collect finished tweens
+			m_finished.clear();
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				if (progress[i] < 0.0f)
+					continue;
+
+				write_property(prop, get_touched_transformations(tweens.targets[i].get()), &values[i * channels]);
+				if (elapsed[i] - delay[i] >= duration[i])
+				{
+					m_finished.push_back(i);
+				}
+			}
+
+			// remove finished tweens (from last to first, so indexes remain valid) and keep their callbacks for later
+			for (unsigned int i = (unsigned int)m_finished.size(); i > 0; --i)
+			{
+				unsigned int index = m_finished[i - 1];
+				if (tweens.callbacks[index])
+				{
+					m_done_callbacks.push_back(tweens.callbacks[index]);
+					m_done_targets.push_back(tweens.targets[index]);
+					m_done_ids.push_back(tweens.ids[index]);
+				}
+				remove_tween(tweens, index);
+			}
+		}
+
+		void TweensManager::update(float time_factor)
+		{
+			// update all properties
+			for (unsigned int prop = 0; prop < TWEEN_PROPERTIES_COUNT; ++prop)
+			{
+				update_property((ETweenProperty)prop, time_factor);
+			}
+
+			// apply all changes, one update per target
+			for (unsigned int i = 0; i < m_touched.size(); ++i)
+			{
+				m_touched[i]->set_transformations(m_touched_trans[i]);
+			}
+			m_touched.clear();
+			m_touched_trans.clear();
+			m_touched_index.clear();
+
+			// call the callbacks of finished tweens (they may start new tweens)
+			for (unsigned int i = 0; i < m_done_callbacks.size(); ++i)
+			{
+				m_done_callbacks[i]->on_tween_done(m_done_targets[i], m_done_ids[i]);
+			}
+			m_done_callbacks.clear();
+			m_done_targets.clear();
+			m_done_ids.clear();
+		}
+
+		void TweensManager::do_animation(Renderer* renderer)
+		{
+			update(renderer->time_factor());
+		}
+	};
+};
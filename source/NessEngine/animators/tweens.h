@@ -0,0 +1,181 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+/**
+* A tweens engine - animate many targets properties with packed arrays instead of animator objects.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include "animator_api.h"
+#include "../basic_types/containers.h"
+#include "../renderable/transformations.h"
+
+namespace Ness
+{
+	namespace Animators
+	{
+		// tween unique id (0 is never a valid id)
+		typedef Uint32 TweenId;
+
+		// the properties a tween can animate
+		enum ETweenProperty
+		{
+			TWEEN_POSITION,
+			TWEEN_SCALE,
+			TWEEN_ROTATION,
+			TWEEN_OPACITY,
+			TWEEN_COLOR,
+			TWEEN_PROPERTIES_COUNT,
+		};
+
+		// easing curves
+		enum ETweenEasing
+		{
+			EASE_LINEAR,
+			EASE_IN_QUAD,
+			EASE_OUT_QUAD,
+			EASE_IN_OUT_QUAD,
+			EASE_IN_CUBIC,
+			EASE_OUT_CUBIC,
+			EASE_IN_OUT_CUBIC,
+			EASE_IN_SINE,
+			EASE_OUT_SINE,
+			EASE_IN_OUT_SINE,
+		};
+
+		/**
+		* callback to call when a tween is done
+		*/
+		class TweenCallback
+		{
+		public:
+			NESSENGINE_API virtual ~TweenCallback() {}
+
+			// called when a tween reach its end. it's ok to start new tweens from here.
+			NESSENGINE_API virtual void on_tween_done(const RenderablePtr& target, TweenId id) = 0;
+		};
+
+		// tween callback pointer
+		NESSENGINE_API typedef SharedPtr<TweenCallback> TweenCallbackPtr;
+
+		/**
+		* all the active tweens of a single property, stored as packed arrays.
+		* values of every tween take 'channels' floats (for example position has 2 channels, x and y).
+		*/
+		struct STweensArray
+		{
+			unsigned int							channels;	// how many floats per tween value
+			Containers::Vector<RenderablePtr>		targets;	// the targets to animate
+			Containers::Vector<TweenId>				ids;		// tweens ids
+			Containers::Vector<float>				from;		// starting values (set when the tween starts, after delay)
+			Containers::Vector<float>				to;			// ending values
+			Containers::Vector<float>				values;		// current values
+			Containers::Vector<float>				elapsed;	// time passed since tween was created
+			Containers::Vector<float>				delay;		// time to wait before starting
+			Containers::Vector<float>				duration;	// tween duration (after delay)
+			Containers::Vector<float>				progress;	// eased progress of the current frame (negative if not started yet)
+			Containers::Vector<Uint8>				easing;		// easing curve
+			Containers::Vector<Uint8>				started;	// did the tween start (and got its starting values)
+			Containers::Vector<TweenCallbackPtr>	callbacks;	// callbacks to call when done (may be empty)
+		};
+
+		/**
+		* the tweens manager animates position, scale, rotation, opacity and color of many targets.
+		* unlike animators, a tween is not an object - every tween is a row in packed arrays (one set of arrays per property), so
+		* updating thousands of tweens is a tight loop without virtual calls or allocations.
+		* all the changes made to a target during a frame are applied with a single set_transformations() call.
+		*
+		* usage example:
+		* Animators::TweensManagerPtr tweens = ness_make_ptr<Animators::TweensManager>();
+		* renderer.register_animator(tweens);
+		* tweens->tween_position(sprite, Point(100, 100), 2.0f, Animators::EASE_OUT_QUAD);
+		*/
+		class TweensManager : public AnimatorAPI
+		{
+		private:
+			STweensArray										m_tweens[TWEEN_PROPERTIES_COUNT];	// active tweens per property
+			TweenId												m_next_id;			// next tween id to give
+			Containers::Vector<RenderableAPI*>					m_touched;			// targets changed this frame
+			Containers::Vector<SRenderTransformations>			m_touched_trans;	// new transformations of the targets changed this frame
+			Containers::UnorderedMap<RenderableAPI*, unsigned int>	m_touched_index;	// index in m_touched of every changed target
+			Containers::Vector<unsigned int>					m_finished;			// finished tweens indexes (of the property currently updated)
+			Containers::Vector<TweenCallbackPtr>				m_done_callbacks;	// callbacks to call at the end of the update
+			Containers::Vector<RenderablePtr>					m_done_targets;		// targets of the callbacks to call
+			Containers::Vector<TweenId>							m_done_ids;			// ids of the callbacks to call
+
+		public:
+			NESSENGINE_API TweensManager();
+
+			// tween target properties from their current value (when the tween starts) to the given value.
+			// duration is in seconds, delay is how long to wait before starting, and callback (optional) is called when done.
+			// return the new tween id.
+			NESSENGINE_API TweenId tween_position(const RenderablePtr& target, const Point& to, float duration, ETweenEasing easing = EASE_LINEAR, float delay = 0.0f, const TweenCallbackPtr& callback = TweenCallbackPtr());
+			NESSENGINE_API TweenId tween_scale(const RenderablePtr& target, const Size& to, float duration, ETweenEasing easing = EASE_LINEAR, float delay = 0.0f, const TweenCallbackPtr& callback = TweenCallbackPtr());
+			NESSENGINE_API TweenId tween_rotation(const RenderablePtr& target, float to, float duration, ETweenEasing easing = EASE_LINEAR, float delay = 0.0f, const TweenCallbackPtr& callback = TweenCallbackPtr());
+			NESSENGINE_API TweenId tween_opacity(const RenderablePtr& target, float to, float duration, ETweenEasing easing = EASE_LINEAR, float delay = 0.0f, const TweenCallbackPtr& callback = TweenCallbackPtr());
+			NESSENGINE_API TweenId tween_color(const RenderablePtr& target, const Color& to, float duration, ETweenEasing easing = EASE_LINEAR, float delay = 0.0f, const TweenCallbackPtr& callback = TweenCallbackPtr());
+
+			// stop a tween (target stays with its current value). return false if tween not found (for example if already done).
+			NESSENGINE_API bool cancel(TweenId id);
+
+			// stop all the tweens of a given target
+			NESSENGINE_API void cancel_all(const RenderablePtr& target);
+
+			// stop all tweens
+			NESSENGINE_API void clear();
+
+			// return how many tweens are currently active
+			NESSENGINE_API unsigned int get_active_count() const;
+
+			// update all the tweens by the given time (in seconds)
+			NESSENGINE_API void update(float time_factor);
+
+			// update all tweens using the renderer time factor
+			NESSENGINE_API virtual void do_animation(Renderer* renderer);
+
+			// apply a easing curve on a linear progress (0.0f - 1.0f)
+			NESSENGINE_API static float apply_easing(ETweenEasing easing, float t);
+
+		private:
+			// add a new tween. return its id
+			TweenId add_tween(ETweenProperty prop, const RenderablePtr& target, const float* to, float duration, ETweenEasing easing, float delay, const TweenCallbackPtr& callback);
+
+			// remove a tween from its array (swap with last)
+			void remove_tween(STweensArray& tweens, unsigned int index);
+
+			// update all the tweens of a single property
+			void update_property(ETweenProperty prop, float time_factor);
+
+			// get the new transformations of a target, to write changes into
+			SRenderTransformations& get_touched_transformations(RenderableAPI* target);
+
+			// read / write a property from transformations
+			static void read_property(ETweenProperty prop, const SRenderTransformations& trans, float* out);
+			static void write_property(ETweenProperty prop, SRenderTransformations& trans, const float* in);
+		};
+
+		// tweens manager pointer
+		NESSENGINE_API typedef SharedPtr<TweensManager> TweensManagerPtr;
+	};
+};
@@ -27,6 +27,7 @@
 #include "size.h"
 #include "color.h"
 #include "math.h"
+#include "random.h"
 #include "events.h"
 #include "pointers.h"
 #include "string.h"
\ No newline at end of file
@@ -44,4 +44,8 @@ namespace Ness
 	// usage: Ness::SpritePtr sprite = ness_ptr_cast<Ness::Sprite>( SomeRenderablePtr );
 	// will return empty ptr if type cannot be cast to sprite.
 	#define ness_ptr_cast std::dynamic_pointer_cast
+
+	// cast a ness-pointer to a type you know it is, without RTTI check.
+	// usage: Ness::SpritePtr sprite = ness_static_ptr_cast<Ness::Sprite>( SomeRenderablePtr );
+	#define ness_static_ptr_cast std::static_pointer_cast
 };
\ No newline at end of file
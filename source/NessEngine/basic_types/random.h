@@ -0,0 +1,115 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+/**
+* Fast seedable random numbers generator, to use instead of the global rand().
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include <SDL.h>
+#include "../exports.h"
+
+namespace Ness
+{
+	/**
+	* a small and fast random numbers generator (PCG32).
+	* every object can hold its own generator, so random sequences are reproducible given the same seed and don't depend
+	* on other objects (or other threads) using random numbers.
+	* generators with the same seed but different stream ids produce different (independent) sequences.
+	*/
+	class RandomGenerator
+	{
+	private:
+		Uint64	m_state;	// current generator state
+		Uint64	m_inc;		// stream id (must be odd)
+
+	public:
+		// create the generator with a seed and stream id
+		NESSENGINE_API RandomGenerator(Uint64 seed = 0x853C49E6748FEA9BULL, Uint64 stream = 0) {set_seed(seed, stream);}
+
+		// set the seed and stream id of this generator (will restart the random sequence)
+		NESSENGINE_API inline void set_seed(Uint64 seed, Uint64 stream = 0)
+		{
+			m_state = 0;
+			m_inc = (stream << 1) | 1;
+			next();
+			m_state += seed;
+			next();
+		}
+
+		// return next random 32 bits number
+		NESSENGINE_API inline Uint32 next()
+		{
+			Uint64 old = m_state;
+			m_state = old * 6364136223846793005ULL + m_inc;
+			Uint32 xorshifted = (Uint32)(((old >> 18) ^ old) >> 27);
+			Uint32 rot = (Uint32)(old >> 59);
+			return (xorshifted >> rot) | (xorshifted << ((0 - rot) & 31));
+		}
+
+		// return a random float number between min and max
+		NESSENGINE_API inline float rand_float(float min = 0.0f, float max = 1.0f)
+		{
+			return min + (next() >> 8) * (1.0f / 16777216.0f) * (max - min);
+		}
+
+		// return a random int number between min (included) and max (not included)
+		NESSENGINE_API inline int rand_int(int min = 0, int max = 100)
+		{
+			return (max > min) ? min + (int)(next() % (Uint32)(max - min)) : min;
+		}
+
+		// return either +1 or -1
+		NESSENGINE_API inline int rand_direction()
+		{
+			return (next() & 0x80000000) ? 1 : -1;
+		}
+
+		// fill an array with count random float numbers between min and max
+		NESSENGINE_API inline void fill_floats(float* out, unsigned int count, float min = 0.0f, float max = 1.0f)
+		{
+			float factor = (1.0f / 16777216.0f) * (max - min);
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				out[i] = min + (next() >> 8) * factor;
+			}
+		}
+
+		// fill an array with count random int numbers between min (included) and max (not included)
+		NESSENGINE_API inline void fill_ints(int* out, unsigned int count, int min = 0, int max = 100)
+		{
+			if (max <= min)
+			{
+				for (unsigned int i = 0; i < count; ++i)
+					out[i] = min;
+				return;
+			}
+			Uint32 range = (Uint32)(max - min);
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				out[i] = min + (int)(next() % range);
+			}
+		}
+	};
+};
\ No newline at end of file
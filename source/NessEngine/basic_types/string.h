@@ -38,4 +38,18 @@ namespace Ness
 	#define ness_to_string std::to_string
 	#define ness_int_to_string(__int) std::to_string((long long)__int)
 	#define ness_float_to_string(__int) std::to_string((long double)__int)
+
+	// hash a resource name or file path (FNV-1a 64 bit).
+	// back slashes are hashed like forward slashes, so the same path hash the same on all platforms.
+	inline unsigned long long ness_hash_path(const String& path)
+	{
+		unsigned long long hash = 0xcbf29ce484222325ULL;
+		for (unsigned int i = 0; i < path.length(); i++)
+		{
+			char c = (path[i] == '\\') ? '/' : path[i];
+			hash ^= (unsigned char)c;
+			hash *= 0x100000001b3ULL;
+		}
+		return hash;
+	}
 };
\ No newline at end of file
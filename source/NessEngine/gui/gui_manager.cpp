@@ -3,6 +3,7 @@
 #include "../exceptions/exceptions.h"
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
 namespace Ness
 {
@@ -44,13 +45,24 @@ namespace Ness
 		void GuiManager::load_settings()
 		{
 
-			// open data file
-			std::ifstream infile;
-			infile.open(m_resources_path + "settings.dat");
-			if (infile.bad() || infile.eof()) 
+			// open data file (from a mounted asset pack if there, else from file)
+			std::ifstream file;
+			std::istringstream packed;
+			size_t packed_size = 0;
+			const char* packed_data = (const char*)m_renderer->resources().get_pack_file(m_resources_path + "settings.dat", packed_size);
+			if (packed_data)
 			{
-				throw FileNotFound((m_resources_path + "settings.dat").c_str());
+				packed.str(std::string(packed_data, packed_size));
 			}
+			else
+			{
+				file.open(m_resources_path + "settings.dat");
+				if (file.bad() || file.eof()) 
+				{
+					throw FileNotFound((m_resources_path + "settings.dat").c_str());
+				}
+			}
+			std::istream& infile = packed_data ? (std::istream&)packed : (std::istream&)file;
 
 			// load all gui settings
 			std::string line;
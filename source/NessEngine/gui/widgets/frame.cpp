@@ -140,13 +140,15 @@ namespace Ness
 
 		void Frame::update_texture(const String& state)
 		{
+			// all tiles get the same texture, so build its name only once
+			ManagedResources::ResourceName textureName(this->m_manager->get_resources_path() + m_textures_prefix + "_" + state + ".png");
 			Pointi index;
 			for (index.x = 0; index.x < m_size.x; ++index.x)
 			{
 				for (index.y = 0; index.y < m_size.y; ++index.y)
 				{
 					SpritePtr& tile = m_graphics->get_sprite(index);
-					tile->change_texture(this->m_manager->get_resources_path() + m_textures_prefix + "_" + state + ".png", false);
+					tile->change_texture(textureName, false);
 				}
 			}
 		}
@@ -29,6 +29,7 @@
 #pragma once
 #include <memory>
 #include "../resources/font.h"
+#include "../resources/asset_pack.h"
 #include "managed_resource.h"
 
 namespace Ness
@@ -37,12 +38,23 @@ namespace Ness
 	{
 		// predeclare the resources manager
 		class ResourcesManager;
+		struct __SFontInManager;
 
 		// a font inside the resources manager
 		class ManagedFont : public Resources::LoadedFont, public ManagedResource
 		{
+		private:
+			Resources::AssetPackPtr m_pack;		// if loaded from asset pack, keep the pack alive while font exists
+
 		public:
 			ManagedFont(const String& file_name, unsigned int font_size = 12) : LoadedFont(file_name, font_size) {}
+
+			// create the font from an asset pack entry
+			ManagedFont(const Resources::AssetPackPtr& pack, const Resources::SAssetPackEntry& entry, const String& file_name, unsigned int font_size = 12) 
+				: LoadedFont(pack->get_data(entry), (size_t)entry.data_size, file_name, font_size), m_pack(pack) {}
+
+			// the entry of this font inside the resources manager (set by the resources manager)
+			__SFontInManager*	rc_mng_entry;
 		};
 
 		// a manager font pointer
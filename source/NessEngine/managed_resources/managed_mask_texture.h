@@ -37,6 +37,7 @@ namespace Ness
 	{
 		// predeclare
 		class ResourcesManager;
+		struct __SMaskTextureInManager;
 
 		// a texture inside the resources manager
 		class ManagedMaskTexture : public Resources::MaskTextureSheet, public ManagedResource
@@ -44,6 +45,9 @@ namespace Ness
 		public:
 			// ctor for loading texture from file
 			ManagedMaskTexture(const String& file_name, SDL_Renderer* renderer) : MaskTextureSheet(file_name, renderer) {}
+
+			// the entry of this texture inside the resources manager (set by the resources manager)
+			__SMaskTextureInManager*	rc_mng_entry;
 		};
 
 		// a manager texture pointer
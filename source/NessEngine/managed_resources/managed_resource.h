@@ -28,6 +28,7 @@
 
 #pragma once
 #include "../basic_types/containers.h"
+#include "resource_name.h"
 
 namespace Ness
 {
@@ -43,6 +44,7 @@ namespace Ness
 		public:
 			ResourcesManager*	rc_mng_manager;		// pointer to the resource manager containing this resource
 			String				rc_mng_name;		// name of the resource inside the resources manager
+			ResourceId			rc_mng_id;			// id of the resource inside the resources manager
 		};
 	};
 };
\ No newline at end of file
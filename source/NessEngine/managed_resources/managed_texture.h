@@ -37,6 +37,7 @@ namespace Ness
 	{
 		// predeclare
 		class ResourcesManager;
+		struct __STextureInManager;
 
 		// a texture inside the resources manager
 		class ManagedTexture : public Resources::TextureSheet, public ManagedResource
@@ -47,6 +48,22 @@ namespace Ness
 
 			// ctor for creating empty texture from size
 			ManagedTexture(SDL_Renderer* renderer, const Sizei& size) : TextureSheet(renderer, size) {}
+
+			// ctor for texture that will be loaded in the background (see ResourcesManager::get_texture_async())
+			ManagedTexture(const String& file_name) : TextureSheet(file_name) {}
+
+			// ctor from an existing texture, like atlas pages or textures from asset packs (takes ownership on the texture)
+			ManagedTexture(SDL_Texture* texture, const Sizei& size) : TextureSheet(texture, size) {}
+
+			// ctor for a region inside an atlas page (see TextureAtlas). keeps the page alive while the region exists.
+			ManagedTexture(const SharedPtr<ManagedTexture>& page, const Rectangle& region, const String& file_name) 
+				: TextureSheet(page->texture(), region, file_name), m_atlas_page(page) {}
+
+			// the entry of this texture inside the resources manager (set by the resources manager)
+			__STextureInManager*		rc_mng_entry;
+
+		private:
+			SharedPtr<ManagedTexture>	m_atlas_page;		// if this texture is a region inside an atlas page, the page texture
 		};
 
 		// a manager texture pointer
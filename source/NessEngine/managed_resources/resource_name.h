@@ -0,0 +1,62 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+/**
+* Resource names with precalculated ids, used as keys in the resources manager.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include "../exports.h"
+#include <SDL.h>
+#include "../basic_types/all_basic_types.h"
+
+namespace Ness
+{
+	namespace ManagedResources
+	{
+		// resource id - the hash of the resource name (see ness_hash_path()).
+		// different names may get the same id (very rare), so the resources manager still checks the names when the ids match.
+		NESSENGINE_API typedef Uint64 ResourceId;
+
+		/**
+		* a resource name with its precalculated id.
+		* the resources manager getters also accept strings, but then the name is copied and hashed on every call. if you get the same
+		* resource very often (for example effects that are created and destroyed all the time), keep a ResourceName and pass it instead.
+		*/
+		class ResourceName
+		{
+		private:
+			String		m_name;		// resource name
+			ResourceId	m_id;		// resource id
+
+		public:
+			explicit ResourceName(const String& name) : m_name(name), m_id(ness_hash_path(name)) {}
+			explicit ResourceName(const char* name) : m_name(name), m_id(ness_hash_path(m_name)) {}
+
+			// get name and id
+			inline const String& name() const {return m_name;}
+			inline ResourceId id() const {return m_id;}
+		};
+	};
+};
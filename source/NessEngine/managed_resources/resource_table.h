@@ -0,0 +1,170 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+*/
+
+/**
+* Open addressing table of resources entries by their ids, used by the resources manager.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include "resource_name.h"
+
+namespace Ness
+{
+	namespace ManagedResources
+	{
+		/**
+		* a table of resources entries by resource id, with linear probing.
+		* the table allocates the entries and they never move, so it's safe to keep pointers to them until they are erased.
+		* different names may get the same id (very rare), so find() returns the entries with the given id one by one and the 
+		* caller checks which one it wants. in the common case the first probe is the right entry.
+		*/
+		template <typename T>
+		class ResourceTable
+		{
+		private:
+			struct SSlot
+			{
+				ResourceId	id;			// entry id
+				T*			entry;		// the entry (null if empty or deleted)
+				bool		deleted;	// true if an entry was erased from this slot (probing continues past it)
+			};
+
+			Containers::Vector<SSlot>	m_slots;		// the slots (size is always power of 2)
+			unsigned int				m_count;		// how many entries we have
+			unsigned int				m_used;			// how many slots are not empty (entries and deleted)
+
+		public:
+			ResourceTable() : m_count(0), m_used(0) {}
+			~ResourceTable() {clear();}
+
+			// return the next entry with the given id, or null if there are no more.
+			// cursor must be 0 on the first call, and is updated to continue the search on the next call.
+			T* find(ResourceId id, unsigned int& cursor) const
+			{
+				unsigned int mask = (unsigned int)m_slots.size() - 1;
+				for (; cursor < m_slots.size(); cursor++)
+				{
+					const SSlot& slot = m_slots[(unsigned int)(id + cursor) & mask];
+					if (slot.entry == nullptr && !slot.deleted)
+						return nullptr;
+					if (slot.entry && slot.id == id)
+					{
+						cursor++;
+						return slot.entry;
+					}
+				}
+				return nullptr;
+			}
+
+			// add a new entry with the given id (doesn't check if already exist) and return it
+			T& insert(ResourceId id)
+			{
+				// grow if too full (counting deleted slots)
+				if ((m_used + 1) * 4 > m_slots.size() * 3)
+				{
+					rehash(m_count * 2 + 2 > m_slots.size() ? (unsigned int)m_slots.size() * 2 : (unsigned int)m_slots.size());
+				}
+
+				// take the first free slot
+				unsigned int mask = (unsigned int)m_slots.size() - 1;
+				unsigned int index = (unsigned int)id & mask;
+				while (m_slots[index].entry)
+				{
+					index = (index + 1) & mask;
+				}
+				SSlot& slot = m_slots[index];
+				if (!slot.deleted)
+					m_used++;
+				slot.id = id;
+				slot.entry = new T();
+				slot.deleted = false;
+				m_count++;
+				return *slot.entry;
+			}
+
+			// remove and delete an entry
+			void erase(ResourceId id, T* entry)
+			{
+				unsigned int mask = (unsigned int)m_slots.size() - 1;
+				for (unsigned int i = 0; i < m_slots.size(); i++)
+				{
+					SSlot& slot = m_slots[(unsigned int)(id + i) & mask];
+					if (slot.entry == entry)
+					{
+						delete slot.entry;
+						slot.entry = nullptr;
+						slot.deleted = true;
+						m_count--;
+						return;
+					}
+				}
+			}
+
+			// remove and delete all entries
+			void clear()
+			{
+				for (unsigned int i = 0; i < m_slots.size(); i++)
+				{
+					delete m_slots[i].entry;
+				}
+				m_slots.clear();
+				m_count = m_used = 0;
+			}
+
+			// return how many entries we have
+			inline unsigned int size() const {return m_count;}
+
+		private:
+			// rebuild the table with new size (drops the deleted slots)
+			void rehash(unsigned int new_size)
+			{
+				if (new_size < 16)
+					new_size = 16;
+
+				Containers::Vector<SSlot> old_slots;
+				old_slots.swap(m_slots);
+				SSlot empty = {0, nullptr, false};
+				m_slots.resize(new_size, empty);
+				m_used = 0;
+
+				unsigned int mask = new_size - 1;
+				for (unsigned int i = 0; i < old_slots.size(); i++)
+				{
+					if (old_slots[i].entry == nullptr)
+						continue;
+					unsigned int index = (unsigned int)old_slots[i].id & mask;
+					while (m_slots[index].entry)
+					{
+						index = (index + 1) & mask;
+					}
+					m_slots[index] = old_slots[i];
+					m_used++;
+				}
+			}
+
+			// no copy
+			ResourceTable(const ResourceTable&);
+			ResourceTable& operator=(const ResourceTable&);
+		};
+	};
+};
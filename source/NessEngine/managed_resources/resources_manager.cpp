@@ -24,6 +24,9 @@
 #include "../exceptions/exceptions.h"
 #include "../exceptions/log.h"
 #include "../renderer/renderer.h"
+#include <algorithm>
+#include <fstream>
+#include <cstring>
 
 namespace Ness
 {
@@ -32,73 +35,176 @@ namespace Ness
 		// function to call when a texture shared ptr deletes
 		void TextureResourceDeleter(ManagedTexture* texture)
 		{
-			texture->rc_mng_manager->__delete_texture(texture->rc_mng_name);
+			texture->rc_mng_manager->__delete_texture(texture);
 		}
 
 		// function to call when a mask texture shared ptr deletes
 		void MaskTextureResourceDeleter(ManagedMaskTexture* texture)
 		{
-			texture->rc_mng_manager->__delete_mask_texture(texture->rc_mng_name);
+			texture->rc_mng_manager->__delete_mask_texture(texture);
 		}
 
 		// function to call when a font shared ptr deletes
 		void FontResourceDeleter(ManagedFont* font)
 		{
-			font->rc_mng_manager->__delete_font(font->rc_mng_name);
+			font->rc_mng_manager->__delete_font(font);
 		}
 
-		void ResourcesManager::__delete_texture(const String& textureName)
+		// decode a texture that is loading in the background (unless another thread already took it)
+		static void decode_async_load(__SAsyncTextureLoad& load)
+		{
+			if (!SDL_AtomicCAS(&load.state, __ASYNC_LOAD_PENDING, __ASYNC_LOAD_DECODING))
+				return;
+			load.surface = Resources::TextureSheet::decode_file(load.file_name, load.use_color_key ? &load.color_key : nullptr, load.error);
+			SDL_AtomicSet(&load.state, __ASYNC_LOAD_DECODED);
+		}
+
+		// a task to decode a texture file on the loaders pool
+		class AsyncTextureDecodeTask : public Utils::WorkerTask
+		{
+		private:
+			__SAsyncTextureLoadPtr m_load;
+
+		public:
+			AsyncTextureDecodeTask(const __SAsyncTextureLoadPtr& load) : m_load(load) {}
+			virtual void execute() {decode_async_load(*m_load);}
+		};
+
+		void ResourcesManager::__delete_texture(ManagedTexture* texture)
 		{	
 			// if already destroyed skip
 			if (m_destroyed)
 				return;
 
 			// decrease ref count by 1, and if no more refs delete the resource
-			m_textures[textureName].ref_count--;
-			if (m_textures[textureName].ref_count == 0)
+			__STextureInManager& entry = *texture->rc_mng_entry;
+			entry.ref_count--;
+			if (entry.ref_count == 0)
+			{
+				// if got memory budget, keep it in memory until exceeding the budget
+				if (m_textures_budget > 0 && entry.reloadable && entry.bytes > 0)
+				{
+					entry.cached = true;
+					entry.cache_pos = m_unused_textures.insert(m_unused_textures.end(), &entry);
+					m_textures_stats.cached_bytes += entry.bytes;
+					m_textures_stats.cached_count++;
+					evict_unused_textures();
+					return;
+				}
+
+				NESS_LOG(("rc_manager: delete no longer used texture: " + texture->rc_mng_name).c_str());
+				delete_texture_entry(entry);
+			}
+		}
+
+		void ResourcesManager::delete_texture_entry(__STextureInManager& entry)
+		{
+			ManagedTexture* text = entry.texture;
+
+			// remove from unused textures cache and update stats
+			if (entry.cached)
+			{
+				m_unused_textures.erase(entry.cache_pos);
+				m_textures_stats.cached_bytes -= entry.bytes;
+				m_textures_stats.cached_count--;
+			}
+			m_textures_stats.resident_bytes -= entry.bytes;
+
+			m_textures.erase(text->rc_mng_id, &entry);
+			m_renderer->__texture_destroyed(text->texture());
+			delete text;
+		}
+
+		void ResourcesManager::texture_requested(__STextureInManager& entry)
+		{
+			if (entry.cached)
+			{
+				m_unused_textures.erase(entry.cache_pos);
+				entry.cached = false;
+				m_textures_stats.cached_bytes -= entry.bytes;
+				m_textures_stats.cached_count--;
+				m_textures_stats.cache_hits++;
+			}
+		}
+
+		void ResourcesManager::update_texture_bytes(__STextureInManager& entry)
+		{
+			// atlas regions are part of the atlas pages so they don't count
+			size_t bytes = 0;
+			if (entry.texture->is_loaded() && !entry.texture->is_region())
 			{
-				NESS_LOG(("rc_manager: delete no longer used texture: " + textureName).c_str());
-				ManagedTexture* text = m_textures[textureName].texture;
-				m_textures.erase(textureName);
-				delete text;
+				bytes = (size_t)entry.texture->get_size().x * (size_t)entry.texture->get_size().y * 4;
+			}
+			m_textures_stats.resident_bytes = m_textures_stats.resident_bytes - entry.bytes + bytes;
+			entry.bytes = bytes;
+
+			evict_unused_textures();
+		}
+
+		void ResourcesManager::evict_unused_textures()
+		{
+			// delete least recently used textures until within budget
+			while (m_textures_stats.resident_bytes > m_textures_budget && !m_unused_textures.empty())
+			{
+				__STextureInManager& entry = *m_unused_textures.front();
+				NESS_LOG(("rc_manager: evict unused texture: " + entry.texture->rc_mng_name).c_str());
+				m_evicted_textures[entry.texture->rc_mng_id % NESS_EVICTED_TEXTURES_HISTORY] = entry.texture->rc_mng_id;
+				m_textures_stats.evictions++;
+				delete_texture_entry(entry);
+			}
+		}
+
+		void ResourcesManager::set_texture_memory_budget(size_t bytes)
+		{
+			m_textures_budget = bytes;
+			evict_unused_textures();
+		}
+
+		void ResourcesManager::clear_unused_textures()
+		{
+			while (!m_unused_textures.empty())
+			{
+				__STextureInManager& entry = *m_unused_textures.front();
+				NESS_LOG(("rc_manager: delete unused texture: " + entry.texture->rc_mng_name).c_str());
+				delete_texture_entry(entry);
 			}
 		}
 
-		void ResourcesManager::__delete_mask_texture(const String& textureName)
+		void ResourcesManager::__delete_mask_texture(ManagedMaskTexture* texture)
 		{
 			// if already destroyed skip
 			if (m_destroyed)
 				return;
 
 			// decrease ref count by 1, and if no more refs delete the resource
-			m_mask_textures[textureName].ref_count--;
-			if (m_mask_textures[textureName].ref_count == 0)
+			texture->rc_mng_entry->ref_count--;
+			if (texture->rc_mng_entry->ref_count == 0)
 			{
-				NESS_LOG(("rc_manager: delete no longer used mask texture: " + textureName).c_str());
-				ManagedMaskTexture* text = m_mask_textures[textureName].texture;
-				m_mask_textures.erase(textureName);
-				delete text;
+				NESS_LOG(("rc_manager: delete no longer used mask texture: " + texture->rc_mng_name).c_str());
+				m_mask_textures.erase(texture->rc_mng_id, texture->rc_mng_entry);
+				m_renderer->__texture_destroyed(texture->texture());
+				m_renderer->__texture_destroyed(texture->invert_texture());
+				delete texture;
 			}
 		}
 
-		void ResourcesManager::__delete_font(const String& fontName)
+		void ResourcesManager::__delete_font(ManagedFont* font)
 		{	
 			// if already destroyed skip
 			if (m_destroyed)
 				return;
 
 			// decrease ref count by 1, and if no more refs delete the resource
-			m_fonts[fontName].ref_count--;
-			if (m_fonts[fontName].ref_count == 0)
+			font->rc_mng_entry->ref_count--;
+			if (font->rc_mng_entry->ref_count == 0)
 			{
-				NESS_LOG(("rc_manager: delete no longer used font: " + fontName).c_str());
-				ManagedFont* font = m_fonts[fontName].font;
-				m_fonts.erase(fontName);
+				NESS_LOG(("rc_manager: delete no longer used font: " + font->rc_mng_name + " size: " + ness_int_to_string(font->get_font_size())).c_str());
+				m_fonts.erase(font->rc_mng_entry->key, font->rc_mng_entry);
 				delete font;
 			}
 		}
 
-		ManagedTexturePtr ResourcesManager::get_texture(const String& textureName)
+		ManagedTexturePtr ResourcesManager::get_texture(const ResourceName& textureName)
 		{
 			// make sure not destroyed
 			if (m_destroyed)
@@ -107,22 +213,479 @@ namespace Ness
 			}
 
 			// if not loaded, load it
-			if (m_textures.find(textureName) == m_textures.end())
+			__STextureInManager* entry = find_texture_entry(textureName);
+			if (entry == nullptr)
 			{
-				NESS_LOG(("rc_manager: load texture: " + textureName).c_str());
-				__STextureInManager& NewEntry = m_textures[textureName];
-				NewEntry.texture = new ManagedTexture(m_base_path + textureName, m_renderer->__sdl_renderer(), (m_use_color_key ? &m_color_key : nullptr));
-				NewEntry.texture->rc_mng_manager = this;
-				NewEntry.texture->rc_mng_name = textureName;
-				NewEntry.ref_count = 0;
+				const String& name = textureName.name();
+				NESS_LOG(("rc_manager: load texture: " + name).c_str());
+				ManagedTexture* texture;
+				Resources::AssetPackPtr pack;
+				const Resources::SAssetPackEntry* packEntry = find_in_packs(name, Resources::ASSET_PACK_TEXTURE, pack);
+				if (packEntry)
+				{
+					texture = create_texture_from_pack(pack, *packEntry);
+				}
+				else if (m_atlas)
+				{
+					// decode first, so we can check if it fits the atlas
+					String error;
+					SDL_Surface* surface = Resources::TextureSheet::decode_file(m_base_path + name, (m_use_color_key ? &m_color_key : nullptr), error);
+					if (surface == nullptr)
+					{
+						throw FailedToLoadTextureFile((m_base_path + name).c_str(), error.c_str());
+					}
+					texture = create_texture_from_surface(surface, m_base_path + name);
+				}
+				else
+				{
+					texture = new ManagedTexture(m_base_path + name, m_renderer->__sdl_renderer(), (m_use_color_key ? &m_color_key : nullptr));
+				}
+				entry = &add_texture_entry(textureName, texture);
+			}
+			// if exist but still loading in the background, finish loading it now
+			else
+			{
+				texture_requested(*entry);
+				ensure_texture_loaded(entry->texture);
 			}
 
 			// return the texture
-			m_textures[textureName].ref_count++;
-			return ManagedTexturePtr(m_textures[textureName].texture, TextureResourceDeleter);
+			entry->ref_count++;
+			return ManagedTexturePtr(entry->texture, TextureResourceDeleter);
+		}
+
+		__STextureInManager* ResourcesManager::find_texture_entry(const ResourceName& textureName)
+		{
+			// different names may get the same id, so check the name of every entry with this id (usually there's only one)
+			unsigned int cursor = 0;
+			__STextureInManager* entry;
+			while ((entry = m_textures.find(textureName.id(), cursor)) != nullptr)
+			{
+				if (entry->texture->rc_mng_name == textureName.name())
+					return entry;
+			}
+			return nullptr;
+		}
+
+		ManagedTexturePtr ResourcesManager::get_texture_async(const ResourceName& textureName, const TextureLoadCallbackPtr& callback)
+		{
+			// make sure not destroyed
+			if (m_destroyed)
+			{
+				throw IllegalAction("Tried to get texture but the reousrces manager is already destroyed!");
+			}
+
+			__STextureInManager* entryPtr = find_texture_entry(textureName);
+			if (entryPtr == nullptr)
+			{
+				// if in a mounted pack, there's nothing to decode so just load it now
+				const String& name = textureName.name();
+				Resources::AssetPackPtr pack;
+				const Resources::SAssetPackEntry* packEntry = find_in_packs(name, Resources::ASSET_PACK_TEXTURE, pack);
+				if (packEntry)
+				{
+					NESS_LOG(("rc_manager: load texture from pack: " + name).c_str());
+					entryPtr = &add_texture_entry(textureName, create_texture_from_pack(pack, *packEntry));
+				}
+				// if not loaded, create an empty texture to load into
+				else
+				{
+					NESS_LOG(("rc_manager: load texture in background: " + name).c_str());
+					entryPtr = &add_texture_entry(textureName, new ManagedTexture(m_base_path + name));
+				}
+			}
+
+			// get the texture
+			__STextureInManager& entry = *entryPtr;
+			texture_requested(entry);
+			entry.ref_count++;
+			ManagedTexturePtr ret(entry.texture, TextureResourceDeleter);
+
+			// check if already loading in the background
+			__SAsyncTextureLoadPtr load;
+			for (unsigned int i = 0; i < m_async_loads.size(); i++)
+			{
+				if (m_async_loads[i]->texture.get() == entry.texture)
+				{
+					load = m_async_loads[i];
+					break;
+				}
+			}
+
+			// if not loading, start loading it (or if already loaded and got callback, just queue the callback)
+			if (!load && (callback || !ret->is_loaded()))
+			{
+				load = ness_make_ptr<__SAsyncTextureLoad>();
+				load->texture = ret;
+				load->file_name = ret->get_file_name();
+				load->color_key = m_color_key;
+				load->use_color_key = m_use_color_key;
+				load->surface = nullptr;
+				load->uploaded = ret->is_loaded();
+				SDL_AtomicSet(&load->state, load->uploaded ? __ASYNC_LOAD_DECODED : __ASYNC_LOAD_PENDING);
+				m_async_loads.push_back(load);
+
+				// push the decoding task
+				if (!load->uploaded)
+				{
+					if (!m_loaders_pool)
+						m_loaders_pool = ness_make_ptr<Utils::WorkersPool>(m_loaders_count);
+					m_loaders_pool->push_task(ness_make_ptr<AsyncTextureDecodeTask>(load));
+				}
+			}
+
+			// add callback
+			if (callback)
+				load->callbacks.push_back(callback);
+
+			return ret;
+		}
+
+		ManagedTexture* ResourcesManager::create_texture_from_surface(SDL_Surface* surface, const String& fileName)
+		{
+			// try to pack into the atlas
+			ManagedTexture* texture = nullptr;
+			if (m_atlas && surface->w <= m_atlas_max_size.x && surface->h <= m_atlas_max_size.y)
+			{
+				try
+				{
+					texture = m_atlas->add_surface(surface, fileName);
+				}
+				catch (...)
+				{
+					SDL_FreeSurface(surface);
+					throw;
+				}
+			}
+
+			// packed? free the surface and return the region
+			if (texture)
+			{
+				SDL_FreeSurface(surface);
+				return texture;
+			}
+
+			// create as a regular texture
+			texture = new ManagedTexture(fileName);
+			try
+			{
+				texture->load_surface(surface, m_renderer->__sdl_renderer());
+			}
+			catch (...)
+			{
+				delete texture;
+				throw;
+			}
+			return texture;
+		}
+
+		ManagedTexture* ResourcesManager::create_texture_from_pack(const Resources::AssetPackPtr& pack, const Resources::SAssetPackEntry& entry)
+		{
+			// if fits the atlas, pack it (the surface points to the mapped pixels, so no copy is made until it is packed)
+			if (m_atlas && (int)entry.width <= m_atlas_max_size.x && (int)entry.height <= m_atlas_max_size.y)
+			{
+				return create_texture_from_surface(pack->create_surface(entry), pack->get_name(entry));
+			}
+
+			// upload directly from the mapped pixels
+			SDL_Texture* texture = pack->create_texture(entry, m_renderer->__sdl_renderer());
+			return new ManagedTexture(texture, Sizei(entry.width, entry.height));
+		}
+
+		const Resources::SAssetPackEntry* ResourcesManager::find_in_packs(const String& name, Resources::EAssetPackEntryType type, Resources::AssetPackPtr& out_pack)
+		{
+			// search from last mounted to first
+			for (int i = (int)m_packs.size() - 1; i >= 0; i--)
+			{
+				const Resources::SAssetPackEntry* entry = m_packs[i]->find(name);
+				if (entry && entry->type == (Uint32)type)
+				{
+					out_pack = m_packs[i];
+					return entry;
+				}
+			}
+			return nullptr;
+		}
+
+		Resources::AssetPackPtr ResourcesManager::mount_pack(const String& packFile)
+		{
+			// make sure not destroyed
+			if (m_destroyed)
+			{
+				throw IllegalAction("Tried to mount asset pack but the reousrces manager is already destroyed!");
+			}
+
+			NESS_LOG(("rc_manager: mount asset pack: " + packFile).c_str());
+			Resources::AssetPackPtr pack = ness_make_ptr<Resources::AssetPack>(m_base_path + packFile);
+			m_packs.push_back(pack);
+			return pack;
+		}
+
+		void ResourcesManager::unmount_packs()
+		{
+			m_packs.clear();
+		}
+
+		const void* ResourcesManager::get_pack_file(const String& fileName, size_t& out_size)
+		{
+			Resources::AssetPackPtr pack;
+			const Resources::SAssetPackEntry* entry = find_in_packs(fileName, Resources::ASSET_PACK_FILE, pack);
+			if (entry == nullptr)
+				return nullptr;
+			out_size = (size_t)entry->data_size;
+			return pack->get_data(*entry);
+		}
+
+		__STextureInManager& ResourcesManager::add_texture_entry(const ResourceName& textureName, ManagedTexture* texture)
+		{
+			__STextureInManager& NewEntry = m_textures.insert(textureName.id());
+			NewEntry.texture = texture;
+			NewEntry.texture->rc_mng_manager = this;
+			NewEntry.texture->rc_mng_name = textureName.name();
+			NewEntry.texture->rc_mng_id = textureName.id();
+			NewEntry.texture->rc_mng_entry = &NewEntry;
+			NewEntry.ref_count = 0;
+			NewEntry.bytes = 0;
+			NewEntry.reloadable = true;
+			NewEntry.cached = false;
+
+			// count textures that were evicted and now loaded again
+			ResourceId& evicted = m_evicted_textures[textureName.id() % NESS_EVICTED_TEXTURES_HISTORY];
+			if (evicted == textureName.id())
+			{
+				m_textures_stats.reloads++;
+				evicted = 0;
+			}
+
+			// textures in the atlas are kept alive until the atlas is disabled (the atlas space can't be reused anyway)
+			if (texture->is_region())
+			{
+				NewEntry.ref_count++;
+				m_atlas_textures.push_back(ManagedTexturePtr(texture, TextureResourceDeleter));
+			}
+
+			update_texture_bytes(NewEntry);
+			return NewEntry;
+		}
+
+		void ResourcesManager::enable_atlas(const Sizei& page_size, const Sizei& max_texture_size, int padding)
+		{
+			if (m_atlas)
+			{
+				throw IllegalAction("Texture atlas is already enabled!");
+			}
+			m_atlas = ness_make_ptr<TextureAtlas>(m_renderer->__sdl_renderer(), page_size, padding);
+			m_atlas_max_size = max_texture_size;
+		}
+
+		void ResourcesManager::disable_atlas()
+		{
+			m_atlas.reset();
+			m_atlas_textures.clear();
+		}
+
+		// used to sort decoded surfaces by height (tallest first) before packing them
+		static bool compare_surfaces_height(const std::pair<ResourceName, SDL_Surface*>& a, const std::pair<ResourceName, SDL_Surface*>& b)
+		{
+			return a.second->h > b.second->h;
+		}
+
+		void ResourcesManager::pack_textures(const Containers::Vector<String>& textureNames)
+		{
+			// make sure atlas is enabled
+			if (!m_atlas)
+			{
+				throw IllegalAction("Cannot pack textures when texture atlas is disabled!");
+			}
+
+			// decode all the textures that are not loaded yet
+			Containers::Vector<std::pair<ResourceName, SDL_Surface*> > surfaces;
+			for (unsigned int i = 0; i < textureNames.size(); i++)
+			{
+				ResourceName resName(textureNames[i]);
+				const String& name = resName.name();
+				if (find_texture_entry(resName) != nullptr)
+					continue;
+
+				String error;
+				SDL_Surface* surface = Resources::TextureSheet::decode_file(m_base_path + name, (m_use_color_key ? &m_color_key : nullptr), error);
+				if (surface == nullptr)
+				{
+					for (unsigned int j = 0; j < surfaces.size(); j++)
+						SDL_FreeSurface(surfaces[j].second);
+					throw FailedToLoadTextureFile((m_base_path + name).c_str(), error.c_str());
+				}
+				surfaces.push_back(std::make_pair(resName, surface));
+			}
+
+			// pack them, tallest first
+			std::sort(surfaces.begin(), surfaces.end(), compare_surfaces_height);
+			for (unsigned int i = 0; i < surfaces.size(); i++)
+			{
+				// skip duplications
+				const ResourceName& resName = surfaces[i].first;
+				const String& name = resName.name();
+				if (find_texture_entry(resName) != nullptr)
+				{
+					SDL_FreeSurface(surfaces[i].second);
+					continue;
+				}
+
+				NESS_LOG(("rc_manager: pack texture: " + name).c_str());
+				ManagedTexture* texture;
+				try
+				{
+					texture = create_texture_from_surface(surfaces[i].second, m_base_path + name);
+				}
+				catch (...)
+				{
+					for (unsigned int j = i + 1; j < surfaces.size(); j++)
+						SDL_FreeSurface(surfaces[j].second);
+					throw;
+				}
+				add_texture_entry(resName, texture);
+			}
+		}
+
+		void ResourcesManager::load_atlas_manifest(const String& manifestFile)
+		{
+			// open manifest file
+			std::ifstream infile;
+			infile.open((m_base_path + manifestFile).c_str());
+			if (!infile.is_open()) 
+			{
+				throw FileNotFound((m_base_path + manifestFile).c_str());
+			}
+
+			// read all texture names
+			Containers::Vector<String> names;
+			std::string line;
+			while (std::getline(infile, line))
+			{
+				// remove spaces and line breaks from the edges
+				size_t start = line.find_first_not_of(" \t\r\n");
+				size_t end = line.find_last_not_of(" \t\r\n");
+				if (start == std::string::npos)
+					continue;
+				line = line.substr(start, end - start + 1);
+
+				// ignore comments
+				if (line[0] == '#')
+					continue;
+
+				names.push_back(line);
+			}
+
+			pack_textures(names);
+		}
+
+		void ResourcesManager::set_async_loaders_count(unsigned int threads_count)
+		{
+			if (m_loaders_pool)
+			{
+				throw IllegalAction("Cannot change loaders count after background loading started!");
+			}
+			m_loaders_count = threads_count;
+		}
+
+		void ResourcesManager::ensure_texture_loaded(ManagedTexture* texture)
+		{
+			if (texture->is_loaded())
+				return;
+
+			// if still loading in the background, wait for it to decode and upload it now
+			for (unsigned int i = 0; i < m_async_loads.size(); i++)
+			{
+				__SAsyncTextureLoad& load = *m_async_loads[i];
+				if (load.texture.get() == texture && !load.uploaded)
+				{
+					// decode on this thread if no worker took it yet, else wait for the worker to finish
+					decode_async_load(load);
+					while (SDL_AtomicGet(&load.state) != __ASYNC_LOAD_DECODED)
+					{
+						SDL_Delay(1);
+					}
+					upload_async_load(load);
+					break;
+				}
+			}
+
+			// if still not loaded it means it failed. try again and throw exception if failed
+			if (!texture->is_loaded())
+			{
+				String error;
+				SDL_Surface* surface = Resources::TextureSheet::decode_file(texture->get_file_name(), (m_use_color_key ? &m_color_key : nullptr), error);
+				if (surface == nullptr)
+				{
+					throw FailedToLoadTextureFile(texture->get_file_name().c_str(), error.c_str());
+				}
+				texture->load_surface(surface, m_renderer->__sdl_renderer());
+				update_texture_bytes(*texture->rc_mng_entry);
+			}
+		}
+
+		bool ResourcesManager::upload_async_load(__SAsyncTextureLoad& load)
+		{
+			load.uploaded = true;
+
+			// failed to decode?
+			if (load.surface == nullptr)
+			{
+				NESS_ERROR(("rc_manager: failed to load texture in background: " + load.file_name + " reason: " + load.error).c_str());
+				return false;
+			}
+
+			// create the texture (load_surface takes the surface ownership)
+			SDL_Surface* surface = load.surface;
+			load.surface = nullptr;
+			try
+			{
+				load.texture->load_surface(surface, m_renderer->__sdl_renderer());
+			}
+			catch (FailedToLoadTextureFile&)
+			{
+				return false;
+			}
+			update_texture_bytes(*load.texture->rc_mng_entry);
+			return true;
 		}
 
-		ManagedMaskTexturePtr ResourcesManager::get_mask_texture(const String& textureName)
+		void ResourcesManager::__update_async_loads()
+		{
+			Uint32 start_time = SDL_GetTicks();
+			bool did_upload = false;
+			unsigned int i = 0;
+			while (i < m_async_loads.size())
+			{
+				// skip textures that are still decoding
+				__SAsyncTextureLoadPtr load = m_async_loads[i];
+				if (SDL_AtomicGet(&load->state) != __ASYNC_LOAD_DECODED)
+				{
+					i++;
+					continue;
+				}
+
+				// upload the texture (unless out of time budget)
+				bool success = load->texture->is_loaded();
+				if (!load->uploaded)
+				{
+					if (did_upload && SDL_GetTicks() - start_time >= m_upload_budget)
+						break;
+					success = upload_async_load(*load);
+					did_upload = true;
+				}
+
+				// remove from loading list and call the callbacks.
+				// note: remove first because callbacks may load more textures.
+				m_async_loads.erase(m_async_loads.begin() + i);
+				for (unsigned int j = 0; j < load->callbacks.size(); j++)
+				{
+					load->callbacks[j]->on_texture_loaded(load->texture, success);
+				}
+			}
+		}
+
+		ManagedMaskTexturePtr ResourcesManager::get_mask_texture(const ResourceName& textureName)
 		{
 			// make sure not destroyed
 			if (m_destroyed)
@@ -131,22 +694,36 @@ namespace Ness
 			}
 
 			// if not loaded, load it
-			if (m_mask_textures.find(textureName) == m_mask_textures.end())
+			// find it (check the names of entries with the same id, see find_texture_entry())
+			unsigned int cursor = 0;
+			__SMaskTextureInManager* entry;
+			while ((entry = m_mask_textures.find(textureName.id(), cursor)) != nullptr)
+			{
+				if (entry->texture->rc_mng_name == textureName.name())
+					break;
+			}
+
+			// if not loaded, load it
+			if (entry == nullptr)
 			{
-				NESS_LOG(("rc_manager: load mask texture: " + textureName).c_str());
-				__SMaskTextureInManager& NewEntry = m_mask_textures[textureName];
-				NewEntry.texture = new ManagedMaskTexture(m_base_path + textureName, m_renderer->__sdl_renderer());
+				NESS_LOG(("rc_manager: load mask texture: " + textureName.name()).c_str());
+				ManagedMaskTexture* texture = new ManagedMaskTexture(m_base_path + textureName.name(), m_renderer->__sdl_renderer());
+				__SMaskTextureInManager& NewEntry = m_mask_textures.insert(textureName.id());
+				NewEntry.texture = texture;
 				NewEntry.texture->rc_mng_manager = this;
-				NewEntry.texture->rc_mng_name = textureName;
+				NewEntry.texture->rc_mng_name = textureName.name();
+				NewEntry.texture->rc_mng_id = textureName.id();
+				NewEntry.texture->rc_mng_entry = &NewEntry;
 				NewEntry.ref_count = 0;
+				entry = &NewEntry;
 			}
 
 			// return the texture
-			m_mask_textures[textureName].ref_count++;
-			return ManagedMaskTexturePtr(m_mask_textures[textureName].texture, MaskTextureResourceDeleter);
+			entry->ref_count++;
+			return ManagedMaskTexturePtr(entry->texture, MaskTextureResourceDeleter);
 		}
 
-		NESSENGINE_API ManagedFontPtr ResourcesManager::get_font(const String& fontName, unsigned int font_size)
+		NESSENGINE_API ManagedFontPtr ResourcesManager::get_font(const ResourceName& fontName, unsigned int font_size)
 		{
 			// make sure not destroyed
 			if (m_destroyed)
@@ -154,28 +731,48 @@ namespace Ness
 				throw IllegalAction("Tried to get font but the reousrces manager is already destroyed!");
 			}
 
-			// get name in hash
-			String fullName = fontName + ness_to_string((long long)font_size);
+			// get font key by mixing the font size into the name id (same font in different sizes are different resources).
+			// different fonts may get the same key, so check the name and size of every entry with this key.
+			ResourceId key = fontName.id() ^ ((ResourceId)font_size * 0x9e3779b97f4a7c15ULL);
+			unsigned int cursor = 0;
+			__SFontInManager* entry;
+			while ((entry = m_fonts.find(key, cursor)) != nullptr)
+			{
+				if (entry->font->get_font_size() == font_size && entry->font->rc_mng_name == fontName.name())
+					break;
+			}
 
 			// if not loaded, load it
-			if (m_fonts.find(fullName) == m_fonts.end())
+			if (entry == nullptr)
 			{
-				NESS_LOG(("rc_manager: load font: " + fullName).c_str());
-				__SFontInManager& NewEntry = m_fonts[fullName];
-				NewEntry.font = new ManagedFont(m_base_path + fontName, font_size);
+				const String& name = fontName.name();
+				NESS_LOG(("rc_manager: load font: " + name + " size: " + ness_int_to_string(font_size)).c_str());
+				ManagedFont* font;
+				Resources::AssetPackPtr pack;
+				const Resources::SAssetPackEntry* packEntry = find_in_packs(name, Resources::ASSET_PACK_FONT, pack);
+				if (packEntry)
+					font = new ManagedFont(pack, *packEntry, m_base_path + name, font_size);
+				else
+					font = new ManagedFont(m_base_path + name, font_size);
+				__SFontInManager& NewEntry = m_fonts.insert(key);
+				NewEntry.font = font;
 				NewEntry.font->rc_mng_manager = this;
-				NewEntry.font->rc_mng_name = fullName;
+				NewEntry.font->rc_mng_name = name;
+				NewEntry.font->rc_mng_id = fontName.id();
+				NewEntry.font->rc_mng_entry = &NewEntry;
+				NewEntry.key = key;
 				NewEntry.ref_count = 0;
+				entry = &NewEntry;
 			}
 
-			// return the texture
-			m_fonts[fullName].ref_count++;
-			return ManagedFontPtr(m_fonts[fullName].font, FontResourceDeleter);
+			// return the font
+			entry->ref_count++;
+			return ManagedFontPtr(entry->font, FontResourceDeleter);
 		}
 
-		ManagedTexturePtr ResourcesManager::create_blank_texture(const String& textureName, const Sizei& size)
+		ManagedTexturePtr ResourcesManager::create_blank_texture(const ResourceName& textureName, const Sizei& size)
 		{
-			NESS_LOG(("rc_manager: create new empty texture: " + textureName).c_str());
+			NESS_LOG(("rc_manager: create new empty texture: " + textureName.name()).c_str());
 
 			// make sure not destroyed
 			if (m_destroyed)
@@ -184,35 +781,63 @@ namespace Ness
 			}
 
 			// if texture with that name exist, assert
-			if (m_textures.find(textureName) != m_textures.end())
+			if (find_texture_entry(textureName) != nullptr)
 			{
-				throw IllegalAction(("Texture with the name of '" + textureName + "' already exist!").c_str());
+				throw IllegalAction(("Texture with the name of '" + textureName.name() + "' already exist!").c_str());
 			}
 
 			// convert size if zero
 			Sizei TexSize = (size == Sizei::ZERO ? m_renderer->get_screen_size() : size);
 
 			// create the texture
-			__STextureInManager& NewEntry = m_textures[textureName];
+			__STextureInManager& NewEntry = m_textures.insert(textureName.id());
 			NewEntry.texture = new ManagedTexture(m_renderer->__sdl_renderer(), TexSize);
 			NewEntry.texture->rc_mng_manager = this;
-			NewEntry.texture->rc_mng_name = textureName;
+			NewEntry.texture->rc_mng_name = textureName.name();
+			NewEntry.texture->rc_mng_id = textureName.id();
+			NewEntry.texture->rc_mng_entry = &NewEntry;
 			NewEntry.ref_count = 0;
+			NewEntry.bytes = 0;
+			NewEntry.reloadable = false;
+			NewEntry.cached = false;
+			update_texture_bytes(NewEntry);
 
 			// return it
-			m_textures[textureName].ref_count++;
-			return ManagedTexturePtr(m_textures[textureName].texture, TextureResourceDeleter);
+			NewEntry.ref_count++;
+			return ManagedTexturePtr(NewEntry.texture, TextureResourceDeleter);
 		}
 
 		void ResourcesManager::destroy()
 		{
+			// delete the unused textures (nothing else will)
+			clear_unused_textures();
 			m_destroyed = true;
+
+			// stop background loading
+			if (m_loaders_pool)
+			{
+				m_loaders_pool->stop();
+				m_loaders_pool.reset();
+			}
+			for (unsigned int i = 0; i < m_async_loads.size(); i++)
+			{
+				if (m_async_loads[i]->surface)
+					SDL_FreeSurface(m_async_loads[i]->surface);
+			}
+			m_async_loads.clear();
+			m_atlas_textures.clear();
+			m_atlas.reset();
+			m_packs.clear();
+
 			m_textures.clear();
+			m_mask_textures.clear();
 			m_fonts.clear();
 		}
 
-		ResourcesManager::ResourcesManager() : m_use_color_key(false), m_renderer(nullptr), m_destroyed(false)
+		ResourcesManager::ResourcesManager() : m_use_color_key(false), m_renderer(nullptr), m_destroyed(false), m_loaders_count(0), m_upload_budget(4), m_textures_budget(0)
 		{
+			memset(&m_textures_stats, 0, sizeof(m_textures_stats));
+			memset(m_evicted_textures, 0, sizeof(m_evicted_textures));
 		}
 
 		ResourcesManager::~ResourcesManager()
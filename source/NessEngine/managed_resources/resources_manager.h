@@ -32,6 +32,14 @@
 #include "managed_texture.h"
 #include "managed_mask_texture.h"
 #include "managed_font.h"
+#include "resource_name.h"
+#include "resource_table.h"
+#include "texture_atlas.h"
+#include "../resources/asset_pack.h"
+#include "../utils/threads/workers_pool.h"
+
+// how many recently evicted textures ids to remember, to count reloads (see STexturesStats::reloads)
+#define NESS_EVICTED_TEXTURES_HISTORY 256
 
 namespace Ness
 {
@@ -44,8 +52,23 @@ namespace Ness
 		// Texture as it stored in the resources manager with reference count
 		struct __STextureInManager
 		{
-			unsigned int	ref_count;
-			ManagedTexture* texture;
+			unsigned int						ref_count;
+			ManagedTexture*						texture;
+			size_t								bytes;			// estimated memory used by this texture
+			bool								reloadable;		// can this texture be loaded again by name? (false for blank textures)
+			bool								cached;			// true if no longer referenced but kept in the unused textures cache
+			Containers::List<__STextureInManager*>::iterator	cache_pos;	// position in the unused textures cache (if cached)
+		};
+
+		// textures memory and cache stats (see ResourcesManager::set_texture_memory_budget())
+		struct STexturesStats
+		{
+			size_t			resident_bytes;		// estimated memory used by all loaded textures (including unused cached textures)
+			size_t			cached_bytes;		// estimated memory used by unused cached textures
+			unsigned int	cached_count;		// how many unused textures are cached
+			unsigned int	cache_hits;			// how many times an unused cached texture was requested again
+			unsigned int	evictions;			// how many unused textures were deleted because exceeded the budget
+			unsigned int	reloads;			// how many times a texture that was recently evicted had to be loaded again (approximated)
 		};
 
 		// Mask Texture as it stored in the resources manager with reference count
@@ -60,8 +83,47 @@ namespace Ness
 		{
 			unsigned int	ref_count;
 			ManagedFont*	font;
+			ResourceId		key;		// key in the fonts table (font name id mixed with font size)
+		};
+
+		// callback to get notified when a texture that was requested with get_texture_async() finish loading.
+		// inherit from this class and implement on_texture_loaded().
+		class TextureLoadCallback
+		{
+		public:
+			NESSENGINE_API virtual ~TextureLoadCallback() {}
+
+			// called from the rendering thread (during start_frame()) when the texture is loaded.
+			// if success is false, the texture failed to load and will remain empty.
+			NESSENGINE_API virtual void on_texture_loaded(const ManagedTexturePtr& texture, bool success) = 0;
 		};
 
+		// texture load callback pointer
+		NESSENGINE_API typedef SharedPtr<TextureLoadCallback> TextureLoadCallbackPtr;
+
+		// the states of a texture that is loading in the background
+		enum __EAsyncLoadState
+		{
+			__ASYNC_LOAD_PENDING,		// waiting for a worker to decode it
+			__ASYNC_LOAD_DECODING,		// currently decoding the image file
+			__ASYNC_LOAD_DECODED,		// image file decoded, waiting for upload on the rendering thread
+		};
+
+		// a texture that is loading in the background
+		struct __SAsyncTextureLoad
+		{
+			ManagedTexturePtr						texture;			// the texture to load (keeps it alive while loading)
+			String									file_name;			// full path of the file to load
+			Colorb									color_key;			// color key to apply
+			bool									use_color_key;		// should we apply the color key?
+			SDL_atomic_t							state;				// the load state (__EAsyncLoadState)
+			SDL_Surface*							surface;			// the decoded surface (or null if failed)
+			String									error;				// error message if failed to decode
+			bool									uploaded;			// true if texture was already uploaded (happens if requested by get_texture())
+			Containers::Vector<TextureLoadCallbackPtr>	callbacks;		// callbacks to call when done
+		};
+		typedef SharedPtr<__SAsyncTextureLoad> __SAsyncTextureLoadPtr;
+
 		/**
 		* the resources manager - manage all the resources loaded to memory (textures, fonts, etc..) and responsible
 		* to unload them automatically when no longer used.
@@ -69,14 +131,26 @@ namespace Ness
 		class ResourcesManager
 		{
 		private:
-			Containers::UnorderedMap<String, __STextureInManager>		m_textures;			// map that holds all loaded textures
-			Containers::UnorderedMap<String, __SMaskTextureInManager>	m_mask_textures;	// map that holds all loaded mask textures
-			Containers::UnorderedMap<String, __SFontInManager>			m_fonts;			// map that holds all loaded fonts
+			ResourceTable<__STextureInManager>							m_textures;			// table that holds all loaded textures
+			ResourceTable<__SMaskTextureInManager>						m_mask_textures;	// table that holds all loaded mask textures
+			ResourceTable<__SFontInManager>								m_fonts;			// table that holds all loaded fonts (by name and size)
 			String														m_base_path;		// basic path to search resources under
 			Colorb														m_color_key;		// transparency color key
 			bool														m_use_color_key;	// enable/disable color key
 			Renderer*													m_renderer;			// pointer to the renderer manager
 			bool														m_destroyed;		// was it destroyed?
+			Containers::Vector<__SAsyncTextureLoadPtr>					m_async_loads;		// textures currently loading in the background
+			Utils::WorkersPoolPtr										m_loaders_pool;		// workers to decode the textures loading in the background
+			unsigned int												m_loaders_count;	// how many loader threads to create
+			Uint32														m_upload_budget;	// max milliseconds to spend on uploading loaded textures every frame
+			TextureAtlasPtr												m_atlas;			// if not null, small textures will be packed into this atlas
+			Sizei														m_atlas_max_size;	// max size of textures to pack into the atlas
+			Containers::Vector<ManagedTexturePtr>						m_atlas_textures;	// keep all the textures packed into the atlas alive
+			Containers::Vector<Resources::AssetPackPtr>					m_packs;			// mounted asset packs (last mounted is searched first)
+			size_t														m_textures_budget;	// max memory for textures before deleting unused textures (0 = delete unused textures immediately)
+			Containers::List<__STextureInManager*>						m_unused_textures;	// unused textures that are kept in memory, least recently used first
+			ResourceId													m_evicted_textures[NESS_EVICTED_TEXTURES_HISTORY];	// ids of recently evicted textures, by id % history size (to count reloads)
+			STexturesStats												m_textures_stats;	// textures memory and cache stats
 
 		public:
 
@@ -87,13 +161,88 @@ namespace Ness
 			NESSENGINE_API inline void set_renderer(Renderer* renderer) {m_renderer = renderer;}
 
 			// get/load a texture
-			NESSENGINE_API ManagedTexturePtr get_texture(const String& textureName);
+			NESSENGINE_API ManagedTexturePtr get_texture(const ResourceName& textureName);
+			NESSENGINE_API inline ManagedTexturePtr get_texture(const String& textureName) {return get_texture(ResourceName(textureName));}
+
+			// get a texture and load it in the background, if not already loaded.
+			// this returns immediately with a texture that is empty until loaded (nothing will be drawn with it).
+			// the image file is decoded on loader threads, and the texture is created on the rendering thread in start_frame(),
+			// limited by the upload budget (see set_async_upload_budget()).
+			// callback (optional) will be called from start_frame() once the texture is ready, even if it was already loaded.
+			// note: calling get_texture() for a texture that is still loading will finish loading it immediately.
+			NESSENGINE_API ManagedTexturePtr get_texture_async(const ResourceName& textureName, const TextureLoadCallbackPtr& callback = TextureLoadCallbackPtr());
+			NESSENGINE_API inline ManagedTexturePtr get_texture_async(const String& textureName, const TextureLoadCallbackPtr& callback = TextureLoadCallbackPtr())
+				{return get_texture_async(ResourceName(textureName), callback);}
+
+			// return how many textures are currently loading in the background
+			NESSENGINE_API inline unsigned int get_async_loads_count() const {return (unsigned int)m_async_loads.size();}
+
+			// set the max time (in milliseconds) to spend every frame on creating textures that were loaded in the background.
+			// at least one texture is always created every frame, even if it takes longer. default to 4 ms.
+			NESSENGINE_API inline void set_async_upload_budget(Uint32 milliseconds) {m_upload_budget = milliseconds;}
+			NESSENGINE_API inline Uint32 get_async_upload_budget() const {return m_upload_budget;}
+
+			// set how many threads to use for decoding textures in the background (must be called before the first get_texture_async()).
+			// if 0 (default), will create one thread per cpu core minus one.
+			NESSENGINE_API void set_async_loaders_count(unsigned int threads_count);
+
+			// enable texture atlas.
+			// when enabled, textures loaded with get_texture() that are not bigger than max_texture_size are packed into big atlas
+			// pages instead of getting their own SDL texture, so sprites with different images can share textures and be batched.
+			// this is transparent: the returned texture is a region inside an atlas page, and source rects are relative to the image.
+			// note: textures already loaded are not affected. mask textures and textures loaded with get_texture_async() are never packed.
+			NESSENGINE_API void enable_atlas(const Sizei& page_size = Sizei(2048, 2048), const Sizei& max_texture_size = Sizei(256, 256), int padding = 1);
+
+			// disable the atlas for new textures (textures already packed remain valid as long as they are used)
+			NESSENGINE_API void disable_atlas();
+
+			// get the texture atlas (or empty pointer if disabled)
+			NESSENGINE_API inline const TextureAtlasPtr& get_atlas() const {return m_atlas;}
+
+			// load and pack a list of textures into the atlas at once (atlas must be enabled).
+			// textures are packed sorted by height, which packs much better than loading them one by one.
+			NESSENGINE_API void pack_textures(const Containers::Vector<String>& textureNames);
+
+			// load and pack textures listed in a manifest file (one texture name per line, lines that start with '#' are comments).
+			// see pack_textures() for more info.
+			NESSENGINE_API void load_atlas_manifest(const String& manifestFile);
+
+			// mount an asset pack file (created offline, see the AssetBaker example).
+			// once mounted, get_texture(), get_texture_async() and get_font() will first look for the resource in the mounted packs,
+			// using the same name you would use to load it from the resources path. textures in packs are already decoded, so
+			// loading them is just uploading the memory-mapped pixels. if a resource is not in any pack, it is loaded from file as usual.
+			// packs mounted later override resources of packs mounted before them.
+			NESSENGINE_API Resources::AssetPackPtr mount_pack(const String& packFile);
+
+			// unmount all asset packs (resources already loaded from them remain valid)
+			NESSENGINE_API void unmount_packs();
+
+			// get the data of a file from the mounted packs (by its name in pack). return null if not found in any pack.
+			// the data is valid as long as the pack is mounted.
+			NESSENGINE_API const void* get_pack_file(const String& fileName, size_t& out_size);
+
+			// set textures memory budget, in bytes (default to 0).
+			// when budget is 0, textures are deleted as soon as they are no longer used. when budget is set, textures that are no longer
+			// used remain in memory (so getting them again is instant), and are only deleted when total textures memory exceeds the budget,
+			// starting from the least recently used. this prevents reloading the same textures over and over, for example
+			// effects that are created and destroyed all the time.
+			// note: the budget only limits unused textures, textures in use are never deleted even if exceeding the budget.
+			NESSENGINE_API void set_texture_memory_budget(size_t bytes);
+			NESSENGINE_API inline size_t get_texture_memory_budget() const {return m_textures_budget;}
+
+			// delete all unused textures that are kept in memory
+			NESSENGINE_API void clear_unused_textures();
+
+			// get textures memory and cache stats
+			NESSENGINE_API inline const STexturesStats& get_textures_stats() const {return m_textures_stats;}
 
 			// get/load a masked texture
-			NESSENGINE_API ManagedMaskTexturePtr get_mask_texture(const String& textureName);
+			NESSENGINE_API ManagedMaskTexturePtr get_mask_texture(const ResourceName& textureName);
+			NESSENGINE_API inline ManagedMaskTexturePtr get_mask_texture(const String& textureName) {return get_mask_texture(ResourceName(textureName));}
 
 			// get/load a font
-			NESSENGINE_API ManagedFontPtr get_font(const String& fontName, unsigned int font_size = 12);
+			NESSENGINE_API ManagedFontPtr get_font(const ResourceName& fontName, unsigned int font_size = 12);
+			NESSENGINE_API inline ManagedFontPtr get_font(const String& fontName, unsigned int font_size = 12) {return get_font(ResourceName(fontName), font_size);}
 
 			// destroy the resources manager and anything in it
 			// once called, this instance is no longer useable!
@@ -102,7 +251,9 @@ namespace Ness
 			// create an empty texture you can render on (use as rendering target). 
 			// this texture will be added to the resource manager and you can later get it with get_texture()
 			// if size is ZERO, will use entire screen size
-			NESSENGINE_API ManagedTexturePtr create_blank_texture(const String& textureName, const Sizei& size = Sizei::ZERO);
+			NESSENGINE_API ManagedTexturePtr create_blank_texture(const ResourceName& textureName, const Sizei& size = Sizei::ZERO);
+			NESSENGINE_API inline ManagedTexturePtr create_blank_texture(const String& textureName, const Sizei& size = Sizei::ZERO)
+				{return create_blank_texture(ResourceName(textureName), size);}
 
 			// set the colorkey for this renderer
 			// every texture loaded after this set will turn all pixels in the color key to transparent
@@ -117,15 +268,53 @@ namespace Ness
 
 			// when a mask texture is removed (no longer referenced and deleted), it calls this function to be removed from the textures map as well
 			// DONT USE THIS ON YOUR OWN, it supposed to happen automatically when texture has no more references.
-			void __delete_mask_texture(const String& textureName);
+			void __delete_mask_texture(ManagedMaskTexture* texture);
 
 			// when a texture is removed (no longer referenced and deleted), it calls this function to be removed from the textures map as well
 			// DONT USE THIS ON YOUR OWN, it supposed to happen automatically when texture has no more references.
-			void __delete_texture(const String& textureName);
+			void __delete_texture(ManagedTexture* texture);
 
 			// when a font is removed (no longer referenced and deleted), it calls this function to be removed from the fonts map as well
 			// DONT USE THIS ON YOUR OWN, it supposed to happen automatically when a font has no more references.
-			void __delete_font(const String& fontName);
+			void __delete_font(ManagedFont* font);
+
+			// create the textures that finished loading in the background and call their callbacks.
+			// DONT USE THIS ON YOUR OWN, it is called by the renderer in start_frame().
+			NESSENGINE_API void __update_async_loads();
+
+		private:
+			// create a texture from a decoded surface (takes ownership on the surface). if fits the atlas, will be packed into it.
+			ManagedTexture* create_texture_from_surface(SDL_Surface* surface, const String& fileName);
+
+			// find a resource in the mounted packs. return null if not found.
+			const Resources::SAssetPackEntry* find_in_packs(const String& name, Resources::EAssetPackEntryType type, Resources::AssetPackPtr& out_pack);
+
+			// create a texture from asset pack entry. if fits the atlas, will be packed into it.
+			ManagedTexture* create_texture_from_pack(const Resources::AssetPackPtr& pack, const Resources::SAssetPackEntry& entry);
+
+			// add a newly created texture to the textures table
+			__STextureInManager& add_texture_entry(const ResourceName& textureName, ManagedTexture* texture);
+
+			// find a texture entry. return null if not found.
+			__STextureInManager* find_texture_entry(const ResourceName& textureName);
+
+			// update the memory size of a texture after it was loaded or created
+			void update_texture_bytes(__STextureInManager& entry);
+
+			// delete unused textures until textures memory is within budget
+			void evict_unused_textures();
+
+			// delete a texture and remove it from the textures map
+			void delete_texture_entry(__STextureInManager& entry);
+
+			// called when an existing texture is requested. if it's unused and cached, remove it from cache.
+			void texture_requested(__STextureInManager& entry);
+
+			// if a texture is not loaded yet (still loading in the background, or failed to load), load it now
+			void ensure_texture_loaded(ManagedTexture* texture);
+
+			// upload a texture that was decoded in the background
+			bool upload_async_load(__SAsyncTextureLoad& load);
 
 		};
 	};
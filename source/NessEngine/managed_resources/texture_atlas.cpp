@@ -0,0 +1,99 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+#include "texture_atlas.h"
+#include "../exceptions/exceptions.h"
+
+namespace Ness
+{
+	namespace ManagedResources
+	{
+		TextureAtlas::TextureAtlas(SDL_Renderer* renderer, const Sizei& page_size, int padding)
+			: m_renderer(renderer), m_page_size(page_size), m_padding(padding)
+		{
+		}
+
+		void TextureAtlas::add_page()
+		{
+			SDL_Texture* texture = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, m_page_size.x, m_page_size.y);
+			if (texture == nullptr)
+			{
+				throw FailedToLoadTextureFile("atlas page", SDL_GetError());
+			}
+			m_pages.push_back(ness_make_ptr<ManagedTexture>(texture, m_page_size));
+			m_packers.push_back(Resources::SkylinePacker(m_page_size));
+		}
+
+		ManagedTexture* TextureAtlas::add_surface(SDL_Surface* surface, const String& file_name)
+		{
+			// make sure fits in a page
+			Sizei size(surface->w, surface->h);
+			if (!can_fit(size))
+				return nullptr;
+
+			// find a page with room for this image (or add a new page)
+			Sizei padded_size(size.x + m_padding * 2, size.y + m_padding * 2);
+			Pointi position;
+			unsigned int page = 0;
+			while (page < m_packers.size() && !m_packers[page].insert(padded_size, position))
+			{
+				page++;
+			}
+			if (page == m_packers.size())
+			{
+				add_page();
+				m_packers[page].insert(padded_size, position);
+			}
+
+			// copy the image into a transparent surface with the padding around it, in the page pixel format.
+			// note: we upload the padding as well so it will be transparent and not garbage.
+			Uint32 rmask, gmask, bmask, amask;
+			int bpp;
+			SDL_PixelFormatEnumToMasks(SDL_PIXELFORMAT_RGBA8888, &bpp, &rmask, &gmask, &bmask, &amask);
+			SDL_Surface* padded = SDL_CreateRGBSurface(0, padded_size.x, padded_size.y, bpp, rmask, gmask, bmask, amask);
+			if (padded == nullptr)
+			{
+				throw FailedToLoadTextureFile(file_name.c_str(), SDL_GetError());
+			}
+			SDL_FillRect(padded, nullptr, 0);
+			SDL_BlendMode prev_blend;
+			SDL_GetSurfaceBlendMode(surface, &prev_blend);
+			SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+			SDL_Rect image_rect = {m_padding, m_padding, size.x, size.y};
+			SDL_BlitSurface(surface, nullptr, padded, &image_rect);
+			SDL_SetSurfaceBlendMode(surface, prev_blend);
+
+			// upload to the page texture
+			SDL_Rect page_rect = {position.x, position.y, padded_size.x, padded_size.y};
+			int result = SDL_UpdateTexture(m_pages[page]->texture(), &page_rect, padded->pixels, padded->pitch);
+			SDL_FreeSurface(padded);
+			if (result != 0)
+			{
+				throw FailedToLoadTextureFile(file_name.c_str(), SDL_GetError());
+			}
+
+			// create the region
+			Rectangle region(position.x + m_padding, position.y + m_padding, size.x, size.y);
+			return new ManagedTexture(m_pages[page], region, file_name);
+		}
+	};
+};
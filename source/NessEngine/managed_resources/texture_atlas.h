@@ -0,0 +1,85 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+/**
+* Texture atlas - pack many small images into big texture pages
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include "../exports.h"
+#include "../basic_types/containers.h"
+#include "../resources/skyline_packer.h"
+#include "managed_texture.h"
+
+namespace Ness
+{
+	namespace ManagedResources
+	{
+		/**
+		* a texture atlas packs many small images into a few big texture pages, so sprites that use different images can
+		* still share the same SDL texture (and be batched together by the renderer).
+		* every image added to the atlas becomes a ManagedTexture region: texture() returns the page texture, get_size() returns
+		* the image size, and the renderer adds the region offset to source rects automatically.
+		* usually you don't use this class directly, but enable it via ResourcesManager::enable_atlas().
+		*/
+		class TextureAtlas
+		{
+		private:
+			SDL_Renderer*								m_renderer;			// the renderer to create pages with
+			Sizei										m_page_size;		// size of every atlas page
+			int											m_padding;			// empty pixels to keep around every image
+			Containers::Vector<ManagedTexturePtr>		m_pages;			// the atlas pages
+			Containers::Vector<Resources::SkylinePacker>	m_packers;		// packer of every page
+
+		public:
+			// create the atlas.
+			// page_size is the size of every texture page, padding is how many empty pixels to keep around every image
+			// (to prevent neighbor images from bleeding when scaled).
+			NESSENGINE_API TextureAtlas(SDL_Renderer* renderer, const Sizei& page_size = Sizei(2048, 2048), int padding = 1);
+
+			// add an image to the atlas and return a new region texture for it (the caller owns it).
+			// return null if the image is too big to fit in a page.
+			// note: surface is not freed.
+			NESSENGINE_API ManagedTexture* add_surface(SDL_Surface* surface, const String& file_name);
+
+			// return if an image with a given size can fit in an atlas page
+			NESSENGINE_API inline bool can_fit(const Sizei& size) const 
+				{return size.x + m_padding * 2 <= m_page_size.x && size.y + m_padding * 2 <= m_page_size.y;}
+
+			// get the atlas pages
+			NESSENGINE_API inline unsigned int get_pages_count() const {return (unsigned int)m_pages.size();}
+			NESSENGINE_API inline const ManagedTexturePtr& get_page(unsigned int index) const {return m_pages[index];}
+
+			// get the atlas page size
+			NESSENGINE_API inline const Sizei& get_page_size() const {return m_page_size;}
+
+		private:
+			// add a new empty page
+			void add_page();
+		};
+
+		// texture atlas pointer
+		NESSENGINE_API typedef SharedPtr<TextureAtlas> TextureAtlasPtr;
+	};
+};
@@ -50,6 +50,15 @@ namespace Ness
 		}
 	}
 
+	AnimatedSprite::AnimatedSprite(Renderer* renderer, const ManagedResources::ResourceName& TextureName, Animators::AnimatorsQueue* animatorsQueuePtr)
+		: Animators::AnimatorsQueue(renderer), Sprite(renderer, TextureName) 
+	{
+		if (animatorsQueuePtr)
+		{
+			animatorsQueuePtr->__register_animator_unsafe(this);
+		}
+	}
+
 	AnimatedSprite::AnimatedSprite(Renderer* renderer, Animators::AnimatorsQueue* animatorsQueuePtr)
 		: Animators::AnimatorsQueue(renderer), Sprite(renderer) 
 	{
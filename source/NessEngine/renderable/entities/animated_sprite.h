@@ -58,6 +58,7 @@ namespace Ness
 		// you will need to register manually.
 		NESSENGINE_API AnimatedSprite(Renderer* renderer, ManagedResources::ManagedTexturePtr texture, Animators::AnimatorsQueue* animatorsQueuePtr);
 		NESSENGINE_API AnimatedSprite(Renderer* renderer, const String& TextureFile, Animators::AnimatorsQueue* animatorsQueuePtr);
+		NESSENGINE_API AnimatedSprite(Renderer* renderer, const ManagedResources::ResourceName& TextureName, Animators::AnimatorsQueue* animatorsQueuePtr);
 		NESSENGINE_API AnimatedSprite(Renderer* renderer, Animators::AnimatorsQueue* animatorsQueuePtr);
 
 		NESSENGINE_API ~AnimatedSprite();
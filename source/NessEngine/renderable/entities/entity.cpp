@@ -28,14 +28,53 @@ namespace Ness
 {
 
 	Entity::Entity(Renderer* renderer) : EntityAPI(renderer),
-		m_need_transformations_update(true), m_last_render_frame_id(0), m_last_update_frame_id(0), m_highlight(false)
+		m_need_transformations_update(true), m_last_render_frame_id(0), m_last_update_frame_id(0), m_highlight(false), m_parent_trans_generation(0), m_updating_from_parent(false)
 	{
+		m_kind |= RENDERABLE_KIND_ENTITY;
 	}
 
 	void Entity::transformations_update() 
 	{
 		m_last_update_frame_id = m_renderer->get_frameid();
 		m_need_transformations_update = true;
+		if (m_parent && !m_updating_from_parent)
+			m_parent->__son_transformations_update(this);
+	}
+
+	void Entity::check_parent_transformations()
+	{
+		if (m_parent)
+		{
+			Uint32 parent_generation = m_parent->__get_transformations_generation();
+			if (parent_generation != m_parent_trans_generation)
+			{
+				m_parent_trans_generation = parent_generation;
+				m_updating_from_parent = true;
+				transformations_update();
+				m_updating_from_parent = false;
+			}
+		}
+	}
+
+	void Entity::__update_flat_transformations(const SRenderTransformations& parent_trans, Uint32 parent_generation)
+	{
+		// check if parent changed
+		if (parent_generation != m_parent_trans_generation)
+		{
+			m_parent_trans_generation = parent_generation;
+			m_updating_from_parent = true;
+			transformations_update();
+			m_updating_from_parent = false;
+		}
+
+		// update cache and target rect if needed
+		if (m_need_transformations_update)
+		{
+			m_absolute_transformations = m_transformations;
+			m_absolute_transformations.add_transformations(parent_trans);
+			m_need_transformations_update = false;
+			calc_target_rect();
+		}
 	}
 
 	const SRenderTransformations& Entity::get_absolute_transformations_const() const
@@ -59,6 +98,7 @@ namespace Ness
 		}
 
 		// don't need update?
+		check_parent_transformations();
 		if (!m_need_transformations_update)
 		{
 			return m_absolute_transformations;
@@ -95,6 +135,7 @@ namespace Ness
 		}
 
 		// if was rendered during this frame, it's safe enough to assume it is visible
+		check_parent_transformations();
 		if ((!m_need_transformations_update) && was_rendered_this_frame())
 			return true;
 
@@ -143,7 +184,9 @@ namespace Ness
 
 	bool Entity::was_updated_this_frame() const
 	{
-		return m_renderer->get_frameid() == m_last_update_frame_id;
+		// also check if parent changed and we didn't notice yet
+		return (m_renderer->get_frameid() == m_last_update_frame_id) || 
+			(m_parent && m_parent->__get_transformations_generation() != m_parent_trans_generation);
 	}
 
 	void Entity::render(const CameraApiPtr& camera)
@@ -48,6 +48,8 @@ namespace Ness
 		unsigned int							m_last_render_frame_id;				// return the frame id of the last time this entity was really rendered
 		unsigned int							m_last_update_frame_id;				// return the frame id of the last time this entity was updated
 		unsigned char							m_highlight;						// how many highlight passes to do on this object
+		Uint32									m_parent_trans_generation;			// parent transformations generation the last time we checked it
+		bool									m_updating_from_parent;				// true while updating because the parent changed (the parent already knows, so it's not notified)
 
 	public:
 
@@ -58,7 +60,11 @@ namespace Ness
 		NESSENGINE_API virtual void transformations_update();
 
 		// return if need transformations udpate
-		NESSENGINE_API virtual bool need_transformations_update() {return m_need_transformations_update;}
+		NESSENGINE_API virtual bool need_transformations_update() {check_parent_transformations(); return m_need_transformations_update;}
+
+		// used by the scene flattened transformations pass (see Scene::set_flat_transformations()).
+		// update the transformations cache and target rect from parent absolute transformations and generation that were already calculated.
+		NESSENGINE_API void __update_flat_transformations(const SRenderTransformations& parent_trans, Uint32 parent_generation);
 
 		// return the last frame this entity was really rendered
 		NESSENGINE_API virtual unsigned int get_last_rendered_frame_id() const { return m_last_render_frame_id; }
@@ -127,6 +133,10 @@ namespace Ness
 
 	protected:
 
+		// check if parent transformations changed since last time we checked (see NodeAPI::__get_transformations_generation()).
+		// if they did, will call transformations_update() on this entity.
+		NESSENGINE_API void check_parent_transformations();
+
 		// the actual rendering function to override
 		// target: target rectangle to render to (final, with camera and everything calculated)
 		// transformations: absolute final transformations to render with (with parents included)
@@ -119,6 +119,7 @@ namespace Ness
 
 	void MultiText::render(const CameraApiPtr& camera)
 	{
+		check_parent_transformations();
 		if (m_need_text_positioning)
 			update_lines_positions();
 		
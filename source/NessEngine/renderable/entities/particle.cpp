@@ -41,6 +41,7 @@ namespace Ness
 		}
 
 		// don't need update?
+		check_parent_transformations();
 		if (!m_need_transformations_update)
 		{
 			return m_absolute_transformations;
@@ -28,12 +28,12 @@ namespace Ness
 	// defaults
 	SSpriteDefaults Sprite::Defaults;
 
-	Sprite::Sprite(Renderer* renderer) : Entity(renderer)
+	Sprite::Sprite(Renderer* renderer) : Entity(renderer), m_reset_size_on_load(false)
 	{
 		set_defaults();
 	}
 
-	Sprite::Sprite(Renderer* renderer, ManagedResources::ManagedTexturePtr texture) : Entity(renderer)
+	Sprite::Sprite(Renderer* renderer, ManagedResources::ManagedTexturePtr texture) : Entity(renderer), m_reset_size_on_load(false)
 	{
 		set_defaults();
 		change_texture(texture, true);
@@ -47,6 +47,20 @@ namespace Ness
 			set_size(Size((float)m_texture->get_size().x, (float)m_texture->get_size().y));
 			reset_source_rect();
 		}
+		m_reset_size_on_load = resetSizeAndSource && !m_texture->is_loaded();
+		appearance_update();
+	}
+
+	bool Sprite::is_really_visible(const CameraApiPtr& camera)
+	{
+		// if texture finished loading in the background, take its size
+		if (m_reset_size_on_load && m_texture->is_loaded())
+		{
+			m_reset_size_on_load = false;
+			set_size(Size((float)m_texture->get_size().x, (float)m_texture->get_size().y));
+			reset_source_rect();
+		}
+		return Entity::is_really_visible(camera);
 	}
 
 	void Sprite::change_texture(const String& NewTextureFile, bool resetSizeAndSource)
@@ -54,8 +68,13 @@ namespace Ness
 		change_texture(m_renderer->resources().get_texture(NewTextureFile), resetSizeAndSource);
 	}
 
+	void Sprite::change_texture(const ManagedResources::ResourceName& NewTextureName, bool resetSizeAndSource)
+	{
+		change_texture(m_renderer->resources().get_texture(NewTextureName), resetSizeAndSource);
+	}
 
-	Sprite::Sprite(Renderer* renderer, const String& TextureFile) : Entity(renderer)
+
+	Sprite::Sprite(Renderer* renderer, const String& TextureFile) : Entity(renderer), m_reset_size_on_load(false)
 	{
 		set_defaults();
 		if (TextureFile.length() > 0)
@@ -65,6 +84,16 @@ namespace Ness
 		}
 	}
 
+	Sprite::Sprite(Renderer* renderer, const ManagedResources::ResourceName& TextureName) : Entity(renderer), m_reset_size_on_load(false)
+	{
+		set_defaults();
+		if (TextureName.name().length() > 0)
+		{
+			ManagedResources::ManagedTexturePtr texture = m_renderer->resources().get_texture(TextureName);
+			change_texture(texture, true);
+		}
+	}
+
 	void Sprite::set_defaults()
 	{
 		m_static = Sprite::Defaults.is_static;
@@ -81,11 +110,13 @@ namespace Ness
 		m_source_rect.y = 0;
 		m_source_rect.w = (int)m_texture->get_size().x;
 		m_source_rect.h = (int)m_texture->get_size().y;
+		appearance_update();
 	}
 
 	void Sprite::set_source_rect(const Rectangle& srcRect)
 	{
 		m_source_rect = srcRect;
+		appearance_update();
 	}
 
 	void Sprite::set_source_from_sprite_sheet(const Pointi& step, const Sizei stepsCount, bool setSize)
@@ -100,6 +131,7 @@ namespace Ness
 		{
 			set_size(m_texture->get_size() / stepsCount);
 		}
+		appearance_update();
 	}
 
 	void Sprite::do_render(const Rectangle& target, const SRenderTransformations& transformations)
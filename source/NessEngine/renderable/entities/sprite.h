@@ -54,6 +54,7 @@ namespace Ness
 	protected:
 		ManagedResources::ManagedTexturePtr		m_texture;
 		Rectangle								m_source_rect;
+		bool									m_reset_size_on_load;		// if true, will reset size and source rect once the texture finish loading
 		
 	public:
 
@@ -63,6 +64,7 @@ namespace Ness
 		// create the sprite with texture
 		NESSENGINE_API Sprite(Renderer* renderer, ManagedResources::ManagedTexturePtr texture);
 		NESSENGINE_API Sprite(Renderer* renderer, const String& TextureFile);
+		NESSENGINE_API Sprite(Renderer* renderer, const ManagedResources::ResourceName& TextureName);
 		NESSENGINE_API Sprite(Renderer* renderer);
 
 		// set defaults (based on Sprite::Defaults)
@@ -71,14 +73,20 @@ namespace Ness
 		// change texture
 		// if resetSizeAndSource == true, it will also set the size of the sprite to the whole size of the texture and the source
 		// rect to be the entire texture size.
+		// note: if the texture is still loading in the background, size and source rect will be reset once it's loaded.
+		// tip: if you change textures by name very often, keep a ResourceName and pass it instead of a string.
 		NESSENGINE_API void change_texture(ManagedResources::ManagedTexturePtr NewTexture, bool resetSizeAndSource = true);
 		NESSENGINE_API void change_texture(const String& NewTextureFile, bool resetSizeAndSource = true);
+		NESSENGINE_API void change_texture(const ManagedResources::ResourceName& NewTextureName, bool resetSizeAndSource = true);
 
 		// set texture source rect, i.e. the parts we want to render from the texture.
 		// to render the entire texture call (0, 0, textureSize.x, textureSize.y), or reset_source_rect()
 		NESSENGINE_API void set_source_rect(const Rectangle& srcRect);
 		NESSENGINE_API inline const Rectangle& get_source_rect() const {return m_source_rect;}
 
+		// check if this sprite is really visible (also take the texture size if it just finished loading in the background)
+		NESSENGINE_API virtual bool is_really_visible(const CameraApiPtr& camera);
+
 		// return the texture this sprite uses
 		NESSENGINE_API inline const ManagedResources::ManagedTexturePtr& get_texture() const {return m_texture;}
 		NESSENGINE_API inline ManagedResources::ManagedTexturePtr get_texture() {return m_texture;}
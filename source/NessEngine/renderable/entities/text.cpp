@@ -54,6 +54,7 @@ namespace Ness
 	{
 		if (m_texture)
 		{
+			m_renderer->__texture_destroyed(m_texture);
 			SDL_DestroyTexture(m_texture);
 		}
 	}
@@ -92,6 +93,7 @@ namespace Ness
 		// free previous texture if exist
 		if (m_texture)
 		{
+			m_renderer->__texture_destroyed(m_texture);
 			SDL_DestroyTexture(m_texture);
 			m_texture = nullptr;
 		}
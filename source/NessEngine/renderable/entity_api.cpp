@@ -1,4 +1,6 @@
 #include "entity_api.h"
+#include <algorithm>
+#include "../basic_types/math.h"
 
 namespace Ness
 {
@@ -7,4 +9,19 @@ namespace Ness
 		const Rectangle& rect = get_last_target_rect();
 		return (pos.x >= rect.x && pos.y >= rect.y && pos.x <= rect.x + rect.w && pos.y <= rect.y + rect.h);
 	}
+
+	bool EntityAPI::touch_rect(const Rectangle& rect) const
+	{
+		const Rectangle& target = get_last_target_rect();
+		return (target.x <= rect.x + rect.w && target.y <= rect.y + rect.h && target.x + target.w >= rect.x && target.y + target.h >= rect.y);
+	}
+
+	bool EntityAPI::touch_circle(const Pointf& center, float radius) const
+	{
+		// find the closest point in the target rect to the circle center, and check its distance
+		const Rectangle& target = get_last_target_rect();
+		float closest_x = std::max((float)target.x, std::min(center.x, (float)(target.x + target.w)));
+		float closest_y = std::max((float)target.y, std::min(center.y, (float)(target.y + target.h)));
+		return (POW2(center.x - closest_x) + POW2(center.y - closest_y)) <= POW2(radius);
+	}
 }
\ No newline at end of file
@@ -51,6 +51,12 @@ namespace Ness
 		// return if this entity touches the given point (based on last target rect)
 		NESSENGINE_API virtual bool touch_point(const Pointf& pos) const;
 
+		// return if this entity touches the given rectangle (based on last target rect)
+		NESSENGINE_API virtual bool touch_rect(const Rectangle& rect) const;
+
+		// return if this entity touches the given circle (based on last target rect)
+		NESSENGINE_API virtual bool touch_circle(const Pointf& center, float radius) const;
+
 		// set/get if this entity is static (static entities ignore camera when rendered)
 		NESSENGINE_API inline void set_static(bool IsStatic) {m_static = IsStatic;}
 		NESSENGINE_API virtual bool is_static() const {return m_static;}
@@ -22,6 +22,7 @@
 
 #pragma once
 #include "node_api.h"
+#include "entity_api.h"
 
 namespace Ness
 {
@@ -32,6 +33,29 @@ namespace Ness
 	{
 	}
 
+	Uint32 NodeAPI::__get_transformations_generation()
+	{
+		// if parent changed since last time we checked, we changed as well
+		if (m_parent)
+		{
+			Uint32 parent_generation = m_parent->__get_transformations_generation();
+			if (parent_generation != m_parent_trans_generation)
+			{
+				m_parent_trans_generation = parent_generation;
+				transformations_update();
+			}
+		}
+		return m_trans_generation;
+	}
+
+	void NodeAPI::__structure_changed()
+	{
+		for (NodeAPI* node = this; node; node = node->m_parent)
+		{
+			node->m_structure_generation++;
+		}
+	}
+
 	void NodeAPI::__add_unsafe(RenderableAPI* object)
 	{
 		add(RenderablePtr(object, EmptyEntityDeleter));
@@ -46,4 +70,48 @@ namespace Ness
 	{
 		remove(RenderablePtr(object, EmptyEntityDeleter));
 	}
+
+	void NodeAPI::select_entities_in_rect(EntitiesList& out_list, const Rectangle& rect, bool recursive)
+	{
+		for (unsigned int i = 0; i < get_sons_count(); i++)
+		{
+			RenderablePtr curr = get_son(i);
+			if (!curr->get_flag(RNF_SELECTABLE))
+				continue;
+
+			if (curr->is_node())
+			{
+				if (recursive)
+					ness_kind_cast<NodeAPI>(curr)->select_entities_in_rect(out_list, rect, recursive);
+			}
+			else
+			{
+				EntityAPI* curr_entity = ness_kind_cast<EntityAPI>(curr);
+				if (curr_entity->touch_rect(rect))
+					out_list.push_back(ness_static_ptr_cast<EntityAPI>(curr));
+			}
+		}
+	}
+
+	void NodeAPI::select_entities_in_radius(EntitiesList& out_list, const Pointf& center, float radius, bool recursive)
+	{
+		for (unsigned int i = 0; i < get_sons_count(); i++)
+		{
+			RenderablePtr curr = get_son(i);
+			if (!curr->get_flag(RNF_SELECTABLE))
+				continue;
+
+			if (curr->is_node())
+			{
+				if (recursive)
+					ness_kind_cast<NodeAPI>(curr)->select_entities_in_radius(out_list, center, radius, recursive);
+			}
+			else
+			{
+				EntityAPI* curr_entity = ness_kind_cast<EntityAPI>(curr);
+				if (curr_entity->touch_circle(center, radius))
+					out_list.push_back(ness_static_ptr_cast<EntityAPI>(curr));
+			}
+		}
+	}
 };
\ No newline at end of file
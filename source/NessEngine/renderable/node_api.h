@@ -44,12 +44,16 @@ namespace Ness
 	// the API of a node class (containing other nodes and entities)
 	class NodeAPI : public RenderableAPI
 	{
-	private:
+	protected:
+		Uint32			m_trans_generation;				// increased whenever this node transformations change (must be done by transformations_update())
+		Uint32			m_parent_trans_generation;		// the parent generation the last time we checked it
+		Uint32			m_structure_generation;			// increased whenever sons are added or removed, in this node or any node under it
+		bool			m_forward_son_updates;			// if true, __son_transformations_update() is forwarded to the parent node
 
 	public:
 
 		NESSENGINE_API NodeAPI(Renderer* renderer) : 
-		  RenderableAPI(renderer) {}
+		  RenderableAPI(renderer), m_trans_generation(1), m_parent_trans_generation(0), m_structure_generation(0), m_forward_son_updates(false) {m_kind |= RENDERABLE_KIND_NODE;}
 
 		// is this node actually visible and inside screen?
 		NESSENGINE_API virtual bool is_really_visible(const CameraApiPtr& camera) = 0;
@@ -89,6 +93,12 @@ namespace Ness
 		// note: this will return only entities that have the RNF_SELECTABLE flag enabled (default state)
 		NESSENGINE_API virtual void select_entities_from_position(EntitiesList& out_list, const Pointf& pos, bool recursive) const = 0;
 
+		// select son entities that touch a given rectangle or circle (note: entities only!)
+		// works just like select_entities_from_position(). entities are returned in the order they are drawn (back to front).
+		// the default implementation iterates all the sons, nodes with spatial index override it with faster queries.
+		NESSENGINE_API virtual void select_entities_in_rect(EntitiesList& out_list, const Rectangle& rect, bool recursive);
+		NESSENGINE_API virtual void select_entities_in_radius(EntitiesList& out_list, const Pointf& center, float radius, bool recursive);
+
 		// get a list with ALL the son entities that are currently visible in screen
 		// camera is to check visibility (which objects are in screen)
 		// break_son_nodes if true will break the son nodes as well, else, will just put
@@ -99,6 +109,35 @@ namespace Ness
 		NESSENGINE_API virtual void __get_visible_entities(RenderablesList& out_list,
 			const CameraApiPtr& camera, bool break_son_nodes = true) = 0;
 
+		// called by son entities when their transformations change.
+		// nodes that override this must call forward_son_update(), so forwarding to the parent works for every node type.
+		NESSENGINE_API virtual void __son_transformations_update(RenderableAPI* son) {forward_son_update(son);}
+
+		// called by sons when their appearance changes without changing their transformations (see appearance_update())
+		NESSENGINE_API virtual void __son_appearance_update(RenderableAPI* son) {}
+
+		// set if this node should forward the transformations updates of its sons to its parent.
+		// used by parent nodes that need to know when entities deeper in the tree change (like ZNode that break groups).
+		NESSENGINE_API inline void __set_forward_son_updates(bool forward) {m_forward_son_updates = forward;}
+
+	protected:
+		// forward a son transformations update to the parent node, if enabled (see __set_forward_son_updates())
+		inline void forward_son_update(RenderableAPI* son) {if (m_forward_son_updates && m_parent) m_parent->__son_transformations_update(son);}
+
+	public:
+
+		// return a number that changes whenever the absolute transformations of this node change (by itself or by its parents).
+		// instead of updating all the sons when a node moves, sons compare this number with the last value they saw when they
+		// are rendered or queried, and update themselves only if it changed.
+		// if the parent generation changed since last check, this will call transformations_update() on this node.
+		NESSENGINE_API virtual Uint32 __get_transformations_generation();
+
+		// return a number that changes whenever sons are added or removed, in this node or any node under it.
+		NESSENGINE_API inline Uint32 get_structure_generation() const {return m_structure_generation;}
+
+		// called when sons are added or removed from this node (increase the structure generation of this node and all its parents)
+		NESSENGINE_API void __structure_changed();
+
 		// nodes cannot be static.
 		NESSENGINE_API virtual bool is_static() const {return false;}
 
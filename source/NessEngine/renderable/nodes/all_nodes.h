@@ -24,8 +24,11 @@
 #include "node.h"
 #include "znode.h"
 #include "tile_map.h"
+#include "flat_tile_map.h"
+#include "chunked_tile_map.h"
 #include "nodes_map.h"
 #include "light_node.h"
 #include "shadow_node.h"
 #include "static_node.h"
-#include "particles_node.h"
\ No newline at end of file
+#include "particles_node.h"
+#include "particles_kernels.h"
\ No newline at end of file
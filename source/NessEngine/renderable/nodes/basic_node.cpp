@@ -29,35 +29,124 @@
 namespace Ness
 {
 
-	void BaseNode::__get_visible_entities(RenderablesList& out_list, const CameraApiPtr& camera, bool break_son_nodes)
+	void BaseNode::add_visible_son(RenderablesList& out_list, const RenderablePtr& son, const CameraApiPtr& camera, bool break_son_nodes)
 	{
-		for (unsigned int i = 0; i < m_entities.size(); i++)
+		// check if current entity is a node
+		if (son->is_node())
 		{
-			SharedPtr<RenderableAPI>& curr = m_entities[i];
-
-			// check if current entity is a node
-			if (curr->is_node())
+			if (break_son_nodes && !son->get_flag(RNF_NEVER_BREAK))
 			{
-				if (break_son_nodes && !curr->get_flag(RNF_NEVER_BREAK))
-				{
-					const SharedPtr<NodeAPI>& currentNode = ness_ptr_cast<NodeAPI>(curr);
-					currentNode->__get_visible_entities(out_list, camera, break_son_nodes);
-				}
-				else
-				{
-					out_list.push_back(curr);
-				}
+				ness_kind_cast<NodeAPI>(son)->__get_visible_entities(out_list, camera, break_son_nodes);
 			}
-			// if not a node, check if in screen and if so add it
 			else
 			{
-				if (!curr->is_really_visible(camera))
-					continue;
+				out_list.push_back(son);
+			}
+		}
+		// if not a node, check if in screen and if so add it
+		else
+		{
+			if (!son->is_really_visible(camera))
+				return;
 
-				// add to rendering list
-				out_list.push_back(curr);
+			// add to rendering list
+			out_list.push_back(son);
+		}
+	}
+
+	void BaseNode::__get_visible_entities(RenderablesList& out_list, const CameraApiPtr& camera, bool break_son_nodes)
+	{
+		// if got spatial index, only check the sons in the visible cells.
+		// collecting visible entities only goes down the tree, so the sons won't query this node again while we iterate the results.
+		if (m_spatial_index && query_visible_sons(camera))
+		{
+			for (unsigned int i = 0; i < m_spatial_results.size(); i++)
+			{
+				add_visible_son(out_list, m_spatial_results[i]->renderable, camera, break_son_nodes);
 			}
+			return;
+		}
+
+		for (unsigned int i = 0; i < m_entities.size(); i++)
+		{
+			add_visible_son(out_list, m_entities[i], camera, break_son_nodes);
+		}
+	}
+
+	void BaseNode::enable_spatial_index(const Sizei& cellSize)
+	{
+		m_spatial_index = ness_make_ptr<SpatialGrid>(cellSize);
+		rebuild_spatial_index();
+	}
+
+	void BaseNode::disable_spatial_index()
+	{
+		m_spatial_index.reset();
+		m_spatial_results.clear();
+		m_visible_sons.clear();
+	}
+
+	void BaseNode::rebuild_spatial_index()
+	{
+		if (!m_spatial_index)
+			return;
+
+		m_spatial_index->clear();
+		m_first_order = 0;
+		m_next_order = 0;
+		for (unsigned int i = 0; i < m_entities.size(); i++)
+		{
+			m_spatial_index->insert(m_entities[i], m_next_order++);
+		}
+	}
+
+	void BaseNode::__son_transformations_update(RenderableAPI* son)
+	{
+		if (m_spatial_index)
+			m_spatial_index->mark_dirty(son);
+		forward_son_update(son);
+	}
+
+	bool BaseNode::query_visible_sons(const CameraApiPtr& camera)
+	{
+		// the region the camera sees
+		Rectangle region;
+		if (!camera->get_visible_region(region))
+			return false;
+
+		query_spatial_index(region);
+		return true;
+	}
+
+	Containers::Vector<RenderableAPI*>* BaseNode::acquire_visible_sons(const CameraApiPtr& camera)
+	{
+		if (!query_visible_sons(camera))
+			return nullptr;
+
+		// get the buffer of the current depth (sons are kept alive by m_entities, so raw pointers are enough)
+		if (m_visible_sons.size() <= m_visible_sons_depth)
+			m_visible_sons.resize(m_visible_sons_depth + 1);
+		Containers::Vector<RenderableAPI*>& sons = m_visible_sons[m_visible_sons_depth++];
+		sons.clear();
+		for (unsigned int i = 0; i < m_spatial_results.size(); i++)
+		{
+			sons.push_back(m_spatial_results[i]->renderable.get());
 		}
+		return &sons;
+	}
+
+	void BaseNode::query_spatial_index(const Rectangle& region)
+	{
+		// if this node (or its parents) moved, all the sons moved with it
+		Uint32 generation = __get_transformations_generation();
+		if (generation != m_spatial_generation)
+		{
+			m_spatial_generation = generation;
+			m_spatial_index->mark_all_dirty();
+		}
+
+		m_spatial_results.clear();
+		m_spatial_index->query(region, m_spatial_results);
 	}
 
 	bool BaseNode::was_rendered_this_frame() const
@@ -67,7 +156,9 @@ namespace Ness
 
 	bool BaseNode::was_updated_this_frame() const
 	{
-		return m_renderer->get_frameid() == m_last_update_frame_id;
+		// also check if parent changed and we didn't notice yet
+		return (m_renderer->get_frameid() == m_last_update_frame_id) || 
+			(m_parent && m_parent->__get_transformations_generation() != m_parent_trans_generation);
 	}
 
 	void BaseNode::destroy()
@@ -82,14 +173,48 @@ namespace Ness
 			m_entities[i]->__change_parent(nullptr);
 		}
 		m_entities.clear();
+		if (m_spatial_index)
+			m_spatial_index->clear();
+		sons_changed();
 	}
 
 	void BaseNode::select_entities_from_position(EntitiesList& out_list, const Pointf& pos, bool recursive) const
 	{
-		for (unsigned int i = 0; i < m_entities.size(); i++)
+		Rectangle bounds((int)floor(pos.x), (int)floor(pos.y), 1, 1);
+		((BaseNode*)(this))->select_sons(out_list, SELECT_POINT, pos, bounds, 0.0f, recursive);
+	}
+
+	void BaseNode::select_entities_in_rect(EntitiesList& out_list, const Rectangle& rect, bool recursive)
+	{
+		select_sons(out_list, SELECT_RECT, Pointf(), rect, 0.0f, recursive);
+	}
+
+	void BaseNode::select_entities_in_radius(EntitiesList& out_list, const Pointf& center, float radius, bool recursive)
+	{
+		Rectangle bounds((int)floor(center.x - radius), (int)floor(center.y - radius), (int)ceil(radius * 2) + 1, (int)ceil(radius * 2) + 1);
+		select_sons(out_list, SELECT_CIRCLE, center, bounds, radius, recursive);
+	}
+
+	void BaseNode::select_sons(EntitiesList& out_list, ESelectionShape shape, const Pointf& point, const Rectangle& rect, float radius, bool recursive)
+	{
+		// get the sons to test. if got spatial index, only the sons in the cells the shape touches
+		RenderablesList query_results;
+		if (m_spatial_index)
+		{
+			// note: region is one pixel larger on every side since touch tests include the edges
+			Rectangle region(rect.x - 1, rect.y - 1, rect.w + 2, rect.h + 2);
+			query_spatial_index(region);
+			for (unsigned int i = 0; i < m_spatial_results.size(); i++)
+			{
+				query_results.push_back(m_spatial_results[i]->renderable);
+			}
+		}
+		const RenderablesList& sons = m_spatial_index ? query_results : m_entities;
+
+		for (unsigned int i = 0; i < sons.size(); i++)
 		{
 			// get current son
-			const SharedPtr<RenderableAPI>& curr = m_entities[i];
+			const RenderablePtr& curr = sons[i];
 
 			// if not selectable skip
 			if (!curr->get_flag(RNF_SELECTABLE))
@@ -100,16 +225,40 @@ namespace Ness
 			{
 				if (recursive)
 				{
-					const SharedPtr<NodeAPI>& currentNode = ness_ptr_cast<NodeAPI>(curr);
-					currentNode->select_entities_from_position(out_list, pos, recursive);
+					NodeAPI* currentNode = ness_kind_cast<NodeAPI>(curr);
+					switch (shape)
+					{
+					case SELECT_POINT:
+						currentNode->select_entities_from_position(out_list, point, recursive);
+						break;
+					case SELECT_RECT:
+						currentNode->select_entities_in_rect(out_list, rect, recursive);
+						break;
+					case SELECT_CIRCLE:
+						currentNode->select_entities_in_radius(out_list, point, radius, recursive);
+						break;
+					}
 				}
 			}
-			// if not a node, check if touches position and if so add it to the list
+			// if not a node, check if touches the shape and if so add it to the list
 			else
 			{
-				const SharedPtr<EntityAPI>& curr_entity = ness_ptr_cast<EntityAPI>(m_entities[i]);
-				if (curr_entity->touch_point(pos))
-					out_list.push_back(curr_entity);
+				EntityAPI* curr_entity = ness_kind_cast<EntityAPI>(curr);
+				bool touch = false;
+				switch (shape)
+				{
+				case SELECT_POINT:
+					touch = curr_entity->touch_point(point);
+					break;
+				case SELECT_RECT:
+					touch = curr_entity->touch_rect(rect);
+					break;
+				case SELECT_CIRCLE:
+					touch = curr_entity->touch_circle(point, radius);
+					break;
+				}
+				if (touch)
+					out_list.push_back(ness_static_ptr_cast<EntityAPI>(curr));
 			}
 		}
 	}
@@ -123,8 +272,7 @@ namespace Ness
 			{
 				if (m_entities[i]->is_node())
 				{
-					SharedPtr<NodeAPI> currentNode = ness_ptr_cast<NodeAPI>(m_entities[i]);
-					currentNode->__get_all_entities(out_list, breakGroups);
+					ness_kind_cast<NodeAPI>(m_entities[i])->__get_all_entities(out_list, breakGroups);
 				}
 				else
 				{
@@ -143,18 +291,27 @@ namespace Ness
 	{
 		m_entities.push_back(object);
 		object->__change_parent(this);
+		if (m_spatial_index)
+			m_spatial_index->insert(object, m_next_order++);
+		sons_changed();
 	}
 
 	void BaseNode::add_first(const RenderablePtr& object)
 	{
 		m_entities.insert(m_entities.begin(), object);
 		object->__change_parent(this);
+		if (m_spatial_index)
+			m_spatial_index->insert(object, --m_first_order);
+		sons_changed();
 	}
 
 	void BaseNode::remove(const RenderablePtr& object)
 	{
 		object->__change_parent(nullptr);
+		if (m_spatial_index)
+			m_spatial_index->remove(object.get());
 		m_entities.erase(std::remove(m_entities.begin(), m_entities.end(), object), m_entities.end());
+		sons_changed();
 	}
 
 	bool BaseNode::is_really_visible(const CameraApiPtr& camera)
@@ -163,6 +320,19 @@ namespace Ness
 		if (!m_visible || get_absolute_transformations_const().color.a <= 0)
 			return false;
 
+		// if got spatial index, only check the sons in the visible cells
+		Containers::Vector<RenderableAPI*>* sons = m_spatial_index ? acquire_visible_sons(camera) : nullptr;
+		if (sons)
+		{
+			bool visible = false;
+			for (unsigned int i = 0; i < sons->size() && !visible; i++)
+			{
+				visible = (*sons)[i]->is_really_visible(camera);
+			}
+			release_visible_sons();
+			return visible;
+		}
+
 		// check all sprites
 		for (unsigned int i = 0; i < m_entities.size(); i++)
 		{
@@ -176,6 +346,8 @@ namespace Ness
 
 	const SRenderTransformations& BaseNode::get_absolute_transformations()
 	{
+		// check if parents changed
+		__get_transformations_generation();
 
 		// if need to update transformations from parent, do it
 		if (m_need_trans_update)
@@ -192,6 +364,26 @@ namespace Ness
 		return m_absolute_trans;
 	}
 
+	Uint32 BaseNode::__update_flat_transformations(const SRenderTransformations& parent_trans, Uint32 parent_generation)
+	{
+		// check if parent changed
+		if (parent_generation != m_parent_trans_generation)
+		{
+			m_parent_trans_generation = parent_generation;
+			transformations_update();
+		}
+
+		// update cache if needed
+		if (m_need_trans_update)
+		{
+			m_absolute_trans = m_transformations;
+			m_absolute_trans.add_transformations(parent_trans);
+			m_need_trans_update = false;
+		}
+
+		return m_trans_generation;
+	}
+
 	void BaseNode::set_render_target(const ManagedResources::ManagedTexturePtr& NewTarget)
 	{
 		m_render_target = NewTarget;
@@ -215,14 +407,9 @@ namespace Ness
 	{
 		m_need_trans_update = true;
 		m_last_update_frame_id = m_renderer->get_frameid();
-		for (unsigned int i = 0; i < m_entities.size(); i++)
-		{
-			Transformable* current = dynamic_cast<Transformable*>(m_entities[i].get());
-			if (current)
-			{
-				current->transformations_update();
-			}
-		}
+		m_trans_generation++;
+		if (m_parent)
+			m_parent->__son_transformations_update(this);
 	}
 
 	RenderablePtr BaseNode::get_son(const String& name)
@@ -256,9 +443,22 @@ namespace Ness
 		m_last_render_frame_id = m_renderer->get_frameid();
 
 		// render all son entities
-		for (unsigned int i = 0; i < m_entities.size(); i++)
+		// if got spatial index, only render the sons in the visible cells
+		Containers::Vector<RenderableAPI*>* sons = m_spatial_index ? acquire_visible_sons(camera) : nullptr;
+		if (sons)
 		{
-			m_entities[i]->render(camera);
+			for (unsigned int i = 0; i < sons->size(); i++)
+			{
+				(*sons)[i]->render(camera);
+			}
+			release_visible_sons();
+		}
+		else
+		{
+			for (unsigned int i = 0; i < m_entities.size(); i++)
+			{
+				m_entities[i]->render(camera);
+			}
 		}
 
 		// remove target texture
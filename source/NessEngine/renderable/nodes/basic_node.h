@@ -31,6 +31,7 @@
 #include "../node_api.h"
 #include "../transformable_api.h"
 #include "../../basic_types/containers.h"
+#include "spatial_grid.h"
 
 namespace Ness
 {
@@ -49,10 +50,17 @@ namespace Ness
 		ManagedResources::ManagedTexturePtr		m_render_target;				// if not null, will render to this target instead of to the screen
 		unsigned int							m_last_render_frame_id;			// return the frame id of the last time this entity was really rendered
 		unsigned int							m_last_update_frame_id;			// return the frame id of the last time this entity was updated
+		SpatialGridPtr							m_spatial_index;				// optional spatial index of the son entities, used for culling
+		int										m_first_order;					// order given to the last son added with add_first() (for the spatial index)
+		int										m_next_order;					// order to give the next son added with add() (for the spatial index)
+		Containers::Vector<const SSpatialGridItem*>	m_spatial_results;			// results of the last spatial index query
+		Uint32									m_spatial_generation;			// transformations generation the spatial index was last updated with
+		Containers::Vector<Containers::Vector<RenderableAPI*> >	m_visible_sons;	// reusable buffers of visible sons, by recursion depth (see acquire_visible_sons())
+		unsigned int							m_visible_sons_depth;			// how many visible sons buffers are currently in use
 
 	public:
 		NESSENGINE_API BaseNode(Renderer* renderer) : 
-			NodeAPI(renderer), m_need_trans_update(true), m_last_render_frame_id(0), m_last_update_frame_id(0) {}
+			NodeAPI(renderer), m_need_trans_update(true), m_last_render_frame_id(0), m_last_update_frame_id(0), m_first_order(0), m_next_order(0), m_spatial_generation(0), m_visible_sons_depth(0) {m_kind |= RENDERABLE_KIND_BASE_NODE;}
 
 		NESSENGINE_API ~BaseNode() { destroy(); }
 
@@ -83,9 +91,27 @@ namespace Ness
 		// if there are multiple sons with the same name, will return the first one found.
 		NESSENGINE_API virtual RenderablePtr get_son(const String& name);
 
-		// called whenever transformations are updated
+		// called whenever transformations are updated.
+		// note: this does not update the sons, they will check our transformations generation when they need to.
 		NESSENGINE_API virtual void transformations_update();
 
+		// enable spatial index for this node.
+		// when enabled, son entities are kept in a uniform grid based on their target rectangle, and rendering and culling only
+		// test the entities in the grid cells the camera sees. use this for nodes with many entities scattered around the level.
+		// son nodes and static entities are not indexed and are always tested.
+		// note: the index assumes the camera only translates the scene (like BasicCamera). if you use a custom camera that zoom
+		// or distort the scene, don't use the spatial index.
+		NESSENGINE_API void enable_spatial_index(const Sizei& cellSize = Sizei(256, 256));
+
+		// disable the spatial index
+		NESSENGINE_API void disable_spatial_index();
+
+		// return the spatial index (or empty pointer if disabled)
+		NESSENGINE_API inline const SpatialGridPtr& get_spatial_index() const {return m_spatial_index;}
+
+		// called by son entities when their transformations change (update the spatial index)
+		NESSENGINE_API virtual void __son_transformations_update(RenderableAPI* son);
+
 		// get absolute transformations for this renderable node
 		NESSENGINE_API virtual const SRenderTransformations& get_absolute_transformations();
 		NESSENGINE_API virtual const SRenderTransformations& get_absolute_transformations_const() const {return m_absolute_trans;}
@@ -117,15 +143,64 @@ namespace Ness
 		// see NodeAPI doc for more info.
 		NESSENGINE_API virtual void select_entities_from_position(EntitiesList& out_list, const Pointf& pos, bool recursive) const;
 
+		// select son entities that touch a rectangle or a circle.
+		// if spatial index is enabled, only the sons in the relevant cells are tested.
+		NESSENGINE_API virtual void select_entities_in_rect(EntitiesList& out_list, const Rectangle& rect, bool recursive);
+		NESSENGINE_API virtual void select_entities_in_radius(EntitiesList& out_list, const Pointf& center, float radius, bool recursive);
+
 		// return if need transformations udpate
 		NESSENGINE_API virtual bool need_transformations_update() {return m_need_trans_update;}
 
+		// used by the scene flattened transformations pass (see Scene::set_flat_transformations()).
+		// update the transformations cache from parent absolute transformations and generation that were already calculated,
+		// and return this node transformations generation.
+		NESSENGINE_API Uint32 __update_flat_transformations(const SRenderTransformations& parent_trans, Uint32 parent_generation);
+
+		// return if the sons of this node can be part of the scene flattened transformations.
+		// nodes that add and remove sons all the time, or that their sons calculate transformations differently, should return false.
+		NESSENGINE_API virtual bool __flatten_sons() const {return true;}
+
 		// render this node with camera
 		NESSENGINE_API virtual void render(const CameraApiPtr& camera);
 
 		// render this node without camera
 		NESSENGINE_API virtual void render();
 
+	protected:
+		// rebuild the spatial index from the current son entities (if enabled)
+		NESSENGINE_API void rebuild_spatial_index();
+
+		// query the spatial index (must be enabled!) for the sons that may be visible with the given camera, into m_spatial_results.
+		// return false if the camera can't tell which region it sees (all sons should be tested).
+		// note: the next query of this node overrides the results, so only iterate them directly if the sons can't query this node again.
+		NESSENGINE_API bool query_visible_sons(const CameraApiPtr& camera);
+
+		// same as query_visible_sons(), but copy the sons into a reusable buffer of the current recursion depth and return it (or null if
+		// the camera can't tell which region it sees). use this when calling the sons may query this node again, like when rendering them.
+		// must call release_visible_sons() when done with the returned buffer.
+		NESSENGINE_API Containers::Vector<RenderableAPI*>* acquire_visible_sons(const CameraApiPtr& camera);
+		NESSENGINE_API inline void release_visible_sons() {m_visible_sons_depth--;}
+
+	private:
+		// the shape to select entities with
+		enum ESelectionShape
+		{
+			SELECT_POINT,
+			SELECT_RECT,
+			SELECT_CIRCLE,
+		};
+
+		// select son entities that touch a shape. rect is the bounding box of the shape.
+		void select_sons(EntitiesList& out_list, ESelectionShape shape, const Pointf& point, const Rectangle& rect, float radius, bool recursive);
+
+		// query the spatial index (mark all the sons dirty first if this node moved since last query)
+		void query_spatial_index(const Rectangle& region);
+
+		// called when sons are added or removed from this node
+		inline void sons_changed() {if (__flatten_sons()) __structure_changed();}
+
+		// add a son to visible entities list if its visible
+		void add_visible_son(RenderablesList& out_list, const RenderablePtr& son, const CameraApiPtr& camera, bool break_son_nodes);
 	};
 
 	NESSENGINE_API typedef SharedPtr<BaseNode> BaseNodePtr;
@@ -0,0 +1,482 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+#include "../../renderer/renderer.h"
+#include "../../exceptions/log.h"
+#include "chunked_tile_map.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Ness
+{
+	// chunks file header magic and version
+	static const char* CHUNKS_FILE_MAGIC = "NCHK";
+	static const Uint32 CHUNKS_FILE_VERSION = 1;
+	static const Sint64 CHUNKS_FILE_HEADER_SIZE = 4 + 4 + 4 * 4;
+	static const Sint64 CHUNKS_FILE_TILE_SIZE = 2 + 1 + 4;
+
+	TileChunksFile::TileChunksFile(const String& file_name) : m_file_name(file_name)
+	{
+		SDL_RWops* file = SDL_RWFromFile(file_name.c_str(), "rb");
+		if (file == nullptr)
+		{
+			throw FileNotFound(file_name.c_str());
+		}
+
+		// read and validate header
+		char magic[4];
+		if (SDL_RWread(file, magic, 1, 4) != 4 || memcmp(magic, CHUNKS_FILE_MAGIC, 4) != 0 || SDL_ReadLE32(file) != CHUNKS_FILE_VERSION)
+		{
+			SDL_RWclose(file);
+			throw WrongFormatError(("Invalid tile chunks file: " + file_name).c_str());
+		}
+		m_map_size.x = (int)SDL_ReadLE32(file);
+		m_map_size.y = (int)SDL_ReadLE32(file);
+		m_chunk_size.x = (int)SDL_ReadLE32(file);
+		m_chunk_size.y = (int)SDL_ReadLE32(file);
+		SDL_RWclose(file);
+
+		if (m_chunk_size.x <= 0 || m_chunk_size.y <= 0 || m_map_size.x <= 0 || m_map_size.y <= 0)
+		{
+			throw WrongFormatError(("Invalid tile chunks file size: " + file_name).c_str());
+		}
+	}
+
+	bool TileChunksFile::load_chunk(const Pointi& chunk, const Sizei& chunk_size, STileData* out_tiles)
+	{
+		// make sure the requested chunk size match the file
+		if (chunk_size != m_chunk_size)
+			return false;
+
+		// open the file (every load opens its own handle, so it's safe to load from multiple threads)
+		SDL_RWops* file = SDL_RWFromFile(m_file_name.c_str(), "rb");
+		if (file == nullptr)
+			return false;
+
+		// seek to chunk position
+		int chunks_in_row = (m_map_size.x + m_chunk_size.x - 1) / m_chunk_size.x;
+		Sint64 tiles_in_chunk = m_chunk_size.x * m_chunk_size.y;
+		Sint64 chunk_id = chunk.x + (Sint64)chunk.y * chunks_in_row;
+		if (SDL_RWseek(file, CHUNKS_FILE_HEADER_SIZE + chunk_id * tiles_in_chunk * CHUNKS_FILE_TILE_SIZE, RW_SEEK_SET) < 0)
+		{
+			SDL_RWclose(file);
+			return false;
+		}
+
+		// read all the chunk data at once and parse it
+		Containers::Vector<Uint8> buffer;
+		buffer.resize((size_t)(tiles_in_chunk * CHUNKS_FILE_TILE_SIZE));
+		size_t read = SDL_RWread(file, &buffer[0], 1, buffer.size());
+		SDL_RWclose(file);
+		if (read != buffer.size())
+			return false;
+
+		const Uint8* data = &buffer[0];
+		for (Sint64 i = 0; i < tiles_in_chunk; ++i)
+		{
+			STileData& tile = out_tiles[i];
+			tile.source = (unsigned short)(data[0] | (data[1] << 8));
+			tile.flags = data[2] & ~TILE_FLAG_CUSTOM;
+			tile.color = Colorb(data[3], data[4], data[5], data[6]);
+			data += CHUNKS_FILE_TILE_SIZE;
+		}
+		return true;
+	}
+
+	void TileChunksFile::write_file(const String& file_name, FlatTileMap& map, const Sizei& chunk_size)
+	{
+		SDL_RWops* file = SDL_RWFromFile(file_name.c_str(), "wb");
+		if (file == nullptr)
+		{
+			throw IllegalAction(("Cannot open file for writing: " + file_name).c_str());
+		}
+
+		// write header
+		SDL_RWwrite(file, CHUNKS_FILE_MAGIC, 1, 4);
+		SDL_WriteLE32(file, CHUNKS_FILE_VERSION);
+		SDL_WriteLE32(file, (Uint32)map.get_map_size().x);
+		SDL_WriteLE32(file, (Uint32)map.get_map_size().y);
+		SDL_WriteLE32(file, (Uint32)chunk_size.x);
+		SDL_WriteLE32(file, (Uint32)chunk_size.y);
+
+		// write all chunks
+		Sizei chunks_count((map.get_map_size().x + chunk_size.x - 1) / chunk_size.x, (map.get_map_size().y + chunk_size.y - 1) / chunk_size.y);
+		Containers::Vector<Uint8> buffer;
+		buffer.resize((size_t)(chunk_size.x * chunk_size.y * CHUNKS_FILE_TILE_SIZE));
+		for (int cy = 0; cy < chunks_count.y; ++cy)
+		{
+			for (int cx = 0; cx < chunks_count.x; ++cx)
+			{
+				Uint8* data = &buffer[0];
+				Pointi index;
+				for (int j = 0; j < chunk_size.y; ++j)
+				{
+					for (int i = 0; i < chunk_size.x; ++i)
+					{
+						index.x = cx * chunk_size.x + i;
+						index.y = cy * chunk_size.y + j;
+
+						// tiles outside the map are hidden
+						if (index.x >= map.get_map_size().x || index.y >= map.get_map_size().y)
+						{
+							memset(data, 0, (size_t)CHUNKS_FILE_TILE_SIZE);
+							data[2] = TILE_FLAG_HIDDEN;
+						}
+						else
+						{
+							const STileData& tile = map.get_tile(index);
+							data[0] = (Uint8)(tile.source & 0xff);
+							data[1] = (Uint8)(tile.source >> 8);
+							data[2] = tile.flags & ~TILE_FLAG_CUSTOM;
+							data[3] = tile.color.r; data[4] = tile.color.g; data[5] = tile.color.b; data[6] = tile.color.a;
+						}
+						data += CHUNKS_FILE_TILE_SIZE;
+					}
+				}
+				SDL_RWwrite(file, &buffer[0], 1, buffer.size());
+			}
+		}
+
+		SDL_RWclose(file);
+	}
+
+	// a background task that loads a single chunk
+	class LoadTilesChunkTask : public Utils::WorkerTask
+	{
+	private:
+		ChunkedTileMap*				m_map;
+		TileChunksProviderPtr		m_provider;
+		unsigned int				m_id;
+		Pointi						m_chunk;
+		Sizei						m_chunk_size;
+
+	public:
+		LoadTilesChunkTask(ChunkedTileMap* map, const TileChunksProviderPtr& provider, unsigned int id, const Pointi& chunk, const Sizei& chunk_size) :
+			m_map(map), m_provider(provider), m_id(id), m_chunk(chunk), m_chunk_size(chunk_size) {}
+
+		virtual void execute()
+		{
+			Containers::Vector<STileData> tiles;
+			tiles.resize(m_chunk_size.x * m_chunk_size.y);
+			bool success = m_provider->load_chunk(m_chunk, m_chunk_size, &tiles[0]);
+			m_map->__on_chunk_loaded(m_id, success, tiles);
+		}
+	};
+
+	ChunkedTileMap::ChunkedTileMap(Renderer* renderer, const String& spriteFile, const TileChunksProviderPtr& provider, const Sizei& mapSize, 
+			const Sizei& chunkSize, const Size& singleTileSize, const Size& tilesDistance, unsigned int loadingThreads) :
+		FlatTileMap(renderer, spriteFile, singleTileSize, tilesDistance), m_provider(provider), m_chunk_size(chunkSize), 
+			m_prefetch_margin(1), m_memory_budget(16 * 1024 * 1024), m_resident_bytes(0), m_workers(loadingThreads)
+	{
+		m_size = mapSize;
+		m_chunks_count.x = (mapSize.x + chunkSize.x - 1) / chunkSize.x;
+		m_chunks_count.y = (mapSize.y + chunkSize.y - 1) / chunkSize.y;
+		m_loaded_mutex = SDL_CreateMutex();
+	}
+
+	ChunkedTileMap::~ChunkedTileMap()
+	{
+		destroy();
+		SDL_DestroyMutex(m_loaded_mutex);
+	}
+
+	void ChunkedTileMap::destroy()
+	{
+		// stop the loading workers first, so no one will touch this tilemap from now on
+		m_workers.stop();
+		m_chunks.clear();
+		m_loading.clear();
+		m_failed.clear();
+		m_loaded.clear();
+		m_resident_bytes = 0;
+		FlatTileMap::destroy();
+	}
+
+	void ChunkedTileMap::__on_chunk_loaded(unsigned int id, bool success, Containers::Vector<STileData>& tiles)
+	{
+		SDL_LockMutex(m_loaded_mutex);
+		m_loaded.push_back(SLoadedTilesChunk());
+		SLoadedTilesChunk& loaded = m_loaded.back();
+		loaded.id = id;
+		loaded.success = success;
+		loaded.tiles.swap(tiles);
+		SDL_UnlockMutex(m_loaded_mutex);
+	}
+
+	void ChunkedTileMap::integrate_loaded_chunks()
+	{
+		// take the loaded chunks list
+		SDL_LockMutex(m_loaded_mutex);
+		m_loaded_swap.swap(m_loaded);
+		SDL_UnlockMutex(m_loaded_mutex);
+
+		// add the chunks
+		for (auto loaded = m_loaded_swap.begin(); loaded != m_loaded_swap.end(); ++loaded)
+		{
+			m_loading.erase(loaded->id);
+
+			// if failed, don't add it (so it won't be rendered) and try again later
+			if (!loaded->success)
+			{
+				NESS_ERROR(("failed to load tiles chunk " + ness_to_string((long long)loaded->id)).c_str());
+				m_failed[loaded->id] = m_renderer->get_frameid() + NESS_CHUNK_RETRY_FRAMES;
+				continue;
+			}
+
+			// hide tiles with invalid source index (the chunk data comes from the provider and may not match the source rects)
+			unsigned int invalid_tiles = 0;
+			for (auto tile = loaded->tiles.begin(); tile != loaded->tiles.end(); ++tile)
+			{
+				if (tile->source >= m_sources.size())
+				{
+					tile->source = 0;
+					tile->flags |= TILE_FLAG_HIDDEN;
+					invalid_tiles++;
+				}
+			}
+			if (invalid_tiles > 0)
+			{
+				NESS_ERROR(("tiles chunk " + ness_to_string((long long)loaded->id) + " has " + ness_int_to_string(invalid_tiles) + 
+					" tiles with invalid source index, hiding them").c_str());
+			}
+
+			STilesChunk& chunk = m_chunks[loaded->id];
+			chunk.last_used_frame = m_renderer->get_frameid();
+			chunk.tiles.swap(loaded->tiles);
+			m_resident_bytes += (unsigned int)(chunk.tiles.size() * sizeof(STileData));
+		}
+		m_loaded_swap.clear();
+	}
+
+	void ChunkedTileMap::request_chunk(int cx, int cy)
+	{
+		unsigned int id = get_chunk_id(cx, cy);
+
+		// already loaded? mark as used
+		auto chunk = m_chunks.find(id);
+		if (chunk != m_chunks.end())
+		{
+			chunk->second.last_used_frame = m_renderer->get_frameid();
+			return;
+		}
+
+		// already loading?
+		if (m_loading.find(id) != m_loading.end())
+			return;
+
+		// failed to load recently? wait before trying again
+		auto failed = m_failed.find(id);
+		if (failed != m_failed.end())
+		{
+			if (m_renderer->get_frameid() < failed->second)
+				return;
+			m_failed.erase(failed);
+		}
+
+		// request loading
+		m_loading[id] = true;
+		m_workers.push_task(ness_make_ptr<LoadTilesChunkTask>(this, m_provider, id, Pointi(cx, cy), m_chunk_size));
+	}
+
+	Rectangle ChunkedTileMap::update_chunks(const CameraApiPtr& camera, const Rectangle& tiles_range)
+	{
+		// get visible chunks range (inclusive)
+		Rectangle chunks;
+		chunks.x = tiles_range.x / m_chunk_size.x;
+		chunks.y = tiles_range.y / m_chunk_size.y;
+		chunks.w = (tiles_range.w - 1) / m_chunk_size.x;
+		chunks.h = (tiles_range.h - 1) / m_chunk_size.y;
+
+		// request visible chunks first, so they will be loaded before the prefetched chunks
+		for (int cy = chunks.y; cy <= chunks.h; ++cy)
+		{
+			for (int cx = chunks.x; cx <= chunks.w; ++cx)
+			{
+				request_chunk(cx, cy);
+			}
+		}
+
+		// request the chunks in prefetch margin
+		int margin = (int)m_prefetch_margin;
+		int first_x = std::max(chunks.x - margin, 0);
+		int first_y = std::max(chunks.y - margin, 0);
+		int last_x = std::min(chunks.w + margin, m_chunks_count.x - 1);
+		int last_y = std::min(chunks.h + margin, m_chunks_count.y - 1);
+		for (int cy = first_y; cy <= last_y; ++cy)
+		{
+			for (int cx = first_x; cx <= last_x; ++cx)
+			{
+				if (cx < chunks.x || cx > chunks.w || cy < chunks.y || cy > chunks.h)
+					request_chunk(cx, cy);
+			}
+		}
+
+		return chunks;
+	}
+
+	void ChunkedTileMap::evict_chunks()
+	{
+		unsigned int frame = m_renderer->get_frameid();
+		while (m_resident_bytes > m_memory_budget)
+		{
+			// find least recently used chunk that was not needed this frame
+			auto lru = m_chunks.end();
+			for (auto chunk = m_chunks.begin(); chunk != m_chunks.end(); ++chunk)
+			{
+				if (chunk->second.last_used_frame != frame && (lru == m_chunks.end() || chunk->second.last_used_frame < lru->second.last_used_frame))
+					lru = chunk;
+			}
+
+			// all chunks are needed
+			if (lru == m_chunks.end())
+				return;
+
+			// unload it
+			m_resident_bytes -= (unsigned int)(lru->second.tiles.size() * sizeof(STileData));
+			m_chunks.erase(lru);
+		}
+	}
+
+	void ChunkedTileMap::load_chunks_now(const CameraApiPtr& camera)
+	{
+		Rectangle range = get_tiles_in_screen(camera);
+		if (range.x == range.w || range.y == range.h)
+			return;
+		update_chunks(camera, range);
+		m_workers.wait_all();
+		integrate_loaded_chunks();
+	}
+
+	bool ChunkedTileMap::is_tile_loaded(const Pointi& index) const
+	{
+		auto chunk = m_chunks.find(get_chunk_id(index.x / m_chunk_size.x, index.y / m_chunk_size.y));
+		return (chunk != m_chunks.end() && !chunk->second.tiles.empty());
+	}
+
+	STileData& ChunkedTileMap::get_tile(const Pointi& index)
+	{
+		auto chunk = m_chunks.find(get_chunk_id(index.x / m_chunk_size.x, index.y / m_chunk_size.y));
+		if (chunk == m_chunks.end() || chunk->second.tiles.empty())
+		{
+			throw IllegalAction("Tried to access a tile in a chunk that is not loaded!");
+		}
+		return chunk->second.tiles[(index.x % m_chunk_size.x) + (index.y % m_chunk_size.y) * m_chunk_size.x];
+	}
+
+	void ChunkedTileMap::set_all_tiles_type(unsigned short source)
+	{
+		validate_source(source);
+		for (auto chunk = m_chunks.begin(); chunk != m_chunks.end(); ++chunk)
+		{
+			for (auto tile = chunk->second.tiles.begin(); tile != chunk->second.tiles.end(); ++tile)
+			{
+				tile->source = source;
+			}
+		}
+	}
+
+	void ChunkedTileMap::apply_to_all(TExecuteOnTilesData func)
+	{
+		for (auto chunk = m_chunks.begin(); chunk != m_chunks.end(); ++chunk)
+		{
+			if (chunk->second.tiles.empty())
+				continue;
+
+			Pointi base((chunk->first % m_chunks_count.x) * m_chunk_size.x, (chunk->first / m_chunks_count.x) * m_chunk_size.y);
+			Pointi index;
+			for (int j = 0; j < m_chunk_size.y; ++j)
+			{
+				for (int i = 0; i < m_chunk_size.x; ++i)
+				{
+					index.x = base.x + i;
+					index.y = base.y + j;
+					if (index.x < m_size.x && index.y < m_size.y)
+						func(index, chunk->second.tiles[i + j * m_chunk_size.x]);
+				}
+			}
+		}
+	}
+
+	void ChunkedTileMap::render(const CameraApiPtr& camera)
+	{
+		// add chunks that finished loading
+		integrate_loaded_chunks();
+
+		// if invisible skip
+		if (!m_visible)
+			return;
+
+		Rectangle range = get_tiles_in_screen(camera);
+		if (range.x == range.w || range.y == range.h)
+			return;
+
+		// request chunks around camera and unload chunks we no longer need
+		Rectangle chunks = update_chunks(camera, range);
+		evict_chunks();
+
+		// get absolute transformations and tile size after scale
+		const SRenderTransformations& trans = get_absolute_transformations();
+		if (trans.color.a <= 0.0f)
+			return;
+		Sizei tile_size((int)ceil(m_tile_size.x * trans.scale.x), (int)ceil(m_tile_size.y * trans.scale.y));
+
+		// lastly rendered
+		m_last_render_frame_id = m_renderer->get_frameid();
+
+		// get the visible chunks (null for chunks that are not loaded yet)
+		int chunks_in_row = chunks.w - chunks.x + 1;
+		m_visible_chunks.clear();
+		for (int cy = chunks.y; cy <= chunks.h; ++cy)
+		{
+			for (int cx = chunks.x; cx <= chunks.w; ++cx)
+			{
+				auto chunk = m_chunks.find(get_chunk_id(cx, cy));
+				m_visible_chunks.push_back((chunk != m_chunks.end() && !chunk->second.tiles.empty()) ? &chunk->second : nullptr);
+			}
+		}
+
+		// render all visible tiles, row by row
+		Pointi index;
+		for (index.y = range.y; index.y < range.h; index.y++)
+		{
+			int cy = index.y / m_chunk_size.y;
+			int row_in_chunk = index.y % m_chunk_size.y;
+			for (int cx = chunks.x; cx <= chunks.w; ++cx)
+			{
+				// skip chunks that are not loaded yet
+				const STilesChunk* chunk = m_visible_chunks[(cx - chunks.x) + (cy - chunks.y) * chunks_in_row];
+				if (chunk == nullptr)
+					continue;
+
+				// render the part of this row inside this chunk
+				int chunk_start = cx * m_chunk_size.x;
+				int first = std::max(range.x, chunk_start);
+				int last = std::min(range.w, chunk_start + m_chunk_size.x);
+				const STileData* row = &chunk->tiles[row_in_chunk * m_chunk_size.x];
+				for (index.x = first; index.x < last; index.x++)
+				{
+					render_tile(camera, index, row[index.x - chunk_start], trans, tile_size);
+				}
+			}
+		}
+	}
+};
@@ -0,0 +1,211 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+/**
+* A flat tilemap that is split into chunks, that are loaded in the background when getting close to the camera
+* and unloaded when far away. use this for worlds that are too big to hold in memory.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include "flat_tile_map.h"
+#include "../../utils/threads/workers_pool.h"
+
+// how many frames to wait before trying again to load a chunk that failed to load
+#define NESS_CHUNK_RETRY_FRAMES 60
+
+namespace Ness
+{
+	/**
+	* provide tile chunks data to a chunked tilemap.
+	* inherit from this class to load chunks from your own source (file, network, procedural generation...)
+	*/
+	class TileChunksProvider
+	{
+	public:
+		NESSENGINE_API virtual ~TileChunksProvider() {}
+
+		// load a single chunk of tiles.
+		// chunk is the index of the chunk (in chunks, not tiles), chunk_size is the size of a chunk in tiles.
+		// out_tiles is an array of (chunk_size.x * chunk_size.y) tiles to fill, row-major.
+		// return false if failed to load the chunk (it will not be rendered, and loading will be retried after NESS_CHUNK_RETRY_FRAMES frames).
+		// IMPORTANT: this is called from a worker thread, so it must be thread safe!
+		NESSENGINE_API virtual bool load_chunk(const Pointi& chunk, const Sizei& chunk_size, STileData* out_tiles) = 0;
+	};
+
+	// tile chunks provider pointer
+	NESSENGINE_API typedef SharedPtr<TileChunksProvider> TileChunksProviderPtr;
+
+	/**
+	* load tile chunks from a binary chunks file.
+	* file format (little endian):
+	*	header:		"NCHK" (4 bytes), version (uint32), map width, map height, chunk width, chunk height (int32 each)
+	*	chunks:		all chunks one after another (row-major by chunk index). every chunk contains (chunk width * chunk height)
+	*				tiles, row-major, and every tile is: source (uint16), flags (uint8), color r, g, b, a (uint8 each).
+	*				note: chunks on the edges are always full size, tiles outside the map should just be hidden.
+	*/
+	class TileChunksFile : public TileChunksProvider
+	{
+	private:
+		String			m_file_name;		// chunks file name
+		Sizei			m_map_size;			// map size in tiles (from file header)
+		Sizei			m_chunk_size;		// chunk size in tiles (from file header)
+
+	public:
+		// open chunks file and read its header
+		NESSENGINE_API TileChunksFile(const String& file_name);
+
+		// get the map and chunks size
+		NESSENGINE_API inline const Sizei& get_map_size() const {return m_map_size;}
+		NESSENGINE_API inline const Sizei& get_chunk_size() const {return m_chunk_size;}
+
+		// load a chunk from file
+		NESSENGINE_API virtual bool load_chunk(const Pointi& chunk, const Sizei& chunk_size, STileData* out_tiles);
+
+		// write a flat tilemap into a chunks file
+		NESSENGINE_API static void write_file(const String& file_name, FlatTileMap& map, const Sizei& chunk_size);
+	};
+
+	// tile chunks file pointer
+	NESSENGINE_API typedef SharedPtr<TileChunksFile> TileChunksFilePtr;
+
+	// a chunk of tiles loaded into memory
+	struct STilesChunk
+	{
+		Containers::Vector<STileData>	tiles;				// chunk tiles
+		unsigned int					last_used_frame;	// last frame this chunk was needed (for evicting least recently used chunks)
+	};
+
+	// a chunk that finished loading and waiting to be added to the tilemap
+	struct SLoadedTilesChunk
+	{
+		unsigned int					id;					// chunk id
+		bool							success;			// did we load successfully?
+		Containers::Vector<STileData>	tiles;				// the chunk tiles
+	};
+
+	/* 
+	* ChunkedTileMap is a flat tilemap that split the world into fixed-size chunks. only chunks around the camera are kept in memory.
+	* chunks are loaded in background threads via a TileChunksProvider, so loading never stalls the rendering. chunks that are not
+	* loaded yet are simply not rendered.
+	* note: changes you make to tiles (set_tile_type() etc.) are only kept while the chunk is in memory, and customizing tiles is not supported.
+	*/
+	class ChunkedTileMap : public FlatTileMap
+	{
+	protected:
+		TileChunksProviderPtr									m_provider;					// provide the chunks data
+		Sizei													m_chunk_size;				// size of a single chunk, in tiles
+		Sizei													m_chunks_count;				// how many chunks there are on x and y axis
+		unsigned int											m_prefetch_margin;			// how many chunks to load around the visible chunks
+		unsigned int											m_memory_budget;			// max bytes of chunks to keep in memory
+		unsigned int											m_resident_bytes;			// bytes of all chunks currently in memory
+		Containers::UnorderedMap<unsigned int, STilesChunk>		m_chunks;					// chunks currently in memory
+		Containers::UnorderedMap<unsigned int, bool>			m_loading;					// chunks currently loading
+		Containers::UnorderedMap<unsigned int, unsigned int>	m_failed;					// chunks that failed to load, and the frame to try loading them again
+		Containers::Vector<SLoadedTilesChunk>					m_loaded;					// chunks that finished loading (filled by the workers)
+		Containers::Vector<SLoadedTilesChunk>					m_loaded_swap;				// used to take the loaded chunks list without holding the lock
+		Containers::Vector<const STilesChunk*>					m_visible_chunks;			// visible chunks while rendering (null if not loaded)
+		SDL_mutex*												m_loaded_mutex;				// protect the loaded chunks list
+		Utils::WorkersPool										m_workers;					// the workers that load the chunks
+
+	public:
+
+		// create the chunked tilemap
+		// spriteFile - texture file to use for all tiles
+		// provider - the object that loads the chunks data
+		// mapSize - how many tiles there are on rows and columns (whole world)
+		// chunkSize - how many tiles there are in a single chunk
+		// singleTileSize - the size in pixels of a single tile
+		// tilesDistance - the distance between tiles. if zero, will use the tile size
+		// loadingThreads - how many background threads to use for loading chunks
+		NESSENGINE_API ChunkedTileMap(Renderer* renderer, const String& spriteFile, const TileChunksProviderPtr& provider, const Sizei& mapSize, 
+			const Sizei& chunkSize = Sizei(32, 32), const Size& singleTileSize = Size(36, 36), const Size& tilesDistance = Size::ZERO, unsigned int loadingThreads = 1);
+
+		NESSENGINE_API ~ChunkedTileMap();
+
+		// clear this tilemap and stop loading
+		NESSENGINE_API virtual void destroy();
+
+		// set how many chunks to load around the chunks visible in screen (default to 1)
+		NESSENGINE_API inline void set_prefetch_margin(unsigned int margin) {m_prefetch_margin = margin;}
+		NESSENGINE_API inline unsigned int get_prefetch_margin() const {return m_prefetch_margin;}
+
+		// set max memory in bytes to use for chunks data (default to 16mb).
+		// when exceeded, chunks that are not needed are unloaded, starting with the least recently used.
+		// note: chunks around the camera are never unloaded, even if exceeding the budget.
+		NESSENGINE_API inline void set_memory_budget(unsigned int bytes) {m_memory_budget = bytes;}
+		NESSENGINE_API inline unsigned int get_memory_budget() const {return m_memory_budget;}
+
+		// get chunks info
+		NESSENGINE_API inline const Sizei& get_chunk_size() const {return m_chunk_size;}
+		NESSENGINE_API inline const Sizei& get_chunks_count() const {return m_chunks_count;}
+		NESSENGINE_API inline unsigned int get_loaded_chunks_count() const {return (unsigned int)m_chunks.size();}
+		NESSENGINE_API inline unsigned int get_loading_chunks_count() const {return (unsigned int)m_loading.size();}
+		NESSENGINE_API inline unsigned int get_resident_bytes() const {return m_resident_bytes;}
+
+		// return if the chunk of a given tile is currently loaded
+		NESSENGINE_API bool is_tile_loaded(const Pointi& index) const;
+
+		// get tile data by index. will throw exception if the chunk of this tile is not loaded!
+		NESSENGINE_API virtual STileData& get_tile(const Pointi& index);
+
+		// set the source index of all the tiles in loaded chunks
+		NESSENGINE_API virtual void set_all_tiles_type(unsigned short source);
+
+		// apply the given function to all the tiles in loaded chunks
+		NESSENGINE_API virtual void apply_to_all(TExecuteOnTilesData func);
+
+		// customizing tiles is not supported in chunked tilemap
+		NESSENGINE_API virtual SpritePtr customize_tile(const Pointi& index) {throw IllegalAction("Cannot customize tiles in chunked tilemap!");}
+
+		// request loading all the chunks around the camera and block until they are loaded.
+		// useful for loading screens, or when teleporting the camera.
+		NESSENGINE_API void load_chunks_now(const CameraApiPtr& camera);
+
+		// render this tilemap
+		NESSENGINE_API virtual void render(const CameraApiPtr& camera);
+
+		// called by the loading workers when a chunk finish loading
+		// DONT USE THIS ON YOUR OWN, it is called from the worker threads.
+		NESSENGINE_API void __on_chunk_loaded(unsigned int id, bool success, Containers::Vector<STileData>& tiles);
+
+	protected:
+		// add the chunks that finished loading to the tilemap
+		NESSENGINE_API void integrate_loaded_chunks();
+
+		// request loading of missing chunks around the camera and mark them as used.
+		// return the range of visible chunks (x, y is first chunk, w, h is last chunk, inclusive) or empty rect if nothing is visible.
+		NESSENGINE_API Rectangle update_chunks(const CameraApiPtr& camera, const Rectangle& tiles_range);
+
+		// request loading of a chunk (if not loaded or already loading)
+		NESSENGINE_API void request_chunk(int cx, int cy);
+
+		// unload least recently used chunks until we are within memory budget
+		NESSENGINE_API void evict_chunks();
+
+		// get chunk id from chunk index
+		NESSENGINE_API inline unsigned int get_chunk_id(int cx, int cy) const {return (unsigned int)cx + (unsigned int)cy * (unsigned int)m_chunks_count.x;}
+	};
+
+	NESSENGINE_API typedef SharedPtr<ChunkedTileMap> ChunkedTileMapPtr;
+};
@@ -0,0 +1,471 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+#include "../../renderer/renderer.h"
+#include "flat_tile_map.h"
+
+namespace Ness
+{
+	FlatTileMap::FlatTileMap(Renderer* renderer, const String& spriteFile, const Sizei& mapSize, 
+		const Size& singleTileSize, const Size& tilesDistance) 
+		: NodeAPI(renderer), m_size(mapSize), m_tile_size(singleTileSize), m_extra_tiles_factor(0, 0),
+			m_last_render_frame_id(0), m_last_update_frame_id(0)
+	{
+		// set distance between tiles (either tile size or provided distance)
+		m_sprites_distance = (tilesDistance == Size::ZERO ? singleTileSize : tilesDistance);
+
+		// load texture and set default source rect (entire texture)
+		m_texture = m_renderer->resources().get_texture(spriteFile);
+		add_source_rect(Rectangle(0, 0, m_texture->get_size().x, m_texture->get_size().y));
+
+		// create the tiles data
+		STileData empty_tile;
+		empty_tile.source = 0;
+		empty_tile.flags = 0;
+		empty_tile.color = Colorb(255, 255, 255, 255);
+		m_tiles.assign(m_size.x * m_size.y, empty_tile);
+
+		// tilemap should never be broken by z-nodes
+		set_flag(RNF_NEVER_BREAK);
+	}
+
+	FlatTileMap::FlatTileMap(Renderer* renderer, const String& spriteFile, const Size& singleTileSize, const Size& tilesDistance) 
+		: NodeAPI(renderer), m_size(0, 0), m_tile_size(singleTileSize), m_extra_tiles_factor(0, 0),
+			m_last_render_frame_id(0), m_last_update_frame_id(0)
+	{
+		m_sprites_distance = (tilesDistance == Size::ZERO ? singleTileSize : tilesDistance);
+		m_texture = m_renderer->resources().get_texture(spriteFile);
+		add_source_rect(Rectangle(0, 0, m_texture->get_size().x, m_texture->get_size().y));
+		set_flag(RNF_NEVER_BREAK);
+	}
+
+	const SRenderTransformations& FlatTileMap::get_absolute_transformations()
+	{
+		// if don't have a parent, return self transformations
+		if (!m_parent)
+			return m_transformations;
+
+		// calculate this transformations with parent transformations
+		m_absolute_transformations = m_transformations;
+		m_absolute_transformations.add_transformations(m_parent->get_absolute_transformations());
+		return m_absolute_transformations;
+	}
+
+	bool FlatTileMap::was_rendered_this_frame() const
+	{
+		return m_renderer->get_frameid() == m_last_render_frame_id;
+	}
+
+	bool FlatTileMap::was_updated_this_frame() const
+	{
+		return m_renderer->get_frameid() == m_last_update_frame_id;
+	}
+
+	void FlatTileMap::destroy()
+	{
+		for (auto sprite = m_custom_tiles.begin(); sprite != m_custom_tiles.end(); ++sprite)
+		{
+			(*sprite)->__change_parent(nullptr);
+		}
+		m_custom_tiles.clear();
+		m_custom_tiles_ids.clear();
+		m_custom_tiles_index.clear();
+		m_tiles.clear();
+	}
+
+	void FlatTileMap::set_tiles_anchor(const Point& anchor)
+	{
+		m_tiles_anchor = anchor;
+		for (auto sprite = m_custom_tiles.begin(); sprite != m_custom_tiles.end(); ++sprite)
+		{
+			(*sprite)->set_anchor(m_tiles_anchor);
+		}
+	}
+
+	void FlatTileMap::set_tiles_sheet(const Sizei& tilesCount)
+	{
+		m_sources.clear();
+		int x_step = (int)((float)m_texture->get_size().x / (float)tilesCount.x);
+		int y_step = (int)((float)m_texture->get_size().y / (float)tilesCount.y);
+		for (int j = 0; j < tilesCount.y; ++j)
+		{
+			for (int i = 0; i < tilesCount.x; ++i)
+			{
+				add_source_rect(Rectangle(x_step * i, y_step * j, x_step, y_step));
+			}
+		}
+	}
+
+	unsigned short FlatTileMap::add_source_rect(const Rectangle& sourceRect)
+	{
+		if (m_sources.size() >= 0xffff)
+			throw IllegalAction("Too many source rects in flat tilemap!");
+		m_sources.push_back(sourceRect);
+		return (unsigned short)(m_sources.size() - 1);
+	}
+
+	void FlatTileMap::validate_source(unsigned short source) const
+	{
+		if (source >= m_sources.size())
+			throw IllegalAction(("Invalid tile source index " + ness_int_to_string(source) + ", tilemap only have " + 
+				ness_int_to_string((int)m_sources.size()) + " source rects!").c_str());
+	}
+
+	void FlatTileMap::set_tile_type(const Pointi& index, unsigned short source)
+	{
+		validate_source(source);
+		STileData& tile = get_tile(index);
+		tile.source = source;
+		if (tile.flags & TILE_FLAG_CUSTOM)
+			get_custom_tile(index)->set_source_rect(m_sources[source]);
+	}
+
+	void FlatTileMap::set_tile_color(const Pointi& index, const Color& color)
+	{
+		STileData& tile = get_tile(index);
+		tile.color = Colorb((unsigned char)(color.r * 255), (unsigned char)(color.g * 255), (unsigned char)(color.b * 255), (unsigned char)(color.a * 255));
+		if (color == Color::WHITE)
+			tile.flags &= ~TILE_FLAG_COLORED;
+		else
+			tile.flags |= TILE_FLAG_COLORED;
+		if (tile.flags & TILE_FLAG_CUSTOM)
+			get_custom_tile(index)->set_color(color);
+	}
+
+	void FlatTileMap::set_tile_visible(const Pointi& index, bool visible)
+	{
+		STileData& tile = get_tile(index);
+		if (visible)
+			tile.flags &= ~TILE_FLAG_HIDDEN;
+		else
+			tile.flags |= TILE_FLAG_HIDDEN;
+		if (tile.flags & TILE_FLAG_CUSTOM)
+			get_custom_tile(index)->set_visible(visible);
+	}
+
+	void FlatTileMap::set_tile_flip(const Pointi& index, bool flip_x, bool flip_y)
+	{
+		STileData& tile = get_tile(index);
+		tile.flags &= ~(TILE_FLAG_FLIP_X | TILE_FLAG_FLIP_Y);
+		if (flip_x) tile.flags |= TILE_FLAG_FLIP_X;
+		if (flip_y) tile.flags |= TILE_FLAG_FLIP_Y;
+		if (tile.flags & TILE_FLAG_CUSTOM)
+			get_custom_tile(index)->set_scale(Size(flip_x ? -1.0f : 1.0f, flip_y ? -1.0f : 1.0f));
+	}
+
+	void FlatTileMap::set_all_tiles_type(unsigned short source)
+	{
+		validate_source(source);
+		for (auto tile = m_tiles.begin(); tile != m_tiles.end(); ++tile)
+		{
+			tile->source = source;
+		}
+		for (auto sprite = m_custom_tiles.begin(); sprite != m_custom_tiles.end(); ++sprite)
+		{
+			(*sprite)->set_source_rect(m_sources[source]);
+		}
+	}
+
+	void FlatTileMap::apply_to_all(TExecuteOnTilesData func)
+	{
+		Pointi index;
+		for (index.y = 0; index.y < m_size.y; index.y++)
+		{
+			for (index.x = 0; index.x < m_size.x; index.x++)
+			{
+				func(index, get_tile(index));
+			}
+		}
+	}
+
+	void FlatTileMap::arrange_sprite(const SpritePtr& sprite, const Pointi& index, const STileData& tile)
+	{
+		// set position, size and anchor
+		sprite->set_position(get_position_from_index(index));
+		sprite->set_size(m_tile_size);
+		sprite->set_anchor(m_tiles_anchor);
+
+		// set z-index
+		sprite->set_zindex(sprite->get_position().y - m_sprites_distance.y);
+
+		// copy tile properties
+		sprite->set_blend_mode(BLEND_MODE_NONE);
+		sprite->set_source_rect(m_sources[tile.source]);
+		sprite->set_visible((tile.flags & TILE_FLAG_HIDDEN) == 0);
+		sprite->set_scale(Size((tile.flags & TILE_FLAG_FLIP_X) ? -1.0f : 1.0f, (tile.flags & TILE_FLAG_FLIP_Y) ? -1.0f : 1.0f));
+		if (tile.flags & TILE_FLAG_COLORED)
+		{
+			sprite->set_color(Color(tile.color.r / 255.0f, tile.color.g / 255.0f, tile.color.b / 255.0f, tile.color.a / 255.0f));
+		}
+	}
+
+	SpritePtr FlatTileMap::customize_tile(const Pointi& index)
+	{
+		// already customized?
+		STileData& tile = get_tile(index);
+		if (tile.flags & TILE_FLAG_CUSTOM)
+			return get_custom_tile(index);
+
+		// create the sprite
+		SpritePtr sprite = ness_make_ptr<Sprite>(m_renderer, m_texture);
+		sprite->__change_parent(this);
+		arrange_sprite(sprite, index, tile);
+
+		// add to custom tiles
+		m_custom_tiles_index[index.x + index.y * m_size.x] = (unsigned int)m_custom_tiles.size();
+		m_custom_tiles.push_back(sprite);
+		m_custom_tiles_ids.push_back(index.x + index.y * m_size.x);
+		tile.flags |= TILE_FLAG_CUSTOM;
+		return sprite;
+	}
+
+	void FlatTileMap::uncustomize_tile(const Pointi& index)
+	{
+		STileData& tile = get_tile(index);
+		if ((tile.flags & TILE_FLAG_CUSTOM) == 0)
+			return;
+
+		// remove from custom tiles (swap with last sprite to avoid moving all the vector)
+		unsigned int tile_index = index.x + index.y * m_size.x;
+		unsigned int pos = m_custom_tiles_index[tile_index];
+		m_custom_tiles[pos]->__change_parent(nullptr);
+		if (pos != m_custom_tiles.size() - 1)
+		{
+			m_custom_tiles[pos] = m_custom_tiles.back();
+			m_custom_tiles_ids[pos] = m_custom_tiles_ids.back();
+			m_custom_tiles_index[m_custom_tiles_ids[pos]] = pos;
+		}
+		m_custom_tiles.pop_back();
+		m_custom_tiles_ids.pop_back();
+		m_custom_tiles_index.erase(tile_index);
+		tile.flags &= ~TILE_FLAG_CUSTOM;
+	}
+
+	SpritePtr FlatTileMap::get_custom_tile(const Pointi& index) const
+	{
+		auto pos = m_custom_tiles_index.find(index.x + index.y * m_size.x);
+		if (pos == m_custom_tiles_index.end())
+			return SpritePtr();
+		return m_custom_tiles[pos->second];
+	}
+
+	void FlatTileMap::transformations_update()
+	{
+		m_last_update_frame_id = m_renderer->get_frameid();
+		m_trans_generation++;
+		for (auto sprite = m_custom_tiles.begin(); sprite != m_custom_tiles.end(); ++sprite)
+		{
+			(*sprite)->transformations_update();
+		}
+	}
+
+	void FlatTileMap::select_entities_from_position(EntitiesList& out_list, const Pointf& pos, bool recursive) const
+	{
+		Pointi index = get_index_from_position(pos);
+		if (index.x < 0 || index.y < 0 || index.x >= m_size.x || index.y >= m_size.y)
+			return;
+		SpritePtr tile = get_custom_tile(index);
+		if (tile && tile->get_flag(RNF_SELECTABLE))
+		{
+			out_list.push_back(tile);
+		}
+	}
+
+	void FlatTileMap::__get_visible_entities(RenderablesList& out_list, const CameraApiPtr& camera, bool break_son_nodes)
+	{
+		Rectangle range = get_tiles_in_screen(camera);
+		for (unsigned int i = 0; i < m_custom_tiles.size(); ++i)
+		{
+			int x = m_custom_tiles_ids[i] % m_size.x;
+			int y = m_custom_tiles_ids[i] / m_size.x;
+			if (x >= range.x && x < range.w && y >= range.y && y < range.h)
+				out_list.push_back(m_custom_tiles[i]);
+		}
+	}
+	
+	void FlatTileMap::__get_all_entities(RenderablesList& out_list, bool breakGroups)
+	{
+		for (auto sprite = m_custom_tiles.begin(); sprite != m_custom_tiles.end(); ++sprite)
+		{
+			out_list.push_back(*sprite);
+		}
+	}
+
+	Rectangle FlatTileMap::get_tiles_in_screen(const CameraApiPtr& camera) 
+	{
+		Rectangle ret;
+		Pointi pos = get_absolute_position_with_camera(camera);
+		ret.x = get_first_tile_in_screen_x(pos);
+		ret.y = get_first_tile_in_screen_y(pos);
+		ret.w = ret.x + get_tiles_in_screen_x() + 1;
+		ret.h = ret.y + get_tiles_in_screen_y() + 2;
+		
+		put_in_range(ret.x, ret.y);
+		put_in_range(ret.w, ret.h);
+
+		return ret;
+	}
+
+	void FlatTileMap::put_in_range(int& i, int& j) const
+	{
+		if (i < 0) i = 0;
+		if (i > m_size.x) i = m_size.x;
+		if (j < 0) j = 0;
+		if (j > m_size.y) j = m_size.y;
+	}
+
+	int FlatTileMap::get_first_tile_in_screen_x(const Point& cameraPos)
+	{
+		float scale = get_absolute_transformations().scale.x;
+		return cameraPos.x < 0 ? (int)(((-cameraPos.x - (m_tile_size.x * scale)) / (m_sprites_distance.x * scale))) - m_extra_tiles_factor.x : 0;
+	}
+
+	int FlatTileMap::get_first_tile_in_screen_y(const Point& cameraPos)
+	{
+		float scale = get_absolute_transformations().scale.y;
+		return cameraPos.y < 0 ? (int)(((-cameraPos.y - (m_tile_size.y * scale)) / (m_sprites_distance.y * scale))) - m_extra_tiles_factor.y : 0;
+	}
+
+	int FlatTileMap::get_tiles_in_screen_x()
+	{
+		float scale = get_absolute_transformations().scale.x;
+		return (int)((m_renderer->get_target_size().x + (m_tile_size.x * scale)) / (m_sprites_distance.x * scale)) + 1 + m_extra_tiles_factor.x * 2;
+	}
+
+	int FlatTileMap::get_tiles_in_screen_y()
+	{
+		float scale = get_absolute_transformations().scale.y;
+		return (int)((m_renderer->get_target_size().y + (m_tile_size.y * scale)) / (m_sprites_distance.y * scale)) + 1 + m_extra_tiles_factor.y * 2;
+	}
+
+	Pointi FlatTileMap::get_index_from_position(const Point& position) const
+	{
+		Pointi index;
+		Point scale = get_absolute_transformations_const().scale;
+		index.x = (int)((position.x + (m_tile_size.x * scale.x * m_tiles_anchor.x)) / (m_sprites_distance.x * scale.x));
+		index.y = (int)((position.y + (m_tile_size.y * scale.y * m_tiles_anchor.y)) / (m_sprites_distance.y * scale.y));
+		return index;
+	}
+
+	Point FlatTileMap::get_position_from_index(const Pointi& index) const
+	{
+		return Point(index.x * m_sprites_distance.x, index.y * m_sprites_distance.y);
+	}
+
+	Rectangle FlatTileMap::get_occupied_region() const
+	{
+		Rectangle ret;
+		ret.x = (int)get_absolute_transformations_const().position.x;
+		ret.y = (int)get_absolute_transformations_const().position.y;
+		ret.w = (int)(((m_size.x - 1) * m_sprites_distance.x) + m_tile_size.x);
+		ret.h = (int)(((m_size.y - 1) * m_sprites_distance.y) + m_tile_size.y);
+		return ret;
+	}
+
+	bool FlatTileMap::is_really_visible(const CameraApiPtr& camera)
+	{
+		if (!m_visible)
+			return false;
+
+		const SRenderTransformations& trans = get_absolute_transformations(); 
+		if (trans.color.a <= 0.0f)
+			return false;
+
+		Rectangle TileInScreen = get_tiles_in_screen(camera);
+		if (TileInScreen.x >= TileInScreen.w || TileInScreen.y >= TileInScreen.h)
+			return false;
+
+		return true;
+	}
+
+	void FlatTileMap::render_tile(const CameraApiPtr& camera, const Pointi& index, const STileData& tile, 
+		const SRenderTransformations& trans, const Sizei& tile_size)
+	{
+		// hidden tile, or invalid source?
+		if ((tile.flags & TILE_FLAG_HIDDEN) || tile.source >= m_sources.size())
+			return;
+
+		// customized tile - render the sprite
+		if (tile.flags & TILE_FLAG_CUSTOM)
+		{
+			get_custom_tile(index)->render(camera);
+			return;
+		}
+
+		// calc tile absolute transformations
+		SRenderTransformations tile_trans = trans;
+		tile_trans.position = (get_position_from_index(index) * trans.scale) + trans.position;
+		if (tile.flags & TILE_FLAG_COLORED)
+		{
+			tile_trans.color *= Color(tile.color.r / 255.0f, tile.color.g / 255.0f, tile.color.b / 255.0f, tile.color.a / 255.0f);
+		}
+
+		// calc target rect (same as the Entity target rect)
+		Rectangle target;
+		target.w = (tile.flags & TILE_FLAG_FLIP_X) ? -tile_size.x : tile_size.x;
+		target.h = (tile.flags & TILE_FLAG_FLIP_Y) ? -tile_size.y : tile_size.y;
+		target.x = (int)floor(tile_trans.position.x - (abs(target.w) * m_tiles_anchor.x));
+		target.y = (int)floor(tile_trans.position.y - (abs(target.h) * m_tiles_anchor.y));
+
+		// apply camera and cull
+		camera->apply_transformations(this, target, tile_trans);
+		if (camera->should_cull_post_transform(this, target, tile_trans))
+			return;
+
+		// render!
+		m_renderer->blit(m_texture, &m_sources[tile.source], target, tile_trans.blend, tile_trans.color, tile_trans.rotation, m_tiles_anchor);
+	}
+
+	void FlatTileMap::render(const CameraApiPtr& camera)
+	{
+		// if invisible skip
+		if (!m_visible)
+			return;
+
+		// update if parents moved
+		__get_transformations_generation();
+
+		Rectangle range = get_tiles_in_screen(camera);
+		if (range.x == range.w || range.y == range.h)
+			return;
+
+		// get absolute transformations and tile size after scale
+		const SRenderTransformations& trans = get_absolute_transformations();
+		if (trans.color.a <= 0.0f)
+			return;
+		Sizei tile_size((int)ceil(m_tile_size.x * trans.scale.x), (int)ceil(m_tile_size.y * trans.scale.y));
+
+		// lastly rendered
+		m_last_render_frame_id = m_renderer->get_frameid();
+
+		// render all visible tiles, row by row
+		Pointi index;
+		for (index.y = range.y; index.y < range.h; index.y++)
+		{
+			const STileData* row = &m_tiles[index.y * m_size.x];
+			for (index.x = range.x; index.x < range.w; index.x++)
+			{
+				render_tile(camera, index, row[index.x], trans, tile_size);
+			}
+		}
+	}
+};
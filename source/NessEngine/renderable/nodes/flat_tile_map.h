@@ -0,0 +1,235 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+/**
+* A light-weight tilemap that store the tiles as a flat array of small records instead of sprite objects.
+* use this for huge maps where you don't need full sprite functionality for every tile.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include "../entities/sprite.h"
+#include "../transformable_api.h"
+#include "../node_api.h"
+#include "../../basic_types/containers.h"
+
+namespace Ness
+{
+	// flags you can set on a single tile in a flat tilemap
+	enum ETileFlags
+	{
+		TILE_FLAG_HIDDEN = 0x1 << 0,		// tile will not be rendered
+		TILE_FLAG_COLORED = 0x1 << 1,		// use the tile color (else will use white)
+		TILE_FLAG_CUSTOM = 0x1 << 2,		// tile was customized and is rendered by a real sprite object (see customize_tile())
+		TILE_FLAG_FLIP_X = 0x1 << 3,		// flip tile on x axis
+		TILE_FLAG_FLIP_Y = 0x1 << 4,		// flip tile on y axis
+	};
+
+	// the data of a single tile in a flat tilemap
+	struct STileData
+	{
+		unsigned short	source;				// index of the source rect to render (see add_source_rect() and set_tiles_sheet())
+		unsigned char	flags;				// tile flags (see ETileFlags)
+		Colorb			color;				// tile color (only used when TILE_FLAG_COLORED is set)
+	};
+
+	// callback function to run on all tiles of a flat tilemap
+	NESSENGINE_API typedef void (*TExecuteOnTilesData)(const Pointi& index, STileData& tile);
+
+	/* 
+	* FlatTileMap is like the TileMap node, but instead of creating a sprite for every tile it holds a flat row-major array of
+	* tiles data and render directly from it. all tiles share the same texture and pick their source rect by index.
+	* if you need full sprite functionality for a specific tile, use customize_tile() to get a real sprite for it.
+	*/
+	class FlatTileMap : public NodeAPI
+	{
+	protected:
+		Sizei													m_size;						// size of the tilemap
+		Size													m_sprites_distance;			// distance between tiles
+		Size													m_tile_size;				// size of a single tile
+		ManagedResources::ManagedTexturePtr						m_texture;					// the texture all tiles use
+		Containers::Vector<Rectangle>							m_sources;					// source rects tiles can use (by index)
+		Containers::Vector<STileData>							m_tiles;					// the tiles data, row-major (index = x + y * width)
+		Containers::Vector<SpritePtr>							m_custom_tiles;				// sprites of tiles that were customized
+		Containers::Vector<unsigned int>						m_custom_tiles_ids;			// the tile index (x + y * width) of every sprite in m_custom_tiles
+		Containers::UnorderedMap<unsigned int, unsigned int>	m_custom_tiles_index;		// tile index to position in m_custom_tiles
+		SRenderTransformations									m_absolute_transformations;	// absolute transformations of this tilemap
+		Sizei													m_extra_tiles_factor;		// extra tiles to render (count in screen) on eatch side of x and y axis
+		Point													m_tiles_anchor;				// the tiles anchor
+		unsigned int											m_last_render_frame_id;		// return the frame id of the last time this tilemap was really rendered
+		unsigned int											m_last_update_frame_id;		// return the frame id of the last time this tilemap was updated
+
+	public:
+
+		// create the flat tilemap
+		// spriteFile - texture file to use for all tiles
+		// mapSize - how many tiles there are on rows and columns
+		// singleTileSize - the size in pixels of a single tile
+		// tilesDistance - the distance between tiles. if zero, will use the tile size
+		NESSENGINE_API FlatTileMap(Renderer* renderer, const String& spriteFile, const Sizei& mapSize, const Size& singleTileSize = Size(36, 36), 
+			const Size& tilesDistance = Size::ZERO);
+
+		NESSENGINE_API ~FlatTileMap() { destroy(); }
+
+		// return the last frame this tilemap was really rendered
+		NESSENGINE_API virtual unsigned int get_last_rendered_frame_id() const { return m_last_render_frame_id; }
+		NESSENGINE_API virtual bool was_rendered_this_frame() const;
+
+		// get the last frame in which this tilemap was updated
+		NESSENGINE_API virtual inline unsigned int get_last_update_frame_id() const { return m_last_update_frame_id; }
+		NESSENGINE_API virtual bool was_updated_this_frame() const;
+
+		// return the absolute transformations of this tilemap
+		NESSENGINE_API virtual const SRenderTransformations& get_absolute_transformations();
+		NESSENGINE_API virtual const SRenderTransformations& get_absolute_transformations_const() const {return m_absolute_transformations;}
+
+		// set extra tiles to render in screen for x and y axis (see TileMap::set_extra_tiles_in_screen())
+		NESSENGINE_API inline void set_extra_tiles_in_screen(const Sizei& extra) {m_extra_tiles_factor = extra;}
+
+		// clear this tilemap
+		NESSENGINE_API virtual void destroy();
+
+		// set/get the anchor of all the tiles
+		NESSENGINE_API void set_tiles_anchor(const Point& anchor);
+		NESSENGINE_API inline const Point& get_tiles_anchor() const {return m_tiles_anchor;}
+
+		// return tilemap params
+		NESSENGINE_API inline const Sizei& get_map_size() const {return m_size;}
+		NESSENGINE_API inline const Size& get_sprites_distance() const {return m_sprites_distance;}
+		NESSENGINE_API inline const Size& get_tiles_size() const {return m_tile_size;}
+		NESSENGINE_API inline const ManagedResources::ManagedTexturePtr& get_texture() const {return m_texture;}
+
+		// set the source rects table from a sprite sheet. will create a source rect for every tile in the sheet, where
+		// the source index of tile (x, y) in the sheet is (x + y * tilesCount.x).
+		// note: this replace all existing source rects.
+		NESSENGINE_API void set_tiles_sheet(const Sizei& tilesCount);
+
+		// add a source rect to the source rects table and return its index
+		NESSENGINE_API unsigned short add_source_rect(const Rectangle& sourceRect);
+
+		// get a source rect by index
+		NESSENGINE_API inline const Rectangle& get_source_rect(unsigned short index) const {return m_sources[index];}
+		NESSENGINE_API inline unsigned int get_source_rects_count() const {return (unsigned int)m_sources.size();}
+
+		// get tile data by index.
+		// note: if you change the data directly and the tile is customized, it will not effect the custom sprite.
+		NESSENGINE_API virtual STileData& get_tile(const Pointi& index) {return m_tiles[index.x + index.y * m_size.x];}
+
+		// set tile source index, color, visibility and flipping
+		// note: source must be a valid source rect index, else will throw exception
+		NESSENGINE_API void set_tile_type(const Pointi& index, unsigned short source);
+		NESSENGINE_API void set_tile_color(const Pointi& index, const Color& color);
+		NESSENGINE_API void set_tile_visible(const Pointi& index, bool visible);
+		NESSENGINE_API void set_tile_flip(const Pointi& index, bool flip_x, bool flip_y);
+
+		// set the source index of all tiles
+		NESSENGINE_API virtual void set_all_tiles_type(unsigned short source);
+
+		// apply the given function to all tiles data
+		NESSENGINE_API virtual void apply_to_all(TExecuteOnTilesData func);
+
+		// turn a tile into a real sprite you can do anything with (change texture, animate, etc.).
+		// the sprite is created with the tile current properties, and from now on the tile will be rendered via this sprite.
+		// if the tile is already customized will just return its sprite.
+		NESSENGINE_API virtual SpritePtr customize_tile(const Pointi& index);
+
+		// remove the custom sprite of a tile and return to render it from the tile data
+		NESSENGINE_API void uncustomize_tile(const Pointi& index);
+
+		// get the custom sprite of a tile, or empty pointer if tile is not customized
+		NESSENGINE_API SpritePtr get_custom_tile(const Pointi& index) const;
+
+		// return the total region that this tilemap take
+		NESSENGINE_API Rectangle get_occupied_region() const;
+
+		// direct access to son entities. note: only customized tiles are real entities!
+		NESSENGINE_API virtual unsigned int get_sons_count() const {return (unsigned int)m_custom_tiles.size();}
+		NESSENGINE_API virtual RenderablePtr get_son(unsigned int index) {return m_custom_tiles[index];}
+
+		// return if need transformations udpate (always false for tilemap)
+		NESSENGINE_API virtual bool need_transformations_update() {return false;}
+
+		// get entities from position. note: only customized tiles are real entities and can be selected.
+		NESSENGINE_API virtual void select_entities_from_position(EntitiesList& out_list, const Pointf& pos, bool recursive) const;
+
+		// return index of tile from position
+		NESSENGINE_API virtual Pointi get_index_from_position(const Point& position) const;
+
+		// return position of tile from index
+		NESSENGINE_API virtual Point get_position_from_index(const Pointi& index) const;
+
+		// get all visible son entities (only customized tiles)
+		NESSENGINE_API virtual void __get_visible_entities(RenderablesList& out_list,
+			const CameraApiPtr& camera, bool break_son_nodes = true);
+
+		// get all son entities (only customized tiles)
+		NESSENGINE_API virtual void __get_all_entities(RenderablesList& out_list, bool breakGroups);
+
+		// update that the tilemap needs update
+		NESSENGINE_API virtual void transformations_update();
+
+		// check if this tilemap is really visible
+		NESSENGINE_API virtual bool is_really_visible(const CameraApiPtr& camera);
+
+		// get range of tiles that are within the screen (see TileMap::get_tiles_in_screen())
+		NESSENGINE_API Rectangle get_tiles_in_screen(const CameraApiPtr& camera);
+
+		// add/remove entities from this node - illegal in tilesmap node!
+		NESSENGINE_API virtual void add(const RenderablePtr& object) {throw IllegalAction("Cannot add new entities to tilemap!");}
+		NESSENGINE_API virtual void add_first(const RenderablePtr& object) {throw IllegalAction("Cannot add new entities to tilemap!");}
+		NESSENGINE_API virtual void remove(const RenderablePtr& object) {throw IllegalAction("Cannot remove entities from tilemap!");}
+
+		// render this tilemap
+		NESSENGINE_API virtual void render(const CameraApiPtr& camera);
+
+	protected:
+		// create the tilemap without allocating the tiles array (for inheriting classes that store tiles differently)
+		NESSENGINE_API FlatTileMap(Renderer* renderer, const String& spriteFile, const Size& singleTileSize, const Size& tilesDistance);
+
+		// throw exception if source is not a valid source rect index
+		NESSENGINE_API void validate_source(unsigned short source) const;
+
+		// render a single tile from its data
+		// tiles with invalid source index are not rendered (can happen if set_tiles_sheet() replaced the source rects with fewer)
+		// trans is the absolute transformations of the tilemap, tile_size is the tile size after scale (negative if flipped)
+		NESSENGINE_API void render_tile(const CameraApiPtr& camera, const Pointi& index, const STileData& tile, 
+			const SRenderTransformations& trans, const Sizei& tile_size);
+
+		// function to return the first visible tile in screen on x axis
+		NESSENGINE_API virtual int get_first_tile_in_screen_x(const Point& cameraPos);
+		// function to return the first visible tile in screen on y axis
+		NESSENGINE_API virtual int get_first_tile_in_screen_y(const Point& cameraPos);
+		// function to get amount of tiles in screen on x axis
+		NESSENGINE_API virtual int get_tiles_in_screen_x();
+		// function to get amount of tiles in screen on y axis
+		NESSENGINE_API virtual int get_tiles_in_screen_y();
+		// make sure given index are within the tilemap size. 
+		// note: i and j may be equal to size.x and size.y, its still count in range
+		NESSENGINE_API void put_in_range(int& i, int& j) const;
+
+		// arrange a sprite of customized tile
+		NESSENGINE_API void arrange_sprite(const SpritePtr& sprite, const Pointi& index, const STileData& tile);
+	};
+
+	NESSENGINE_API typedef SharedPtr<FlatTileMap> FlatTileMapPtr;
+};
@@ -34,6 +34,7 @@ namespace Ness
 		set_anchor(Point::HALF);
 		set_blend_mode(BLEND_MODE_ADD);
 		m_need_redraw = true;
+		m_kind |= RENDERABLE_KIND_LIGHT;
 	}
 
 	void Light::attach_to(const RenderablePtr& target, const Point& offset, bool remove_if_target_removed)
@@ -107,17 +108,18 @@ namespace Ness
 	{
 		for (unsigned int i = 0; i < m_entities.size(); i++)
 		{
-			LightPtr curr = ness_ptr_cast<Light>(m_entities[i]);
-			if (curr->is_really_visible_const(camera))
+			// note: we only allow lights in this node so no need to check type
+			const RenderablePtr& curr = m_entities[i];
+			if (ness_kind_cast<Light>(curr)->is_really_visible_const(camera))
 			{
-				out_list.push_back(curr);
+				out_list.push_back(ness_static_ptr_cast<Light>(curr));
 			}
 		}
 	}
 
 	void LightNode::add(const RenderablePtr& object)
 	{
-		if (ness_ptr_cast<Light>(object) == nullptr)
+		if (!object->is_kind(RENDERABLE_KIND_LIGHT))
 		{
 			throw IllegalAction("Can only add lights to a light node!");
 		}
@@ -150,6 +152,9 @@ namespace Ness
 		if (!m_visible)
 			return;
 
+		// update if parents moved
+		__get_transformations_generation();
+
 		// if always-update is set to true:
 		if (m_always_update)
 		{
@@ -170,7 +175,7 @@ namespace Ness
 		// stop the loop when looping all objects or once need update is true.
 		for (unsigned int i = 0; ((i < m_entities.size()) && !m_need_update); i++)
 		{
-			m_need_update = ness_ptr_cast<Light>(m_entities[i])->need_redraw();
+			m_need_update = ness_kind_cast<Light>(m_entities[i])->need_redraw();
 		}
 		
 		// if got here and don't need update, only render the canvas and return
@@ -192,7 +197,7 @@ namespace Ness
 		m_renderer->push_render_target(m_canvas->get_texture());
 		for (unsigned int i = 0; i < m_entities.size(); i++)
 		{
-			ness_ptr_cast<Light>(m_entities[i])->set_need_redraw(false);
+			ness_kind_cast<Light>(m_entities[i])->set_need_redraw(false);
 			m_entities[i]->render(camera);
 		}
 		m_renderer->pop_render_target();
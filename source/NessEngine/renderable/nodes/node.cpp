@@ -144,6 +144,26 @@ namespace Ness
 		return NewMap;
 	}
 
+	FlatTileMapPtr Node::create_flat_tilemap(const String& spriteFile, const Sizei& mapSize, const Size& singleTileSize, const Size& tilesDistance, bool add_immediatly)
+	{
+		FlatTileMapPtr NewMap = ness_make_ptr<FlatTileMap>(this->m_renderer, spriteFile, mapSize, singleTileSize, tilesDistance);
+		if (add_immediatly) add(NewMap);
+		return NewMap;
+	}
+
+	ChunkedTileMapPtr Node::create_chunked_tilemap(const String& spriteFile, const TileChunksProviderPtr& provider, const Sizei& mapSize, const Sizei& chunkSize, const Size& singleTileSize, const Size& tilesDistance, bool add_immediatly)
+	{
+		ChunkedTileMapPtr NewMap = ness_make_ptr<ChunkedTileMap>(this->m_renderer, spriteFile, provider, mapSize, chunkSize, singleTileSize, tilesDistance);
+		if (add_immediatly) add(NewMap);
+		return NewMap;
+	}
+
+	ChunkedTileMapPtr Node::create_chunked_tilemap(const String& spriteFile, const String& chunksFile, const Size& singleTileSize, const Size& tilesDistance, bool add_immediatly)
+	{
+		TileChunksFilePtr file = ness_make_ptr<TileChunksFile>(chunksFile);
+		return create_chunked_tilemap(spriteFile, file, file->get_map_size(), file->get_chunk_size(), singleTileSize, tilesDistance, add_immediatly);
+	}
+
 	 NodesMapPtr Node::create_nodesmap(const Sizei& mapSize, const Size& singleNodeSize, const Size& nodesDistance, bool add_immediatly)
 	 {
 		NodesMapPtr NewMap = ness_make_ptr<NodesMap>(this->m_renderer, mapSize, singleNodeSize, nodesDistance);
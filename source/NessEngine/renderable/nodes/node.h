@@ -43,6 +43,9 @@ namespace Ness
 	class ZNode;
 	class StaticNode;
 	class TileMap;
+	class FlatTileMap;
+	class ChunkedTileMap;
+	class TileChunksProvider;
 	class NodesMap;
 	class RectangleShape;
 	class NodeAPI;
@@ -64,6 +67,9 @@ namespace Ness
 	NESSENGINE_API typedef SharedPtr<TextureScroller>	TextureScrollerPtr;
 	NESSENGINE_API typedef SharedPtr<RectangleShape>	RectangleShapePtr;
 	NESSENGINE_API typedef SharedPtr<TileMap>			TileMapPtr;
+	NESSENGINE_API typedef SharedPtr<FlatTileMap>		FlatTileMapPtr;
+	NESSENGINE_API typedef SharedPtr<ChunkedTileMap>	ChunkedTileMapPtr;
+	NESSENGINE_API typedef SharedPtr<TileChunksProvider>	TileChunksProviderPtr;
 	NESSENGINE_API typedef SharedPtr<NodesMap>			NodesMapPtr;
 	NESSENGINE_API typedef SharedPtr<ParticlesNode>		ParticlesNodePtr;
 	NESSENGINE_API typedef SharedPtr<NodeAPI>			NodeAPIPtr;
@@ -88,6 +94,9 @@ namespace Ness
 		NESSENGINE_API virtual ParticlesNodePtr create_particles_node(const Size& EstimatedSize, bool add_immediatly=true);
 		NESSENGINE_API virtual CanvasPtr create_canvas(const String& textureName, const Sizei& size = Sizei::ZERO, bool add_immediatly=true);
 		NESSENGINE_API virtual TileMapPtr create_tilemap(const String& spriteFile, const Sizei& mapSize, const Size& singleTileSize=Size(36, 36), const Size& tilesDistance=Size::ZERO, bool add_immediatly=true);
+		NESSENGINE_API virtual FlatTileMapPtr create_flat_tilemap(const String& spriteFile, const Sizei& mapSize, const Size& singleTileSize=Size(36, 36), const Size& tilesDistance=Size::ZERO, bool add_immediatly=true);
+		NESSENGINE_API virtual ChunkedTileMapPtr create_chunked_tilemap(const String& spriteFile, const TileChunksProviderPtr& provider, const Sizei& mapSize, const Sizei& chunkSize=Sizei(32, 32), const Size& singleTileSize=Size(36, 36), const Size& tilesDistance=Size::ZERO, bool add_immediatly=true);
+		NESSENGINE_API virtual ChunkedTileMapPtr create_chunked_tilemap(const String& spriteFile, const String& chunksFile, const Size& singleTileSize=Size(36, 36), const Size& tilesDistance=Size::ZERO, bool add_immediatly=true);
 		NESSENGINE_API virtual NodesMapPtr create_nodesmap(const Sizei& mapSize, const Size& singleNodeSize=Size(36, 36), const Size& nodesDistance=Size::ZERO, bool add_immediatly=true);
 		NESSENGINE_API virtual TextPtr create_text(const String& fontFile, const String& text, unsigned int font_size = 12, bool add_immediatly=true);
 		NESSENGINE_API virtual MultiTextPtr create_multitext(const String& fontFile, const String& text, unsigned int font_size = 12, bool add_immediatly=true);
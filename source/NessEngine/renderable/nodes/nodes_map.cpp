@@ -117,6 +117,7 @@ namespace Ness
 	void NodesMap::transformations_update()
 	{
 		m_last_update_frame_id = m_renderer->get_frameid();
+		m_trans_generation++;
 	}
 
 	void NodesMap::put_in_range(int& i, int& j)
@@ -312,6 +313,9 @@ namespace Ness
 		if (!m_visible)
 			return;
 
+		// update if parents moved
+		__get_transformations_generation();
+
 		Rectangle range = get_nodes_in_screen(camera);
 		if (range.x == range.w || range.y == range.h)
 			return;
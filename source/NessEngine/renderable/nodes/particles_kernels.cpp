@@ -0,0 +1,182 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+#include "particles_kernels.h"
+#include <SDL.h>
+
+// check if we can compile x86 vector instructions
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define NESSENGINE_PARTICLES_SIMD
+	#include <emmintrin.h>
+	#include <immintrin.h>
+
+	// gcc and clang require enabling avx per function
+	#if defined(__GNUC__)
+		#define NESSENGINE_TARGET_AVX __attribute__((target("avx")))
+		#define NESSENGINE_TARGET_SSE2 __attribute__((target("sse2")))
+	#else
+		#define NESSENGINE_TARGET_AVX
+		#define NESSENGINE_TARGET_SSE2
+	#endif
+#endif
+
+namespace Ness
+{
+	namespace ParticlesKernels
+	{
+		// scalar kernels
+		static void multiply_add_scalar(float* values, const float* deltas, float factor, unsigned int count)
+		{
+			for (unsigned int i = 0; i < count; i++)
+			{
+				values[i] += deltas[i] * factor;
+			}
+		}
+
+		static void add_scalar_scalar(float* values, float scalar, unsigned int count)
+		{
+			for (unsigned int i = 0; i < count; i++)
+			{
+				values[i] += scalar;
+			}
+		}
+
+#ifdef NESSENGINE_PARTICLES_SIMD
+		// sse2 kernels (4 floats at a time, leftovers with scalar)
+		NESSENGINE_TARGET_SSE2 static void multiply_add_sse2(float* values, const float* deltas, float factor, unsigned int count)
+		{
+			__m128 factor4 = _mm_set1_ps(factor);
+			unsigned int i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 v = _mm_loadu_ps(values + i);
+				__m128 d = _mm_loadu_ps(deltas + i);
+				_mm_storeu_ps(values + i, _mm_add_ps(v, _mm_mul_ps(d, factor4)));
+			}
+			multiply_add_scalar(values + i, deltas + i, factor, count - i);
+		}
+
+		NESSENGINE_TARGET_SSE2 static void add_scalar_sse2(float* values, float scalar, unsigned int count)
+		{
+			__m128 scalar4 = _mm_set1_ps(scalar);
+			unsigned int i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				_mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), scalar4));
+			}
+			add_scalar_scalar(values + i, scalar, count - i);
+		}
+
+		// avx kernels (8 floats at a time, leftovers with scalar)
+		NESSENGINE_TARGET_AVX static void multiply_add_avx(float* values, const float* deltas, float factor, unsigned int count)
+		{
+			__m256 factor8 = _mm256_set1_ps(factor);
+			unsigned int i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 v = _mm256_loadu_ps(values + i);
+				__m256 d = _mm256_loadu_ps(deltas + i);
+				_mm256_storeu_ps(values + i, _mm256_add_ps(v, _mm256_mul_ps(d, factor8)));
+			}
+			multiply_add_scalar(values + i, deltas + i, factor, count - i);
+		}
+
+		NESSENGINE_TARGET_AVX static void add_scalar_avx(float* values, float scalar, unsigned int count)
+		{
+			__m256 scalar8 = _mm256_set1_ps(scalar);
+			unsigned int i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				_mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), scalar8));
+			}
+			add_scalar_scalar(values + i, scalar, count - i);
+		}
+#endif
+
+		// currently selected kernels
+		typedef void (*TMultiplyAddKernel)(float* values, const float* deltas, float factor, unsigned int count);
+		typedef void (*TAddScalarKernel)(float* values, float scalar, unsigned int count);
+		static TMultiplyAddKernel	g_multiply_add = nullptr;
+		static TAddScalarKernel		g_add_scalar = nullptr;
+		static ESimdLevel			g_simd_level = SIMD_NONE;
+
+		ESimdLevel get_supported_simd_level()
+		{
+#ifdef NESSENGINE_PARTICLES_SIMD
+			if (SDL_HasAVX())
+				return SIMD_AVX;
+			if (SDL_HasSSE2())
+				return SIMD_SSE2;
+#endif
+			return SIMD_NONE;
+		}
+
+		void set_simd_level(ESimdLevel level)
+		{
+			// can't use more than supported
+			ESimdLevel supported = get_supported_simd_level();
+			if (level > supported)
+				level = supported;
+
+			g_simd_level = level;
+			switch (level)
+			{
+#ifdef NESSENGINE_PARTICLES_SIMD
+			case SIMD_AVX:
+				g_multiply_add = multiply_add_avx;
+				g_add_scalar = add_scalar_avx;
+				break;
+			case SIMD_SSE2:
+				g_multiply_add = multiply_add_sse2;
+				g_add_scalar = add_scalar_sse2;
+				break;
+#endif
+			default:
+				g_multiply_add = multiply_add_scalar;
+				g_add_scalar = add_scalar_scalar;
+				break;
+			}
+		}
+
+		// select the best supported kernels when the engine is loaded. this must not happen lazily on first use, since
+		// the first update of particles pools may run on several worker threads at once (see Renderer::set_parallel_particles()).
+		static struct SSelectDefaultKernels
+		{
+			SSelectDefaultKernels() {set_simd_level(get_supported_simd_level());}
+		} g_select_default_kernels;
+
+		ESimdLevel get_simd_level()
+		{
+			return g_simd_level;
+		}
+
+		void multiply_add(float* values, const float* deltas, float factor, unsigned int count)
+		{
+			g_multiply_add(values, deltas, factor, count);
+		}
+
+		void add_scalar(float* values, float scalar, unsigned int count)
+		{
+			g_add_scalar(values, scalar, count);
+		}
+	};
+};
@@ -0,0 +1,59 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+/**
+* Vectorized kernels used to update pooled particles arrays.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include "../../exports.h"
+
+namespace Ness
+{
+	namespace ParticlesKernels
+	{
+		// the instruction set used by the kernels
+		enum ESimdLevel
+		{
+			SIMD_NONE,		// plain scalar loops
+			SIMD_SSE2,		// 4 floats at a time
+			SIMD_AVX,		// 8 floats at a time
+		};
+
+		// return the best instruction set supported by this cpu (and by this build)
+		NESSENGINE_API ESimdLevel get_supported_simd_level();
+
+		// get/set the instruction set used by the kernels.
+		// by default the best supported level is selected when the engine is loaded. setting a level higher than supported will use the supported level.
+		// note: don't change the level while particles pools are updating (they may update on worker threads).
+		NESSENGINE_API ESimdLevel get_simd_level();
+		NESSENGINE_API void set_simd_level(ESimdLevel level);
+
+		// values[i] += deltas[i] * factor, for every i in count
+		NESSENGINE_API void multiply_add(float* values, const float* deltas, float factor, unsigned int count);
+
+		// values[i] += scalar, for every i in count
+		NESSENGINE_API void add_scalar(float* values, float scalar, unsigned int count);
+	};
+};
@@ -27,16 +27,62 @@
 
 namespace Ness
 {
+	// used to give every particles node a different default seed
+	static Uint32 g_particles_nodes_count = 0;
+
+	/**
+	* a task to simulate a pooled particles node on the renderer workers pool
+	*/
+	class ParticlesSimulationTask : public Utils::WorkerTask
+	{
+	private:
+		ParticlesNode*			m_node;
+		ParticlesPoolPtr		m_pool;
+		float					m_time_factor;
+		bool					m_emit;
+		unsigned int			m_existing_particles;
+		SRenderTransformations	m_trans;
+
+	public:
+		// note: the task keeps the pool alive, and the node joins the task before replacing its pool (see ParticlesNode::join_simulation())
+		ParticlesSimulationTask(ParticlesNode* node, float TimeFactor, bool emit, unsigned int ExistingParticles, const SRenderTransformations& trans)
+			: m_node(node), m_pool(node->m_pool), m_time_factor(TimeFactor), m_emit(emit), m_existing_particles(ExistingParticles), m_trans(trans)
+		{ }
+
+		virtual void execute()
+		{
+			m_pool->update(m_time_factor);
+			if (m_emit)
+			{
+				m_node->emit_particles(m_trans, m_existing_particles);
+			}
+		}
+	};
 
 	ParticlesNode::ParticlesNode(Renderer* renderer, const Size& BounderiesSize) 
 		: BaseNode(renderer), m_emit_while_not_visible(false), m_bounderies_size(BounderiesSize), m_time_since_last_emit(0.0f), 
-		m_is_currently_visible(true), m_is_emitting(true)
+		m_is_currently_visible(true), m_is_emitting(true), m_random_stream(++g_particles_nodes_count), m_random(0x853C49E6748FEA9BULL, m_random_stream),
+		m_animating_particles(false)
 	{
 		renderer->__register_animator_unsafe(this);
 	}
 
 	ParticlesNode::~ParticlesNode()
 	{
+		// make sure no worker is still simulating us
+		// (can't throw from destructor, so tasks errors are only logged)
+		if (m_pool && m_renderer->is_parallel_particles())
+		{
+			try
+			{
+				m_renderer->join_animation_tasks();
+			}
+			catch (...)
+			{
+				NESS_ERROR("exception in particles simulation task!");
+			}
+		}
+
 		if (m_animator_queue_parent)
 		{
 			m_animator_queue_parent->__remove_animator_unsafe(this);
@@ -52,60 +98,128 @@ namespace Ness
 		}
 	}
 	
+	void ParticlesNode::remove(const RenderablePtr& object)
+	{
+		if (m_animating_particles)
+		{
+			m_removed_while_animating.push_back(object);
+			return;
+		}
+		BaseNode::remove(object);
+	}
+
+	void ParticlesNode::enable_particles_pool(const String& TextureFile, unsigned int capacity)
+	{
+		enable_particles_pool(m_renderer->resources().get_texture(TextureFile), capacity);
+	}
+
+	void ParticlesNode::enable_particles_pool(const ManagedResources::ResourceName& TextureName, unsigned int capacity)
+	{
+		enable_particles_pool(m_renderer->resources().get_texture(TextureName), capacity);
+	}
+
+	void ParticlesNode::enable_particles_pool(const ManagedResources::ManagedTexturePtr& texture, unsigned int capacity)
+	{
+		join_simulation();
+		m_pool = ness_make_ptr<ParticlesPool>(texture, capacity ? capacity : m_settings.max_particles_count);
+	}
+
+	void ParticlesNode::disable_particles_pool()
+	{
+		join_simulation();
+		m_pool.reset();
+	}
+
+	void ParticlesNode::join_simulation()
+	{
+		// the simulation task may still be running on a worker (if this is called by an animator during the animation phase).
+		// note: joining returns immediately if there are no pending tasks.
+		if (m_pool)
+		{
+			m_renderer->join_animation_tasks();
+		}
+	}
+
 	void ParticlesNode::do_animation(Renderer* renderer)
 	{
-		// do animation of all the particles
+		// do animation of all the particles.
+		// note: particles that remove themselves are only removed after the loop, so they stay alive while animating.
+		m_animating_particles = true;
 		for (unsigned int i = 0; i < m_entities.size(); i++)
 		{
-			// try to get current entity as particle
-			ParticlePtr CurrParticle = ness_ptr_cast<Particle>(m_entities[i]);
-
-			// if really particle, active its animation
-			if (CurrParticle)
+			const RenderablePtr& curr = m_entities[i];
+			if (curr->is_kind(RENDERABLE_KIND_PARTICLE))
 			{
-				CurrParticle->do_animation(renderer);
+				ness_kind_cast<Particle>(curr)->do_animation(renderer);
 			}
 		}
+		m_animating_particles = false;
+
+		// remove the particles that removed themselves
+		for (unsigned int i = 0; i < m_removed_while_animating.size(); i++)
+		{
+			BaseNode::remove(m_removed_while_animating[i]);
+		}
+		m_removed_while_animating.clear();
 
 		// check if should stop
+		bool emit = false;
 		if (((m_settings.stop_after_count > 0) && (m_total_particles_generated >= m_settings.stop_after_count)) || 
 			((m_settings.stop_after_seconds > 0.0f) && (m_time_actived >= m_settings.stop_after_seconds)))
 		{
 			if (m_settings.remove_when_done && get_particles_count() == 0)
 			{
 				remove_from_parent();
+				return;
 			}
-			return;
+		}
+		// check if its time to emit (if currently not emitting, skip)
+		else if (m_is_emitting)
+		{
+			// increase time passed since last time we emitted
+			m_time_since_last_emit += renderer->time_factor();
+			m_time_actived += renderer->time_factor();
+
+			// if not visible and not allowed to emit when not visible, skip
+			emit = (m_time_since_last_emit >= m_settings.emitting_interval) && (m_is_currently_visible || m_emit_while_not_visible);
 		}
 
-		// if currently not emitting return
-		if (m_is_emitting == false)
+		// update pooled particles and emit. in parallel mode, this is done on the workers pool and joined before rendering.
+		if (m_pool && m_settings.pool_emitter && renderer->is_parallel_particles())
 		{
+			if (emit)
+			{
+				m_time_since_last_emit = 0.0f;
+			}
+			renderer->push_animation_task(ness_make_ptr<ParticlesSimulationTask>(this, renderer->time_factor(), emit, 
+				get_particles_entities_count(), get_absolute_transformations()));
 			return;
 		}
 
-		// increase time passed since last time we emitted
-		m_time_since_last_emit += renderer->time_factor();
-		m_time_actived += renderer->time_factor();
+		// update pooled particles
+		if (m_pool)
+		{
+			m_pool->update(renderer->time_factor());
+		}
 
-		// check if its time to emit
-		if (m_time_since_last_emit >= m_settings.emitting_interval)
+		// emit new particles
+		if (emit)
 		{
-			// if not visible and not allowed to emit when not visible, skip
-			if (m_is_currently_visible || m_emit_while_not_visible)
-			{
-				invoke_emit();
-			}
+			invoke_emit();
 		}
 	}
 
 	unsigned int ParticlesNode::get_particles_count() const
+	{
+		return get_particles_entities_count() + (m_pool ? m_pool->get_count() : 0);
+	}
+
+	unsigned int ParticlesNode::get_particles_entities_count() const
 	{
 		unsigned int ret = 0;
 		for (unsigned int i = 0; i < m_entities.size(); i++)
 		{
-			// try to get current entity as particle
-			if (ness_ptr_cast<Particle>(m_entities[i]))
+			if (m_entities[i]->is_kind(RENDERABLE_KIND_PARTICLE))
 			{
 				ret++;
 			}
@@ -115,16 +229,23 @@ namespace Ness
 
 	bool remove_particles(const RenderablePtr& entity)
 	{
-		return ((bool)ness_ptr_cast<Particle>(entity));
+		return entity->is_kind(RENDERABLE_KIND_PARTICLE);
 	}
 
 	void ParticlesNode::reset(bool RemoveExistingParticles)
 	{
 		m_time_actived = 0.0f;
 		m_total_particles_generated = 0;
+		if (m_settings.random_seed)
+		{
+			m_random.set_seed(m_settings.random_seed, m_random_stream);
+		}
 		if (RemoveExistingParticles)
 		{
+			if (m_pool)
+				m_pool->clear();
 			m_entities.erase(std::remove_if(m_entities.begin(), m_entities.end(), remove_particles), m_entities.end());
+			rebuild_spatial_index();
 		}
 	}
 
@@ -162,6 +283,17 @@ namespace Ness
 	void ParticlesNode::render(const CameraApiPtr& camera)
 	{
 		BaseNode::render(camera);
+
+		// render pooled particles
+		if (m_visible && m_pool)
+		{
+			// get camera translation
+			Rectangle camera_offset;
+			const SRenderTransformations& trans = get_absolute_transformations();
+			camera->set_target_rect_only(this, camera_offset, trans);
+			m_pool->render(m_renderer, Point((float)camera_offset.x, (float)camera_offset.y), trans.color);
+		}
+
 		if (m_emit_while_not_visible == false)
 		{
 			m_is_currently_visible = is_really_visible(camera);
@@ -172,9 +304,14 @@ namespace Ness
 	{
 		// zero the time since last emit
 		m_time_since_last_emit = 0.0f;
+		emit_particles(get_absolute_transformations(), get_particles_entities_count());
+	}
 
+	void ParticlesNode::emit_particles(const SRenderTransformations& trans, unsigned int ExistingParticles)
+	{
 		// make sure we got emitting function
-		if (m_settings.particles_emitter == nullptr)
+		bool use_pool = (m_pool && m_settings.pool_emitter);
+		if (m_settings.particles_emitter == nullptr && !use_pool)
 		{
 			return;
 		}
@@ -185,14 +322,14 @@ namespace Ness
 		// check if we should skip this emittion event based on chance_to_emit
 		if (m_settings.chance_to_emit < 100)
 		{
-			if (rand() % 100 > m_settings.chance_to_emit)
+			if (m_random.rand_int(0, 100) > m_settings.chance_to_emit)
 			{
 				return;
 			}
 		}
 
 		// check if we don't have too much already
-		int QuotaLimit = (int)m_settings.max_particles_count - (int)get_particles_count();
+		int QuotaLimit = (int)m_settings.max_particles_count - (int)(ExistingParticles + (m_pool ? m_pool->get_count() : 0));
 		if (QuotaLimit <= 0)
 		{
 			return;
@@ -202,7 +339,7 @@ namespace Ness
 		unsigned int particlesToEmit;
 		if (m_settings.max_particles_emit > m_settings.min_particles_emit)
 		{
-			 particlesToEmit = m_settings.min_particles_emit + (rand() % (m_settings.max_particles_emit - m_settings.min_particles_emit));
+			 particlesToEmit = m_settings.min_particles_emit + (m_random.next() % (m_settings.max_particles_emit - m_settings.min_particles_emit));
 		}
 		else
 		{
@@ -230,15 +367,30 @@ namespace Ness
 			}
 		}
 
+		// generate the new pooled particles
+		if (use_pool)
+		{
+			SParticleData data;
+			for (unsigned int i = 0; i < particlesToEmit; i++)
+			{
+				data = SParticleData();
+				m_settings.pool_emitter->emit_particle(data, m_random);
+				if (!m_pool->emit(data, trans.position, trans.scale))
+					break;
+				m_total_particles_generated += 1;
+			}
+			return;
+		}
+
 		// generate the new particles!
 		for (unsigned int i = 0; i < particlesToEmit; i++)
 		{
-			ParticlePtr NewParticle = m_settings.particles_emitter->emit_particle(m_renderer);
+			ParticlePtr NewParticle = m_settings.particles_emitter->emit_particle(m_renderer, m_random);
 			if (NewParticle)
 			{
 				if (NewParticle->get_move_with_node() == false)
 				{
-					NewParticle->add_position(get_absolute_position());
+					NewParticle->add_position(trans.position);
 				}
 				add(NewParticle);
 				m_total_particles_generated += 1;
@@ -30,6 +30,7 @@
 #pragma once
 #include "node.h"
 #include "../entities/particle.h"
+#include "particles_pool.h"
 
 namespace Ness
 {
@@ -39,9 +40,15 @@ namespace Ness
 	class ParticlesEmitter
 	{
 	public:
+		NESSENGINE_API virtual ~ParticlesEmitter() {}
+
 		// the function to emit a single particle
 		// note: just create and return the particle instance, do not add it to any node!
-		NESSENGINE_API virtual ParticlePtr emit_particle(Renderer* renderer) = 0;
+		NESSENGINE_API virtual ParticlePtr emit_particle(Renderer* renderer) {return ParticlePtr();}
+
+		// emit a single particle using the particles node random generator.
+		// override this one instead of emit_particle(renderer) and use random instead of rand() to get reproducible particles.
+		NESSENGINE_API virtual ParticlePtr emit_particle(Renderer* renderer, RandomGenerator& random) {return emit_particle(renderer);}
 	};
 
 	/** 
@@ -70,10 +77,12 @@ namespace Ness
 		bool						remove_when_done;		// if have limit (stop_after_seconds or stop_after_count) and true, will remove the particle system when reaching limit.
 		float						emit_fading_rate;		// increase the emitting interval by this factor every time emitting particles is invoked (note: regardless of chance_to_emit)
 		SharedPtr<ParticlesEmitter>	particles_emitter;		// the callback to generate the particles.
+		SharedPtr<ParticlesPoolEmitter>	pool_emitter;		// the callback to generate pooled particles (used instead of particles_emitter when the node has a particles pool).
+		Uint32						random_seed;			// if not 0, the node random generator is seeded with this value whenever the node is reset, so emitting is reproducible.
 
 		SParticlesNodeEmitSettings(float EmitInterval = 1.0f, unsigned char ChanceToEmit = 100, unsigned int MinEmit = 1, unsigned int MaxEmit = 3, unsigned int MaxCount = 100) :
 			emitting_interval(EmitInterval), chance_to_emit(ChanceToEmit), min_particles_emit(MinEmit), max_particles_emit(MaxEmit), max_particles_count(MaxCount),
-				stop_after_seconds(0.0f), stop_after_count(0), emit_fading_rate(0.0f)
+				stop_after_seconds(0.0f), stop_after_count(0), emit_fading_rate(0.0f), random_seed(0)
 		{ }
 	};
 
@@ -91,6 +100,11 @@ namespace Ness
 		bool							m_is_currently_visible;
 		float							m_time_actived;
 		unsigned int					m_total_particles_generated;
+		ParticlesPoolPtr				m_pool;
+		Uint64							m_random_stream;					// this node random stream id (kept when re-seeding)
+		RandomGenerator					m_random;
+		bool							m_animating_particles;				// true while animating the son particles
+		Containers::Vector<RenderablePtr>	m_removed_while_animating;		// particles that removed themselves while animating
 
 	public:
 		// create the particles node and register/unregister to animators queue automatically
@@ -102,6 +116,10 @@ namespace Ness
 		// override the particles node function to remove from parent so we'll also unregister from animators queue
 		NESSENGINE_API virtual void remove_from_parent();
 
+		// remove a son particle.
+		// particles remove themselves while we animate them, in this case removal is delayed until all particles are animated.
+		NESSENGINE_API virtual void remove(const RenderablePtr& object);
+
 		// get how many particles we currently have
 		NESSENGINE_API unsigned int get_particles_count() const;
 
@@ -117,6 +135,32 @@ namespace Ness
 		// check if this particles system is visible using the particles system boundery size (set_bounderies_size())
 		NESSENGINE_API virtual bool is_really_visible(const CameraApiPtr& camera);
 
+		// particles are added and removed all the time and calculate their own transformations, so don't flatten them
+		NESSENGINE_API virtual bool __flatten_sons() const {return false;}
+
+		// enable particles pool mode.
+		// in this mode the node emits lightweight particles into a fixed-capacity pool (using the pool_emitter from the emit settings)
+		// instead of creating a Particle entity per particle. pooled particles are much faster to emit, update and render, but
+		// they all share the same texture and blend mode and don't support animators.
+		// capacity is the max particles count. if 0, will use max_particles_count from the emit settings.
+		NESSENGINE_API void enable_particles_pool(const String& TextureFile, unsigned int capacity = 0);
+		NESSENGINE_API void enable_particles_pool(const ManagedResources::ResourceName& TextureName, unsigned int capacity = 0);
+		NESSENGINE_API void enable_particles_pool(const ManagedResources::ManagedTexturePtr& texture, unsigned int capacity = 0);
+
+		// disable particles pool mode and remove all pooled particles
+		NESSENGINE_API void disable_particles_pool();
+
+		// get the particles pool (or empty pointer if not in particles pool mode)
+		NESSENGINE_API inline const ParticlesPoolPtr& get_particles_pool() const {return m_pool;}
+
+		// set the seed of this node random generator (used to decide when and how many particles to emit, and passed to the emitters).
+		// by default every particles node gets a different random stream by the order it was created.
+		// note: to keep the seed when the node is reset, use random_seed in the emit settings.
+		NESSENGINE_API inline void set_random_seed(Uint32 seed) {m_random.set_seed(seed, m_random_stream);}
+
+		// get this node random generator
+		NESSENGINE_API inline RandomGenerator& get_random() {return m_random;}
+
 		// get the particles emitter
 		NESSENGINE_API inline SharedPtr<ParticlesEmitter>& get_emitter() {return m_settings.particles_emitter;}
 
@@ -142,6 +186,20 @@ namespace Ness
 		// invoke emit event. will generate particles based on emit settings (might not generate anything if 
 		// chance to emit is less then 100)
 		NESSENGINE_API void invoke_emit();
+
+	private:
+		// emit particles using the given absolute transformations.
+		// ExistingParticles is how many particles entities we currently have (not including the pool).
+		// this may run from a worker thread (in parallel particles mode) so it only touches the node settings, counters and pool.
+		void emit_particles(const SRenderTransformations& trans, unsigned int ExistingParticles);
+
+		// count how many particles entities we have (not including the pool)
+		unsigned int get_particles_entities_count() const;
+
+		// wait until the parallel simulation task of this node is done, if running (must be called before replacing the pool)
+		void join_simulation();
+
+		friend class ParticlesSimulationTask;
 	};
 
 	// scene pointer
@@ -0,0 +1,152 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+#include "particles_pool.h"
+#include "particles_kernels.h"
+#include <algorithm>
+#include "../../renderer/renderer.h"
+
+namespace Ness
+{
+	ParticlesPool::ParticlesPool(const ManagedResources::ManagedTexturePtr& texture, unsigned int capacity)
+		: m_texture(texture), m_blend(BLEND_MODE_BLEND), m_capacity(0), m_count(0)
+	{
+		set_capacity(capacity);
+	}
+
+	void ParticlesPool::set_capacity(unsigned int capacity)
+	{
+		m_capacity = capacity;
+		if (m_count > m_capacity)
+			m_count = m_capacity;
+
+		m_pos_x.resize(capacity); m_pos_y.resize(capacity);
+		m_vel_x.resize(capacity); m_vel_y.resize(capacity);
+		m_r.resize(capacity); m_g.resize(capacity); m_b.resize(capacity); m_a.resize(capacity);
+		m_dr.resize(capacity); m_dg.resize(capacity); m_db.resize(capacity); m_da.resize(capacity);
+		m_width.resize(capacity); m_height.resize(capacity);
+		m_scale.resize(capacity); m_scale_change.resize(capacity);
+		m_rotation.resize(capacity); m_rotation_speed.resize(capacity);
+		m_ttl.resize(capacity);
+	}
+
+	bool ParticlesPool::emit(const SParticleData& particle, const Point& offset, const Size& scale)
+	{
+		if (m_count >= m_capacity)
+			return false;
+
+		unsigned int i = m_count++;
+		m_pos_x[i] = offset.x + particle.position.x * scale.x;
+		m_pos_y[i] = offset.y + particle.position.y * scale.y;
+		m_vel_x[i] = particle.velocity.x * scale.x;
+		m_vel_y[i] = particle.velocity.y * scale.y;
+		m_r[i] = particle.color.r; m_g[i] = particle.color.g; m_b[i] = particle.color.b; m_a[i] = particle.color.a;
+		m_dr[i] = particle.color_change.r; m_dg[i] = particle.color_change.g; m_db[i] = particle.color_change.b; m_da[i] = particle.color_change.a;
+		m_width[i] = particle.size.x * scale.x;
+		m_height[i] = particle.size.y * scale.y;
+		m_scale[i] = particle.scale;
+		m_scale_change[i] = particle.scale_change;
+		m_rotation[i] = particle.rotation;
+		m_rotation_speed[i] = particle.rotation_speed;
+		m_ttl[i] = particle.time_to_live;
+		return true;
+	}
+
+	void ParticlesPool::remove_particle(unsigned int index)
+	{
+		unsigned int last = --m_count;
+		m_pos_x[index] = m_pos_x[last]; m_pos_y[index] = m_pos_y[last];
+		m_vel_x[index] = m_vel_x[last]; m_vel_y[index] = m_vel_y[last];
+		m_r[index] = m_r[last]; m_g[index] = m_g[last]; m_b[index] = m_b[last]; m_a[index] = m_a[last];
+		m_dr[index] = m_dr[last]; m_dg[index] = m_dg[last]; m_db[index] = m_db[last]; m_da[index] = m_da[last];
+		m_width[index] = m_width[last]; m_height[index] = m_height[last];
+		m_scale[index] = m_scale[last]; m_scale_change[index] = m_scale_change[last];
+		m_rotation[index] = m_rotation[last]; m_rotation_speed[index] = m_rotation_speed[last];
+		m_ttl[index] = m_ttl[last];
+	}
+
+	void ParticlesPool::update(float time_factor)
+	{
+		if (m_count == 0)
+			return;
+
+		// integrate all properties with the vectorized kernels
+		unsigned int count = m_count;
+		ParticlesKernels::multiply_add(&m_pos_x[0], &m_vel_x[0], time_factor, count);
+		ParticlesKernels::multiply_add(&m_pos_y[0], &m_vel_y[0], time_factor, count);
+		ParticlesKernels::multiply_add(&m_r[0], &m_dr[0], time_factor, count);
+		ParticlesKernels::multiply_add(&m_g[0], &m_dg[0], time_factor, count);
+		ParticlesKernels::multiply_add(&m_b[0], &m_db[0], time_factor, count);
+		ParticlesKernels::multiply_add(&m_a[0], &m_da[0], time_factor, count);
+		ParticlesKernels::multiply_add(&m_scale[0], &m_scale_change[0], time_factor, count);
+		ParticlesKernels::multiply_add(&m_rotation[0], &m_rotation_speed[0], time_factor, count);
+		ParticlesKernels::add_scalar(&m_ttl[0], -time_factor, count);
+
+		// remove dead particles (out of time, faded out or scaled down to nothing)
+		for (unsigned int i = 0; i < m_count;)
+		{
+			if (m_ttl[i] <= 0.0f || m_a[i] <= 0.0f || m_scale[i] <= 0.0f)
+			{
+				remove_particle(i);
+				continue;
+			}
+			i++;
+		}
+	}
+
+	// clamp color component to 0-1 range
+	static inline float clamp_color(float value)
+	{
+		return value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+	}
+
+	void ParticlesPool::render(Renderer* renderer, const Point& camera_offset, const Color& color)
+	{
+		if (!m_texture || m_count == 0)
+			return;
+
+		// render all particles in screen. they all share the same texture and blend mode so they are batched by the renderer
+		const Sizei& screen = renderer->get_target_size();
+		Rectangle target;
+		Color particle_color;
+		Point anchor(0.5f, 0.5f);
+		for (unsigned int i = 0; i < m_count; i++)
+		{
+			// calc target rect (anchor is the particle center)
+			target.w = (int)ceil(m_width[i] * m_scale[i]);
+			target.h = (int)ceil(m_height[i] * m_scale[i]);
+			target.x = (int)floor(m_pos_x[i] + camera_offset.x - target.w * 0.5f);
+			target.y = (int)floor(m_pos_y[i] + camera_offset.y - target.h * 0.5f);
+
+			// cull out of screen particles (with margin for rotation)
+			int margin = std::max(target.w, target.h) / 2;
+			if (target.x - margin >= screen.x || target.y - margin >= screen.y || target.x + target.w + margin <= 0 || target.y + target.h + margin <= 0)
+				continue;
+
+			particle_color.r = clamp_color(m_r[i] * color.r);
+			particle_color.g = clamp_color(m_g[i] * color.g);
+			particle_color.b = clamp_color(m_b[i] * color.b);
+			particle_color.a = clamp_color(m_a[i] * color.a);
+			renderer->blit(m_texture, nullptr, target, m_blend, particle_color, m_rotation[i], anchor);
+		}
+	}
+};
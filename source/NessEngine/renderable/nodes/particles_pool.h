@@ -0,0 +1,142 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+/**
+* A fixed-capacity pool of lightweight particles, stored as structure of arrays.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include "../../exports.h"
+#include "../../basic_types/containers.h"
+#include "../../basic_types/size.h"
+#include "../../basic_types/color.h"
+#include "../../basic_types/random.h"
+#include "../../managed_resources/managed_texture.h"
+#include "../transformations.h"
+
+namespace Ness
+{
+	// predeclare renderer
+	class Renderer;
+
+	/**
+	* the properties of a new pooled particle.
+	* emitters fill this struct when emitting, and the pool copies it into its arrays.
+	*/
+	struct SParticleData
+	{
+		Point		position;		// starting position, relative to the particles node
+		Point		velocity;		// movement in pixels per second
+		Color		color;			// starting color
+		Color		color_change;	// color change per second (for example, alpha -1.0f will fade out in 1 second)
+		Size		size;			// particle size in pixels (before scale)
+		float		scale;			// starting scale
+		float		scale_change;	// scale change per second
+		float		rotation;		// starting rotation
+		float		rotation_speed;	// rotation change per second
+		float		time_to_live;	// seconds until the particle dies
+
+		SParticleData() : color(Color::WHITE), color_change(0, 0, 0, 0), size(16, 16), scale(1.0f), scale_change(0.0f),
+			rotation(0.0f), rotation_speed(0.0f), time_to_live(1.0f)
+		{ }
+	};
+
+	/**
+	* a class responsible to emit pooled particles as part of a particles node.
+	* unlike ParticlesEmitter, this emitter does not create objects - it only fills the properties of the new particle.
+	*/
+	class ParticlesPoolEmitter
+	{
+	public:
+		NESSENGINE_API virtual ~ParticlesPoolEmitter() {}
+
+		// fill the properties of a single new particle. particle is already set with default values.
+		// random is the particles node random generator - use it instead of rand() so emitting is deterministic.
+		// note: if the renderer is in parallel particles mode this is called from a worker thread, so don't touch shared state!
+		NESSENGINE_API virtual void emit_particle(SParticleData& particle, RandomGenerator& random) = 0;
+	};
+
+	/**
+	* a pool of particles with a fixed capacity.
+	* particles are stored as structure of arrays (array per property) so updating them is a tight loop without any allocations
+	* or virtual calls, and they are rendered as blits of the same texture, which the renderer can batch together.
+	*/
+	class ParticlesPool
+	{
+	private:
+		ManagedResources::ManagedTexturePtr		m_texture;			// texture used for all particles
+		EBlendModes								m_blend;			// blend mode used for all particles
+		unsigned int							m_capacity;			// max particles count
+		unsigned int							m_count;			// current particles count
+
+		// particles properties (structure of arrays)
+		Containers::Vector<float>				m_pos_x, m_pos_y;
+		Containers::Vector<float>				m_vel_x, m_vel_y;
+		Containers::Vector<float>				m_r, m_g, m_b, m_a;
+		Containers::Vector<float>				m_dr, m_dg, m_db, m_da;
+		Containers::Vector<float>				m_width, m_height;
+		Containers::Vector<float>				m_scale, m_scale_change;
+		Containers::Vector<float>				m_rotation, m_rotation_speed;
+		Containers::Vector<float>				m_ttl;
+
+	public:
+		// create the pool with texture to use and max particles count
+		NESSENGINE_API ParticlesPool(const ManagedResources::ManagedTexturePtr& texture, unsigned int capacity);
+
+		// add a new particle. offset is added to the particle position (the particles node absolute position) and scale is the node scale.
+		// return false if pool is full.
+		NESSENGINE_API bool emit(const SParticleData& particle, const Point& offset, const Size& scale);
+
+		// update all particles and remove the dead ones
+		// time_factor is the time passed, in seconds
+		NESSENGINE_API void update(float time_factor);
+
+		// remove all particles
+		NESSENGINE_API inline void clear() {m_count = 0;}
+
+		// return how many particles are currently alive / max particles count
+		NESSENGINE_API inline unsigned int get_count() const {return m_count;}
+		NESSENGINE_API inline unsigned int get_capacity() const {return m_capacity;}
+
+		// change the capacity of the pool. if smaller than current count, extra particles are removed.
+		NESSENGINE_API void set_capacity(unsigned int capacity);
+
+		// set/get particles texture and blend mode
+		NESSENGINE_API inline void set_texture(const ManagedResources::ManagedTexturePtr& texture) {m_texture = texture;}
+		NESSENGINE_API inline const ManagedResources::ManagedTexturePtr& get_texture() const {return m_texture;}
+		NESSENGINE_API inline void set_blend_mode(EBlendModes blend) {m_blend = blend;}
+		NESSENGINE_API inline EBlendModes get_blend_mode() const {return m_blend;}
+
+		// render all particles.
+		// camera_offset is added to all particles positions (camera translation), and color is multiplied by the particles color.
+		NESSENGINE_API void render(Renderer* renderer, const Point& camera_offset, const Color& color);
+
+	private:
+		// remove a particle by moving the last particle into its slot
+		void remove_particle(unsigned int index);
+	};
+
+	// particles pool pointer
+	NESSENGINE_API typedef SharedPtr<ParticlesPool> ParticlesPoolPtr;
+};
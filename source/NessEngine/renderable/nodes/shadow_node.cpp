@@ -33,6 +33,7 @@ namespace Ness
 		set_color(color);
 		set_blend_mode(BLEND_MODE_BLEND);
 		m_need_redraw = true;
+		m_kind |= RENDERABLE_KIND_SHADOW;
 	}
 
 	void Shadow::transformations_update()
@@ -104,17 +105,18 @@ namespace Ness
 	{
 		for (unsigned int i = 0; i < m_entities.size(); i++)
 		{
-			ShadowPtr curr = ness_ptr_cast<Shadow>(m_entities[i]);
-			if (curr->is_really_visible_const(camera))
+			// note: we only allow shadows in this node so no need to check type
+			const RenderablePtr& curr = m_entities[i];
+			if (ness_kind_cast<Shadow>(curr)->is_really_visible_const(camera))
 			{
-				out_list.push_back(curr);
+				out_list.push_back(ness_static_ptr_cast<Shadow>(curr));
 			}
 		}
 	}
 
 	void ShadowNode::add(const RenderablePtr& object)
 	{
-		if (ness_ptr_cast<Shadow>(object) == nullptr)
+		if (!object->is_kind(RENDERABLE_KIND_SHADOW))
 		{
 			throw IllegalAction("Can only add shadows to a shadow node!");
 		}
@@ -147,6 +149,9 @@ namespace Ness
 		if (!m_visible)
 			return;
 
+		// update if parents moved
+		__get_transformations_generation();
+
 		// if always-update is set to true:
 		if (m_always_update)
 		{
@@ -167,7 +172,7 @@ namespace Ness
 		// stop the loop when looping all objects or once need update is true.
 		for (unsigned int i = 0; ((i < m_entities.size()) && !m_need_update); i++)
 		{
-			m_need_update = ness_ptr_cast<Shadow>(m_entities[i])->need_redraw();
+			m_need_update = ness_kind_cast<Shadow>(m_entities[i])->need_redraw();
 		}
 		
 		// if got here and don't need update, only render the canvas and return
@@ -189,7 +194,7 @@ namespace Ness
 		m_renderer->push_render_target(m_canvas->get_texture());
 		for (unsigned int i = 0; i < m_entities.size(); i++)
 		{
-			ness_ptr_cast<Shadow>(m_entities[i])->set_need_redraw(false);
+			ness_kind_cast<Shadow>(m_entities[i])->set_need_redraw(false);
 			m_entities[i]->render(camera);
 		}
 		m_renderer->pop_render_target();
@@ -0,0 +1,325 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+#include "spatial_grid.h"
+#include <algorithm>
+
+namespace Ness
+{
+	// divide and round down (also for negative values)
+	static inline int floor_div(int value, int divider)
+	{
+		return (value >= 0) ? (value / divider) : -((-value + divider - 1) / divider);
+	}
+
+	// sort items by their order
+	static bool sort_by_order(const SSpatialGridItem* a, const SSpatialGridItem* b)
+	{
+		return a->order < b->order;
+	}
+
+	SpatialGrid::SpatialGrid(const Sizei& cellSize) : m_cell_size(cellSize), m_query_stamp(0), m_max_cells_per_item(64), m_dirty_lock(0)
+	{
+		if (m_cell_size.x <= 0 || m_cell_size.y <= 0)
+			throw IllegalAction("Spatial grid cell size must be positive!");
+	}
+
+	void SpatialGrid::insert(const RenderablePtr& renderable, int order)
+	{
+		// already in grid? just update order
+		auto existing = m_items_index.find(renderable.get());
+		if (existing != m_items_index.end())
+		{
+			m_items[existing->second].order = order;
+			mark_dirty(renderable.get());
+			return;
+		}
+
+		// get free slot for the new item
+		unsigned int index;
+		if (!m_free_items.empty())
+		{
+			index = m_free_items.back();
+			m_free_items.pop_back();
+		}
+		else
+		{
+			index = (unsigned int)m_items.size();
+			m_items.push_back(SSpatialGridItem());
+		}
+
+		// set the item. its region will be calculated on next update
+		SSpatialGridItem& item = m_items[index];
+		item.renderable = renderable;
+		item.entity = renderable->is_entity() ? static_cast<EntityAPI*>(renderable.get()) : nullptr;
+		item.order = order;
+		item.query_stamp = 0;
+		item.in_cells = false;
+		item.in_always = false;
+		item.alive = true;
+		item.dirty = true;
+		m_dirty_items.push_back(index);
+		m_items_index[renderable.get()] = index;
+	}
+
+	void SpatialGrid::remove(RenderableAPI* renderable)
+	{
+		auto existing = m_items_index.find(renderable);
+		if (existing == m_items_index.end())
+			return;
+
+		unsigned int index = existing->second;
+		m_items_index.erase(existing);
+
+		// remove from cells or from the always-return list
+		SSpatialGridItem& item = m_items[index];
+		if (item.in_cells)
+			remove_from_cells(index);
+		if (item.in_always)
+			m_always_items.erase(std::find(m_always_items.begin(), m_always_items.end(), index));
+
+		// free the slot
+		item.renderable.reset();
+		item.entity = nullptr;
+		item.alive = false;
+		item.in_cells = item.in_always = item.dirty = false;
+		m_free_items.push_back(index);
+	}
+
+	void SpatialGrid::clear()
+	{
+		m_items.clear();
+		m_free_items.clear();
+		m_always_items.clear();
+		m_dirty_items.clear();
+		m_items_index.clear();
+		m_cells.clear();
+	}
+
+	void SpatialGrid::mark_dirty(RenderableAPI* renderable)
+	{
+		auto existing = m_items_index.find(renderable);
+		if (existing == m_items_index.end())
+			return;
+
+		SSpatialGridItem& item = m_items[existing->second];
+		SDL_AtomicLock(&m_dirty_lock);
+		if (!item.dirty)
+		{
+			item.dirty = true;
+			m_dirty_items.push_back(existing->second);
+		}
+		SDL_AtomicUnlock(&m_dirty_lock);
+	}
+
+	void SpatialGrid::mark_all_dirty()
+	{
+		for (unsigned int i = 0; i < m_items.size(); i++)
+		{
+			if (m_items[i].alive && !m_items[i].dirty)
+			{
+				m_items[i].dirty = true;
+				m_dirty_items.push_back(i);
+			}
+		}
+	}
+
+	void SpatialGrid::update()
+	{
+		for (unsigned int i = 0; i < m_dirty_items.size(); i++)
+		{
+			unsigned int index = m_dirty_items[i];
+			if (m_items[index].alive && m_items[index].dirty)
+				update_item(index);
+		}
+		m_dirty_items.clear();
+	}
+
+	void SpatialGrid::update_item(unsigned int item_index)
+	{
+		SSpatialGridItem& item = m_items[item_index];
+
+		// calculate the new region and cells range.
+		// only non-static entities are put in cells (nodes and static entities are always returned)
+		bool put_in_cells = false;
+		Rectangle rect;
+		Rectangle cells;
+		if (item.entity && !item.entity->is_static())
+		{
+			// get target rect (fix negative size from flipping)
+			const SRenderTransformations& trans = item.entity->get_absolute_transformations();
+			rect = item.entity->get_last_target_rect();
+			if (rect.w < 0) {rect.x += rect.w; rect.w *= -1;}
+			if (rect.h < 0) {rect.y += rect.h; rect.h *= -1;}
+
+			// if rotated, take the region the rect can rotate in
+			if (trans.rotation != 0.0f)
+			{
+				int extra = std::max(rect.w, rect.h) / 2 + 1;
+				rect.x -= extra; rect.y -= extra;
+				rect.w += extra * 2; rect.h += extra * 2;
+			}
+
+			cells.x = floor_div(rect.x, m_cell_size.x);
+			cells.y = floor_div(rect.y, m_cell_size.y);
+			cells.w = floor_div(rect.x + rect.w, m_cell_size.x);
+			cells.h = floor_div(rect.y + rect.h, m_cell_size.y);
+			put_in_cells = ((unsigned int)((cells.w - cells.x + 1) * (cells.h - cells.y + 1)) <= m_max_cells_per_item);
+		}
+		item.rect = rect;
+
+		// note: clear the dirty flag only after reading transformations, since reading them may mark the item dirty again
+		item.dirty = false;
+
+		// still in the same cells? nothing to do
+		if (put_in_cells && item.in_cells && SDL_RectEquals(&cells, &item.cells))
+			return;
+
+		// remove from previous location
+		if (item.in_cells)
+			remove_from_cells(item_index);
+		if (item.in_always && !put_in_cells)
+			return;
+		if (item.in_always)
+		{
+			m_always_items.erase(std::find(m_always_items.begin(), m_always_items.end(), item_index));
+			item.in_always = false;
+		}
+
+		// add to new location
+		if (put_in_cells)
+		{
+			item.cells = cells;
+			add_to_cells(item_index);
+		}
+		else
+		{
+			m_always_items.push_back(item_index);
+			item.in_always = true;
+		}
+	}
+
+	void SpatialGrid::add_to_cells(unsigned int item_index)
+	{
+		SSpatialGridItem& item = m_items[item_index];
+		for (int x = item.cells.x; x <= item.cells.w; x++)
+		{
+			for (int y = item.cells.y; y <= item.cells.h; y++)
+			{
+				m_cells[get_cell_key(x, y)].push_back(item_index);
+			}
+		}
+		item.in_cells = true;
+	}
+
+	void SpatialGrid::remove_from_cells(unsigned int item_index)
+	{
+		SSpatialGridItem& item = m_items[item_index];
+		for (int x = item.cells.x; x <= item.cells.w; x++)
+		{
+			for (int y = item.cells.y; y <= item.cells.h; y++)
+			{
+				auto cell = m_cells.find(get_cell_key(x, y));
+				if (cell == m_cells.end())
+					continue;
+
+				// remove item from cell (order inside cells doesn't matter). remove empty cells
+				Containers::Vector<unsigned int>& items = cell->second;
+				auto in_cell = std::find(items.begin(), items.end(), item_index);
+				if (in_cell != items.end())
+				{
+					*in_cell = items.back();
+					items.pop_back();
+				}
+				if (items.empty())
+					m_cells.erase(cell);
+			}
+		}
+		item.in_cells = false;
+	}
+
+	void SpatialGrid::query(const Rectangle& region, Containers::Vector<const SSpatialGridItem*>& out_items)
+	{
+		// make sure all items are up-to-date
+		update();
+		m_query_stamp++;
+		size_t first_result = out_items.size();
+
+		// range of cells to check
+		int first_x = floor_div(region.x, m_cell_size.x);
+		int first_y = floor_div(region.y, m_cell_size.y);
+		int last_x = floor_div(region.x + region.w, m_cell_size.x);
+		int last_y = floor_div(region.y + region.h, m_cell_size.y);
+
+		// add all the items in the cells that touch the region
+		// if the region covers more cells than we actually have, iterate the existing cells instead
+		float region_cells = (float)(last_x - first_x + 1) * (float)(last_y - first_y + 1);
+		if (region_cells <= (float)m_cells.size())
+		{
+			for (int x = first_x; x <= last_x; x++)
+			{
+				for (int y = first_y; y <= last_y; y++)
+				{
+					auto cell = m_cells.find(get_cell_key(x, y));
+					if (cell == m_cells.end())
+						continue;
+
+					const Containers::Vector<unsigned int>& items = cell->second;
+					for (unsigned int i = 0; i < items.size(); i++)
+					{
+						SSpatialGridItem& item = m_items[items[i]];
+						if (item.query_stamp == m_query_stamp)
+							continue;
+						item.query_stamp = m_query_stamp;
+						if (SDL_HasIntersection(&item.rect, &region))
+							out_items.push_back(&item);
+					}
+				}
+			}
+		}
+		else
+		{
+			for (auto cell = m_cells.begin(); cell != m_cells.end(); ++cell)
+			{
+				const Containers::Vector<unsigned int>& items = cell->second;
+				for (unsigned int i = 0; i < items.size(); i++)
+				{
+					SSpatialGridItem& item = m_items[items[i]];
+					if (item.query_stamp == m_query_stamp)
+						continue;
+					item.query_stamp = m_query_stamp;
+					if (SDL_HasIntersection(&item.rect, &region))
+						out_items.push_back(&item);
+				}
+			}
+		}
+
+		// add the items that always return
+		for (unsigned int i = 0; i < m_always_items.size(); i++)
+		{
+			out_items.push_back(&m_items[m_always_items[i]]);
+		}
+
+		// sort the results by order
+		std::sort(out_items.begin() + first_result, out_items.end(), sort_by_order);
+	}
+};
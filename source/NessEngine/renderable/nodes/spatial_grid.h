@@ -0,0 +1,114 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+/**
+* A uniform grid that index renderables by their target rectangle, for fast region queries.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include <SDL.h>
+#include "../entity_api.h"
+#include "../node_api.h"
+#include "../../basic_types/containers.h"
+
+namespace Ness
+{
+	// a single renderable inside the spatial grid
+	struct SSpatialGridItem
+	{
+		RenderablePtr		renderable;		// the indexed renderable
+		EntityAPI*			entity;			// the renderable as entity (or nullptr if not an entity, in which case it is never culled by the grid)
+		Rectangle			rect;			// the region this item occupies
+		Rectangle			cells;			// range of cells this item is in (x, y is first cell, w, h is last cell)
+		int					order;			// the order of the item in its parent node
+		unsigned int		query_stamp;	// used to avoid returning the same item twice in a query
+		bool				in_cells;		// true if the item is inside the cells
+		bool				in_always;		// true if the item is in the list of items that always return
+		bool				dirty;			// true if need to recalculate the item region
+		bool				alive;			// false for removed items (slots that wait to be reused)
+	};
+
+	/**
+	* spatial grid divide the world into cells and keep which renderables are in every cell, based on their target rectangle.
+	* used by nodes to cull and query their son entities without iterating all of them.
+	* nodes, static entities and very large entities are not put in cells and are always returned by queries.
+	*/
+	class SpatialGrid
+	{
+	private:
+		Sizei													m_cell_size;		// size of a single cell
+		Containers::Vector<SSpatialGridItem>					m_items;			// all the items
+		Containers::Vector<unsigned int>						m_free_items;		// indexes of removed items we can reuse
+		Containers::Vector<unsigned int>						m_always_items;		// items that are not in cells and should always return
+		Containers::Vector<unsigned int>						m_dirty_items;		// items that need to recalculate their region
+		Containers::UnorderedMap<RenderableAPI*, unsigned int>	m_items_index;		// index of item for every renderable
+		Containers::UnorderedMap<Uint64, Containers::Vector<unsigned int> >	m_cells;	// the cells, with list of items in every cell
+		unsigned int											m_query_stamp;		// increase with every query
+		unsigned int											m_max_cells_per_item;	// items that cover more cells than this are always returned
+		SDL_SpinLock											m_dirty_lock;		// protect the dirty list (thread-safe animators may mark items dirty from workers)
+
+	public:
+		// create the spatial grid with a given cell size
+		NESSENGINE_API SpatialGrid(const Sizei& cellSize = Sizei(256, 256));
+
+		// add/remove renderable from grid.
+		// order is the renderable order in its parent, queries return items sorted by it.
+		NESSENGINE_API void insert(const RenderablePtr& renderable, int order);
+		NESSENGINE_API void remove(RenderableAPI* renderable);
+		NESSENGINE_API void clear();
+
+		// mark that a renderable transformations changed, and its region needs to be recalculated before next query
+		NESSENGINE_API void mark_dirty(RenderableAPI* renderable);
+
+		// mark all items as dirty (for example when parent node moves)
+		NESSENGINE_API void mark_all_dirty();
+
+		// recalculate the region of all dirty items
+		NESSENGINE_API void update();
+
+		// return all the items that may touch the given region (plus all the items that always return), sorted by their order.
+		// note: items are returned by their cells, so you still need to test them for exact collision.
+		NESSENGINE_API void query(const Rectangle& region, Containers::Vector<const SSpatialGridItem*>& out_items);
+
+		// return cell size
+		NESSENGINE_API inline const Sizei& get_cell_size() const {return m_cell_size;}
+
+		// return how many items are in the grid
+		NESSENGINE_API inline unsigned int get_items_count() const {return (unsigned int)m_items_index.size();}
+
+	private:
+		// get the key of a cell from its index
+		inline Uint64 get_cell_key(int x, int y) const {return ((Uint64)(Uint32)x << 32) | (Uint64)(Uint32)y;}
+
+		// add/remove item to/from the cells it covers
+		void add_to_cells(unsigned int item_index);
+		void remove_from_cells(unsigned int item_index);
+
+		// recalculate the region of a single item
+		void update_item(unsigned int item_index);
+	};
+
+	// spatial grid pointer
+	NESSENGINE_API typedef SharedPtr<SpatialGrid> SpatialGridPtr;
+};
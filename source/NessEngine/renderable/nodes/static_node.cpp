@@ -149,6 +149,8 @@ namespace Ness
 		if (removeEntities)
 		{
 			m_entities.clear();
+			rebuild_spatial_index();
+			__structure_changed();
 		}
 	}
 
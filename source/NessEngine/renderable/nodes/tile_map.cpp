@@ -22,11 +22,19 @@
 
 #include "../../renderer/renderer.h"
 #include "tile_map.h"
+#include "../../scene/camera/basic_camera.h"
 
 namespace Ness
 {
 	const SRenderTransformations& TileMap::get_absolute_transformations()
 	{
+		// while building a cached chunk tiles are rendered in the tilemap local space
+		if (m_building_chunk)
+		{
+			static SRenderTransformations identity;
+			return identity;
+		}
+
 		// if don't have a parent, return self transformations
 		if (!m_parent)
 			return m_transformations;
@@ -40,12 +48,16 @@ namespace Ness
 	TileMap::TileMap(Renderer* renderer, const String& spriteFile, const Sizei& mapSize, 
 		const Size& singleTileSize, const Size& tilesDistance, TCreateTileSprites createSpriteFunction) 
 		: NodeAPI(renderer), m_size(mapSize), m_tile_size(singleTileSize), m_extra_tiles_factor(0, 0),
-			m_last_render_frame_id(0), m_last_update_frame_id(0)
+			m_last_render_frame_id(0), m_last_update_frame_id(0), m_chunk_size(0, 0), m_chunks_count(0, 0), m_building_chunk(false), m_verify_chunks(false)
 	{
+		static unsigned int UniqueIds = 0;
+		m_unique_id = UniqueIds++;
+
 		// set distance between sprites (either sprite size or provided distance)
 		m_sprites_distance = (tilesDistance == Size::ZERO ? singleTileSize : tilesDistance);
 
-		// create the sprites grid
+		// create the sprites grid (all tiles use the same texture, so hash its name only once)
+		ManagedResources::ResourceName spriteName(spriteFile);
 		Pointi index;
 		m_sprites = new SpritePtr*[m_size.x];
 		m_tile_last_updated = new unsigned int*[m_size.x];
@@ -59,7 +71,7 @@ namespace Ness
 				SpritePtr NewSprite;
 				if (createSpriteFunction == nullptr)
 				{
-					NewSprite = ness_make_ptr<Sprite>(this->m_renderer, spriteFile);
+					NewSprite = ness_make_ptr<Sprite>(this->m_renderer, spriteName);
 					NewSprite->set_blend_mode(BLEND_MODE_NONE);
 				}
 				else
@@ -73,6 +85,7 @@ namespace Ness
 
 				// add to matrix of tiles
 				m_sprites[index.x][index.y] = NewSprite;
+				m_tiles_index[NewSprite.get()] = index;
 				m_tile_last_updated[index.x][index.y] = 0;
 			}
 		}
@@ -150,6 +163,231 @@ namespace Ness
 	void TileMap::transformations_update()
 	{
 		m_last_update_frame_id = m_renderer->get_frameid();
+		m_trans_generation++;
+	}
+
+	void TileMap::enable_chunks_cache(const Sizei& chunkSize)
+	{
+		if (chunkSize.x <= 0 || chunkSize.y <= 0)
+			throw IllegalAction("Tilemap chunks size must be positive!");
+
+		// release previous chunks (if any) and create the new empty chunks
+		disable_chunks_cache();
+		m_chunk_size = chunkSize;
+		m_chunks_count.x = (m_size.x + chunkSize.x - 1) / chunkSize.x;
+		m_chunks_count.y = (m_size.y + chunkSize.y - 1) / chunkSize.y;
+		m_chunks.resize(m_chunks_count.x * m_chunks_count.y);
+	}
+
+	void TileMap::disable_chunks_cache()
+	{
+		for (unsigned int i = 0; i < m_chunks.size(); i++)
+		{
+			if (m_chunks[i].canvas)
+				m_chunks[i].canvas->__change_parent(nullptr);
+		}
+		m_chunks.clear();
+		m_chunk_size = m_chunks_count = Sizei(0, 0);
+	}
+
+	void TileMap::invalidate_chunks_cache()
+	{
+		for (unsigned int i = 0; i < m_chunks.size(); i++)
+		{
+			m_chunks[i].dirty = true;
+		}
+	}
+
+	void TileMap::set_chunks_verification(bool enabled)
+	{
+		m_verify_chunks = enabled;
+		if (!m_verify_chunks)
+		{
+			for (unsigned int i = 0; i < m_chunks.size(); i++)
+			{
+				m_chunks[i].snapshot.clear();
+			}
+		}
+		invalidate_chunks_cache();
+	}
+
+	void TileMap::__son_transformations_update(RenderableAPI* son)
+	{
+		invalidate_tile_chunk(son);
+		forward_son_update(son);
+	}
+
+	void TileMap::__son_appearance_update(RenderableAPI* son)
+	{
+		invalidate_tile_chunk(son);
+	}
+
+	void TileMap::invalidate_tile_chunk(RenderableAPI* tile)
+	{
+		// no chunks, or this is the chunk build itself
+		if (m_chunks.empty() || m_building_chunk)
+			return;
+
+		// tiles are arranged on a grid, so we can find the tile index from its position
+		Point pos = tile->get_position();
+		Pointi index((int)floor(pos.x / m_sprites_distance.x + 0.5f), (int)floor(pos.y / m_sprites_distance.y + 0.5f));
+		if (index.x < 0 || index.y < 0 || index.x >= m_size.x || index.y >= m_size.y || m_sprites[index.x][index.y].get() != tile)
+		{
+			// the tile was moved from its place on the grid (or it's not a tile, like the chunks canvases). find it by pointer
+			auto found = m_tiles_index.find(tile);
+			if (found == m_tiles_index.end() || m_sprites[found->second.x][found->second.y].get() != tile)
+				return;
+			index = found->second;
+		}
+
+		m_chunks[(index.x / m_chunk_size.x) + (index.y / m_chunk_size.y) * m_chunks_count.x].dirty = true;
+	}
+
+	void TileMap::take_tile_snapshot(const SpritePtr& tile, STileSnapshot& out) const
+	{
+		out.texture = tile->get_texture().get();
+		out.source = tile->get_source_rect();
+		out.color = tile->get_color();
+		out.blend = tile->get_blend_mode();
+		out.visible = tile->is_visible();
+	}
+
+	Rectangle TileMap::get_chunks_in_range(const Rectangle& tilesRange) const
+	{
+		Rectangle ret;
+		ret.x = tilesRange.x / m_chunk_size.x;
+		ret.y = tilesRange.y / m_chunk_size.y;
+		ret.w = (tilesRange.w + m_chunk_size.x - 1) / m_chunk_size.x;
+		ret.h = (tilesRange.h + m_chunk_size.y - 1) / m_chunk_size.y;
+		return ret;
+	}
+
+	bool TileMap::is_chunk_dirty(const Pointi& chunk) const
+	{
+		const STileMapChunk& curr = m_chunks[chunk.x + chunk.y * m_chunks_count.x];
+
+		// never built, or one of the tiles changed?
+		if (curr.dirty)
+			return true;
+
+		// debug check: compare all tiles to their state when the chunk was built
+		if (!m_verify_chunks || curr.snapshot.empty())
+			return false;
+		int start_i = chunk.x * m_chunk_size.x;
+		int start_j = chunk.y * m_chunk_size.y;
+		int end_i = std::min(start_i + m_chunk_size.x, m_size.x);
+		int end_j = std::min(start_j + m_chunk_size.y, m_size.y);
+		unsigned int index = 0;
+		STileSnapshot state;
+		for (int i = start_i; i < end_i; i++)
+		{
+			for (int j = start_j; j < end_j; j++)
+			{
+				const STileSnapshot& old_state = curr.snapshot[index++];
+				take_tile_snapshot(m_sprites[i][j], state);
+				if (state.texture != old_state.texture || !SDL_RectEquals(&state.source, &old_state.source) || !(state.color == old_state.color) ||
+					state.blend != old_state.blend || state.visible != old_state.visible)
+				{
+					NESS_ERROR("tilemap tile changed without invalidating its chunk!");
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	void TileMap::build_chunk(const Pointi& chunk)
+	{
+		STileMapChunk& curr = m_chunks[chunk.x + chunk.y * m_chunks_count.x];
+		int start_i = chunk.x * m_chunk_size.x;
+		int start_j = chunk.y * m_chunk_size.y;
+		int end_i = std::min(start_i + m_chunk_size.x, m_size.x);
+		int end_j = std::min(start_j + m_chunk_size.y, m_size.y);
+
+		// calculate the tiles in local space and take the tiles snapshot (if verifying chunks)
+		m_building_chunk = true;
+		curr.snapshot.resize(m_verify_chunks ? (end_i - start_i) * (end_j - start_j) : 0);
+		unsigned int index = 0;
+		Rectangle bounds;
+		for (int i = start_i; i < end_i; i++)
+		{
+			for (int j = start_j; j < end_j; j++)
+			{
+				SpritePtr& tile = m_sprites[i][j];
+				if (m_verify_chunks)
+					take_tile_snapshot(tile, curr.snapshot[index]);
+				index++;
+				tile->transformations_update();
+				tile->get_absolute_transformations();
+
+				// add tile to chunk bounds (fix negative size from flipping)
+				Rectangle tile_rect = tile->get_last_target_rect();
+				if (tile_rect.w < 0) {tile_rect.x += tile_rect.w; tile_rect.w *= -1;}
+				if (tile_rect.h < 0) {tile_rect.y += tile_rect.h; tile_rect.h *= -1;}
+				if (index == 1)
+				{
+					bounds = tile_rect;
+				}
+				else
+				{
+					SDL_UnionRect(&bounds, &tile_rect, &bounds);
+				}
+			}
+		}
+
+		// create the canvas (or recreate if chunk size changed)
+		Sizei canvas_size(bounds.w, bounds.h);
+		if (canvas_size.x > 0 && canvas_size.y > 0)
+		{
+			if (!curr.canvas || curr.canvas->get_texture()->get_size() != canvas_size)
+			{
+				if (curr.canvas)
+				{
+					curr.canvas->__change_parent(nullptr);
+					curr.canvas.reset();
+				}
+				String chunkName("tilemap" + ness_int_to_string(m_unique_id) + ".chunk." + ness_int_to_string(chunk.x) + "." + ness_int_to_string(chunk.y));
+				curr.canvas = ness_make_ptr<Canvas>(this->m_renderer, chunkName, canvas_size);
+				curr.canvas->set_blend_mode(BLEND_MODE_BLEND);
+				curr.canvas->__change_parent(this);
+			}
+			curr.canvas->set_position(Point((float)bounds.x, (float)bounds.y));
+			curr.canvas->clear();
+
+			// render the tiles on the chunk canvas, using a camera positioned at the chunk origin
+			CameraPtr tempCam = ness_make_ptr<BasicCamera>(renderer());
+			tempCam->position.x = (float)bounds.x;
+			tempCam->position.y = (float)bounds.y;
+			m_renderer->push_render_target(curr.canvas->get_texture());
+			for (int i = start_i; i < end_i; i++)
+			{
+				for (int j = start_j; j < end_j; j++)
+				{
+					m_sprites[i][j]->render(tempCam);
+				}
+			}
+			m_renderer->pop_render_target();
+		}
+
+		// tiles need to recalculate their absolute transformations with the real tilemap transformations
+		// (still building, so this won't invalidate the chunk again)
+		for (int i = start_i; i < end_i; i++)
+		{
+			for (int j = start_j; j < end_j; j++)
+			{
+				m_sprites[i][j]->transformations_update();
+				m_tile_last_updated[i][j] = m_last_update_frame_id;
+			}
+		}
+		m_building_chunk = false;
+		curr.dirty = false;
+	}
+
+	STileMapChunk& TileMap::get_updated_chunk(const Pointi& chunk)
+	{
+		if (is_chunk_dirty(chunk))
+			build_chunk(chunk);
+		return m_chunks[chunk.x + chunk.y * m_chunks_count.x];
 	}
 
 	void TileMap::destroy()
@@ -158,6 +396,9 @@ namespace Ness
 		if (m_sprites == nullptr)
 			return;
 
+		// release cached chunks
+		disable_chunks_cache();
+
 		// destroy all tiles in tilesmap
 		Sizei index;
 		for (index.x = 0; index.x < m_size.x; index.x++)
@@ -176,11 +417,29 @@ namespace Ness
 		delete[] m_sprites;
 		delete[] m_tile_last_updated;
 		m_sprites = nullptr;
+		m_tiles_index.clear();
 	}
 
 	void TileMap::__get_visible_entities(RenderablesList& out_list, const CameraApiPtr& camera, bool break_son_nodes)
 	{
 		Rectangle range = get_tiles_in_screen(camera);
+
+		// in chunks cache mode return the chunks canvases instead of the tiles
+		if (is_chunks_cache_enabled())
+		{
+			Rectangle chunks = get_chunks_in_range(range);
+			for (int cy = chunks.y; cy < chunks.h; cy++)
+			{
+				for (int cx = chunks.x; cx < chunks.w; cx++)
+				{
+					STileMapChunk& chunk = get_updated_chunk(Pointi(cx, cy));
+					if (chunk.canvas)
+						out_list.push_back(chunk.canvas);
+				}
+			}
+			return;
+		}
+
 		for (int i = range.x; i < range.w; i++)
 		{
 			for (int j = range.y; j < range.h; j++)
@@ -316,6 +575,9 @@ namespace Ness
 		if (!m_visible)
 			return;
 
+		// update if parents moved
+		__get_transformations_generation();
+
 		Rectangle range = get_tiles_in_screen(camera);
 		if (range.x == range.w || range.y == range.h)
 			return;
@@ -323,6 +585,22 @@ namespace Ness
 		// lastly rendered
 		m_last_render_frame_id = m_renderer->get_frameid();
 
+		// in chunks cache mode render the visible chunks (rebuild the ones that changed)
+		if (is_chunks_cache_enabled())
+		{
+			Rectangle chunks = get_chunks_in_range(range);
+			for (int cx = chunks.x; cx < chunks.w; cx++)
+			{
+				for (int cy = chunks.y; cy < chunks.h; cy++)
+				{
+					STileMapChunk& chunk = get_updated_chunk(Pointi(cx, cy));
+					if (chunk.canvas)
+						chunk.canvas->render(camera);
+				}
+			}
+			return;
+		}
+
 		// render all visible tiles
 		for (int i = range.x; i < range.w; i++)
 		{
@@ -29,6 +29,7 @@
 
 #pragma once
 #include "../entities/sprite.h"
+#include "../entities/canvas.h"
 #include "../transformable_api.h"
 #include "../node_api.h"
 #include "../../basic_types/containers.h"
@@ -41,6 +42,26 @@ namespace Ness
 	// callback function to create custom sprite types for the tilemap
 	NESSENGINE_API typedef SpritePtr (*TCreateTileSprites)(const Pointi& index);
 
+	// the properties of a tile that are baked into a cached chunk. used only to verify chunks invalidation (see set_chunks_verification())
+	struct STileSnapshot
+	{
+		ManagedResources::ManagedTexture*	texture;
+		Rectangle							source;
+		Color								color;
+		EBlendModes							blend;
+		bool								visible;
+	};
+
+	// a chunk of tiles pre-rendered into a canvas
+	struct STileMapChunk
+	{
+		CanvasPtr								canvas;			// the canvas this chunk is rendered on (empty until first built)
+		bool									dirty;			// true if one of the tiles changed since the chunk was built (or if it was never built)
+		Containers::Vector<STileSnapshot>		snapshot;		// the state of the tiles when the chunk was last built (only when verifying chunks)
+
+		STileMapChunk() : dirty(true) {}
+	};
+
 	/* 
 	* TileMap is a special node that creates a grid of sprites, mostly useable to represent the ground in an rpg game or the
 	* platforms in a platformer. highly optimized!
@@ -53,11 +74,18 @@ namespace Ness
 		Size													m_tile_size;				// size of a single tile
 		SpritePtr**												m_sprites;					// the sprites matrix
 		unsigned int**											m_tile_last_updated;		// the frame id of the last time every tile was updated
+		Containers::UnorderedMap<RenderableAPI*, Pointi>		m_tiles_index;				// index of every tile sprite (to find tiles that were moved from their grid position)
 		SRenderTransformations									m_absolute_transformations;	// absolute transformations of this tilemap
 		Sizei													m_extra_tiles_factor;		// extra tiles to render (count in screen) on eatch side of x and y axis
 		Point													m_tiles_anchor;				// the tiles default anchor
 		unsigned int											m_last_render_frame_id;		// return the frame id of the last time this nodesmap was really rendered
 		unsigned int											m_last_update_frame_id;		// return the frame id of the last time this nodesmap was updated
+		Sizei													m_chunk_size;				// size of a cached chunk in tiles (zero if chunks cache is disabled)
+		Sizei													m_chunks_count;				// how many chunks there are on x and y axis
+		Containers::Vector<STileMapChunk>						m_chunks;					// the cached chunks (row-major)
+		bool													m_building_chunk;			// true while rendering tiles into a chunk
+		bool													m_verify_chunks;			// if true, compare chunks tiles to their snapshot to catch changes that did not invalidate the chunk
+		unsigned int											m_unique_id;				// unique id used to name the chunks textures
 
 	public:
 
@@ -92,6 +120,31 @@ namespace Ness
 		// will count additional tile from top and bottom when rendering the tiles in screen
 		NESSENGINE_API inline void set_extra_tiles_in_screen(const Sizei& extra) {m_extra_tiles_factor = extra;}
 
+		// enable chunks cache mode.
+		// in this mode every block of chunkSize tiles is rendered once into a canvas, and the tilemap renders the whole chunks
+		// instead of tile by tile. a chunk is rebuilt only when one of its tiles changes (texture, source rect, transformations or visibility).
+		// use this for static layers like the ground. note: tilemap rotation is applied per chunk and not per tile, and if your tiles
+		// use alpha blending they will be blended on a transparent canvas.
+		NESSENGINE_API void enable_chunks_cache(const Sizei& chunkSize = Sizei(16, 16));
+
+		// disable chunks cache and release all the chunks textures
+		NESSENGINE_API void disable_chunks_cache();
+
+		// return if chunks cache mode is enabled
+		NESSENGINE_API inline bool is_chunks_cache_enabled() const {return !m_chunks.empty();}
+
+		// force rebuilding all the cached chunks on next render
+		NESSENGINE_API void invalidate_chunks_cache();
+
+		// debug option: if enabled, every chunk keeps a snapshot of its tiles and compares them every frame, to detect tiles
+		// that changed without invalidating their chunk (an error is logged in debug mode and the chunk is rebuilt).
+		// this is slow and should only be used to find bugs in custom tiles.
+		NESSENGINE_API void set_chunks_verification(bool enabled);
+
+		// called by the tiles when they change, to invalidate their chunk
+		NESSENGINE_API virtual void __son_transformations_update(RenderableAPI* son);
+		NESSENGINE_API virtual void __son_appearance_update(RenderableAPI* son);
+
 		// clear this tilesmap
 		NESSENGINE_API virtual void destroy();
 
@@ -190,6 +243,24 @@ namespace Ness
 		// note: i and j may be equal to size.x and size.y, its still count in range
 		NESSENGINE_API void put_in_range(int& i, int& j) const;
 
+		// return the range of chunks that cover the given tiles range
+		NESSENGINE_API Rectangle get_chunks_in_range(const Rectangle& tilesRange) const;
+
+		// check if a chunk's tiles changed since it was built (or if it was never built)
+		NESSENGINE_API bool is_chunk_dirty(const Pointi& chunk) const;
+
+		// mark the chunk that contains the given tile as dirty
+		NESSENGINE_API void invalidate_tile_chunk(RenderableAPI* tile);
+
+		// render the tiles of a chunk into its canvas
+		NESSENGINE_API void build_chunk(const Pointi& chunk);
+
+		// get a chunk and rebuild it if needed
+		NESSENGINE_API STileMapChunk& get_updated_chunk(const Pointi& chunk);
+
+		// take a snapshot of a tile state
+		NESSENGINE_API void take_tile_snapshot(const SpritePtr& tile, STileSnapshot& out) const;
+
 	private:
 		// arrange a single tile sprite during creation
 		NESSENGINE_API void arrange_sprite(const SpritePtr& sprite, const Pointi& index);
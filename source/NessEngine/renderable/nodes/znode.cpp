@@ -37,41 +37,367 @@ namespace Ness
 		return  a->get_absolute_zindex() < b->get_absolute_zindex();
 	}
 
+	// sort selected entities by absolute z-index
+	static bool sort_entities_by_z_absolute(const SharedPtr<EntityAPI>& a, const SharedPtr<EntityAPI>& b)
+	{
+		return a->get_absolute_zindex() < b->get_absolute_zindex();
+	}
+
+	void ZNode::sort_selected_entities(EntitiesList& out_list, size_t first)
+	{
+		std::stable_sort(out_list.begin() + first, out_list.end(), sort_entities_by_z_absolute);
+	}
+
+	void ZNode::select_entities_from_position(EntitiesList& out_list, const Pointf& pos, bool recursive) const
+	{
+		size_t first = out_list.size();
+		Node::select_entities_from_position(out_list, pos, recursive);
+		sort_selected_entities(out_list, first);
+	}
+
+	void ZNode::select_entities_in_rect(EntitiesList& out_list, const Rectangle& rect, bool recursive)
+	{
+		size_t first = out_list.size();
+		Node::select_entities_in_rect(out_list, rect, recursive);
+		sort_selected_entities(out_list, first);
+	}
+
+	void ZNode::select_entities_in_radius(EntitiesList& out_list, const Pointf& center, float radius, bool recursive)
+	{
+		size_t first = out_list.size();
+		Node::select_entities_in_radius(out_list, center, radius, recursive);
+		sort_selected_entities(out_list, first);
+	}
+
+	// convert float to unsigned int key that keeps the same order when compared as unsigned integers.
+	// positive floats get their sign bit flipped, negative floats get all their bits flipped.
+	static inline Uint32 float_to_sort_key(float value)
+	{
+		Uint32 bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits ^ ((bits & 0x80000000) ? 0xFFFFFFFF : 0x80000000);
+	}
+
+	void ZNode::radix_sort_render_list()
+	{
+		unsigned int count = (unsigned int)m_render_list.size();
+		if (count < 2)
+			return;
+
+		// extract keys
+		m_sort_keys.resize(count);
+		m_sort_keys_temp.resize(count);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			m_sort_keys[i].key = float_to_sort_key(m_break_groups ? m_render_list[i]->get_absolute_zindex() : m_render_list[i]->get_zindex());
+			m_sort_keys[i].index = i;
+		}
+
+		// build histograms for all 4 bytes in a single pass
+		unsigned int histograms[4][256];
+		memset(histograms, 0, sizeof(histograms));
+		for (unsigned int i = 0; i < count; i++)
+		{
+			Uint32 key = m_sort_keys[i].key;
+			histograms[0][key & 0xFF]++;
+			histograms[1][(key >> 8) & 0xFF]++;
+			histograms[2][(key >> 16) & 0xFF]++;
+			histograms[3][key >> 24]++;
+		}
+
+		// stable LSD radix sort, one pass per byte
+		SZSortKey* src = &m_sort_keys[0];
+		SZSortKey* dst = &m_sort_keys_temp[0];
+		for (unsigned int pass = 0; pass < 4; pass++)
+		{
+			unsigned int shift = pass * 8;
+			unsigned int* histogram = histograms[pass];
+
+			// if all keys have the same value in this byte, this pass won't change anything
+			if (histogram[(src[0].key >> shift) & 0xFF] == count)
+				continue;
+
+			// convert histogram to offsets
+			unsigned int offset = 0;
+			for (unsigned int b = 0; b < 256; b++)
+			{
+				unsigned int bucket_size = histogram[b];
+				histogram[b] = offset;
+				offset += bucket_size;
+			}
+
+			// scatter
+			for (unsigned int i = 0; i < count; i++)
+			{
+				dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+			}
+			std::swap(src, dst);
+		}
+
+		// reorder the render list in one pass
+		m_sorted_temp.resize(count);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			m_sorted_temp[i] = std::move(m_render_list[src[i].index]);
+		}
+		m_render_list.swap(m_sorted_temp);
+		m_sorted_temp.clear();
+	}
+
+	void ZNode::set_incremental_ordering(bool enabled)
+	{
+		m_incremental_ordering = enabled;
+		m_render_list.clear();
+		clear_incremental_list();
+		m_time_until_next_zorder = 0.0f;
+	}
+
+	void ZNode::set_break_groups(bool BreakGroups)
+	{
+		m_break_groups = BreakGroups;
+
+		// the incremental list contains different entities when breaking groups, so rebuild it
+		if (m_incremental_ordering)
+		{
+			clear_incremental_list();
+			m_time_until_next_zorder = 0.0f;
+		}
+	}
+
+	void ZNode::clear_incremental_list()
+	{
+		m_ordered_list.clear();
+		m_ordered_keys.clear();
+		SDL_AtomicLock(&m_dirty_lock);
+		m_dirty_sons.clear();
+		m_all_dirty = false;
+		SDL_AtomicUnlock(&m_dirty_lock);
+	}
+
+	void ZNode::__son_transformations_update(RenderableAPI* son)
+	{
+		Node::__son_transformations_update(son);
+		if (!m_incremental_ordering)
+			return;
+
+		// if breaking groups and a son node changed, all the entities in it changed
+		SDL_AtomicLock(&m_dirty_lock);
+		if (m_break_groups && son->is_node() && m_ordered_keys.find(son) == m_ordered_keys.end())
+			m_all_dirty = true;
+		else
+			m_dirty_sons[son] = true;
+		SDL_AtomicUnlock(&m_dirty_lock);
+	}
+
+	void ZNode::add_visible_son(RenderablesList& out_list, const RenderablePtr& son, const CameraApiPtr& camera)
+	{
+		// if need to break entities of son nodes:
+		if (m_break_groups && son->is_node())
+		{
+			// check if current entity is indeed a node, and if so, break it
+			NodeAPI* currentNode = ness_kind_cast<NodeAPI>(son);
+			if (!currentNode->get_flag(RNF_NEVER_BREAK))
+			{
+				currentNode->__get_visible_entities(out_list, camera, true);
+				return;
+			}
+		}
+
+		// if got here it's either a sprite entity or a node but we want to keep groups. add it to rendering list if visible
+		if (!son->is_really_visible(camera))
+			return;
+		out_list.push_back(son);
+	}
+
+	void ZNode::get_visible_entities(RenderablesList& out_list, const CameraApiPtr& camera)
+	{
+		// if got spatial index, only check the sons in the visible cells (see BaseNode::__get_visible_entities())
+		if (m_spatial_index && query_visible_sons(camera))
+		{
+			for (unsigned int i = 0; i < m_spatial_results.size(); i++)
+			{
+				add_visible_son(out_list, m_spatial_results[i]->renderable, camera);
+			}
+			return;
+		}
+
+		// add all the visible sprites
+		for (unsigned int i = 0; i < m_entities.size(); i++)
+		{
+			add_visible_son(out_list, m_entities[i], camera);
+		}
+	}
+
+	// used to find entities in the incremental list by their order key
+	static bool compare_entry_to_key(const SZOrderEntry& entry, const SZOrderKey& key)
+	{
+		return entry.key < key;
+	}
+
+	void ZNode::sort_incremental_list()
+	{
+		for (unsigned int i = 0; i < m_ordered_list.size(); i++)
+		{
+			SZOrderEntry& entry = m_ordered_list[i];
+			entry.key.zindex = get_order_zindex(entry.renderable);
+			m_ordered_keys[entry.renderable.get()] = entry.key;
+		}
+		std::sort(m_ordered_list.begin(), m_ordered_list.end());
+	}
+
+	void ZNode::update_incremental_order()
+	{
+		// take the dirty entities (updating z-index may mark more entities as dirty, they will be handled next time)
+		SDL_AtomicLock(&m_dirty_lock);
+		bool all_dirty = m_all_dirty;
+		m_all_dirty = false;
+		m_dirty_temp.swap(m_dirty_sons);
+		SDL_AtomicUnlock(&m_dirty_lock);
+
+		// when breaking groups we order by absolute z-index, so if this node changed all the entities changed with it
+		if (m_break_groups)
+		{
+			Uint32 generation = __get_transformations_generation();
+			if (generation != m_ordered_generation)
+			{
+				m_ordered_generation = generation;
+				all_dirty = true;
+			}
+		}
+
+		// if a lot of entities changed, its faster to just sort everything again
+		if (all_dirty || m_dirty_temp.size() * 4 > m_ordered_list.size())
+		{
+			sort_incremental_list();
+			m_dirty_temp.clear();
+			return;
+		}
+
+		// re-position only the entities that changed: find them with binary search on their old key and move them to their
+		// new position. z-index usually changes only a little, so entities move only a short distance in the list.
+		for (auto dirty = m_dirty_temp.begin(); dirty != m_dirty_temp.end(); ++dirty)
+		{
+			// skip entities that are not in the list (not visible)
+			auto in_list = m_ordered_keys.find(dirty->first);
+			if (in_list == m_ordered_keys.end())
+				continue;
+
+			// find current position and check if z-index really changed
+			SZOrderKey& key = in_list->second;
+			auto pos = std::lower_bound(m_ordered_list.begin(), m_ordered_list.end(), key, compare_entry_to_key);
+			float zindex = get_order_zindex(pos->renderable);
+			if (zindex == key.zindex)
+				continue;
+			key.zindex = zindex;
+			pos->key.zindex = zindex;
+
+			// move backward or forward to the new position
+			if (pos != m_ordered_list.begin() && *pos < *(pos - 1))
+			{
+				auto new_pos = std::upper_bound(m_ordered_list.begin(), pos, *pos);
+				std::rotate(new_pos, pos, pos + 1);
+			}
+			else if (pos + 1 != m_ordered_list.end() && *(pos + 1) < *pos)
+			{
+				auto new_pos = std::lower_bound(pos + 1, m_ordered_list.end(), *pos);
+				std::rotate(pos, pos + 1, new_pos);
+			}
+		}
+		m_dirty_temp.clear();
+	}
+
+	void ZNode::refresh_incremental_list(const CameraApiPtr& camera)
+	{
+		// get currently visible entities
+		m_render_list.clear();
+		get_visible_entities(m_render_list, camera);
+		m_visible_set.clear();
+		for (unsigned int i = 0; i < m_render_list.size(); i++)
+		{
+			m_visible_set[m_render_list[i].get()] = true;
+		}
+
+		// remove entities that are no longer visible (keep the order of the rest).
+		// entities that remain are removed from the visible set, so what's left in it are the new entities.
+		unsigned int kept = 0;
+		for (unsigned int i = 0; i < m_ordered_list.size(); i++)
+		{
+			auto in_set = m_visible_set.find(m_ordered_list[i].renderable.get());
+			if (in_set == m_visible_set.end())
+			{
+				m_ordered_keys.erase(m_ordered_list[i].renderable.get());
+				continue;
+			}
+			m_visible_set.erase(in_set);
+			if (kept != i)
+				m_ordered_list[kept] = std::move(m_ordered_list[i]);
+			kept++;
+		}
+		m_ordered_list.resize(kept);
+
+		// fix the order of the remaining entities
+		update_incremental_order();
+
+		// add the new entities at the end, sort them and merge into the sorted list
+		for (unsigned int i = 0; i < m_render_list.size(); i++)
+		{
+			auto in_set = m_visible_set.find(m_render_list[i].get());
+			if (in_set == m_visible_set.end())
+				continue;
+			m_visible_set.erase(in_set);
+			SZOrderEntry entry;
+			entry.renderable = m_render_list[i];
+			entry.key.zindex = get_order_zindex(entry.renderable);
+			entry.key.seq = m_next_seq++;
+			m_ordered_keys[entry.renderable.get()] = entry.key;
+			m_ordered_list.push_back(entry);
+
+			// if its an entity from a broken son node, make the nodes above it tell us when it changes
+			for (NodeAPI* parent = entry.renderable->parent(); parent != nullptr && parent != this; parent = parent->parent())
+			{
+				parent->__set_forward_son_updates(true);
+			}
+		}
+		if (m_ordered_list.size() > kept)
+		{
+			std::sort(m_ordered_list.begin() + kept, m_ordered_list.end());
+			std::inplace_merge(m_ordered_list.begin(), m_ordered_list.begin() + kept, m_ordered_list.end());
+		}
+		m_render_list.clear();
+	}
+
 	// render everything, with z order!
 	void ZNode::render(const CameraApiPtr& camera)
 	{
+		// incremental ordering: refresh the visible entities every interval, and fix the order every frame
+		if (m_incremental_ordering)
+		{
+			if (m_time_until_next_zorder <= 0.0f)
+			{
+				m_time_until_next_zorder = m_update_list_intervals;
+				refresh_incremental_list(camera);
+			}
+			else
+			{
+				m_time_until_next_zorder -= m_renderer->time_factor();
+				update_incremental_order();
+			}
+		}
 		// if its time to reorder, reset the render list and repopulate it
-		if (m_time_until_next_zorder <= 0.0f)
+		else if (m_time_until_next_zorder <= 0.0f)
 		{
 			m_time_until_next_zorder = m_update_list_intervals;
 			m_render_list.clear();
+			get_visible_entities(m_render_list, camera);
 
-			// add all the visible sprites
-			for (unsigned int i = 0; i < m_entities.size(); i++)
+			// sort based on z!
+			// if radix sort is enabled, sort by extracted keys
+			if (m_radix_sort)
 			{
-				// if need to break entities of son nodes:
-				if (m_break_groups && m_entities[i]->is_node())
-				{
-					// check if current entity is indeed a node, and if so, break it
-					SharedPtr<NodeAPI> currentNode = ness_ptr_cast<NodeAPI>(m_entities[i]);
-					if (!currentNode->get_flag(RNF_NEVER_BREAK))
-					{
-						currentNode->__get_visible_entities(m_render_list, camera, true);
-						continue;
-					}
-				}
-
-				// if got here it's either a sprite entity or a node but we want to keep groups. add it to rendering list if visible
-				const SharedPtr<RenderableAPI>& current = m_entities[i];
-				if (!current->is_really_visible(camera))
-					continue;
-				m_render_list.push_back(current);
-
+				radix_sort_render_list();
 			}
-
-			// sort based on z!
 			// if break groups, we need to sort by absolute z ordering
-			if (m_break_groups)
+			else if (m_break_groups)
 			{
 				std::sort(m_render_list.begin(), m_render_list.end(), sort_by_z_absolute);
 			}
@@ -95,9 +421,19 @@ namespace Ness
 
 		// render everything!
 		// note: the render list is a vector so this iteration is most efficient
-		for (unsigned int i = 0; i < m_render_list.size(); i++)
+		if (m_incremental_ordering)
 		{
-			m_render_list[i]->render(camera);
+			for (unsigned int i = 0; i < m_ordered_list.size(); i++)
+			{
+				m_ordered_list[i].renderable->render(camera);
+			}
+		}
+		else
+		{
+			for (unsigned int i = 0; i < m_render_list.size(); i++)
+			{
+				m_render_list[i]->render(camera);
+			}
 		}
 
 		// reset rendering target if such target was used
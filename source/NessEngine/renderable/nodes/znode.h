@@ -32,6 +32,32 @@
 
 namespace Ness
 {
+	// the order key of an entity in a znode incremental ordering list: cached z-index, and a unique sequence number to break ties
+	// (so every entity has a unique position we can find with binary search)
+	struct SZOrderKey
+	{
+		float			zindex;
+		Uint32			seq;
+
+		NESSENGINE_API bool operator<(const SZOrderKey& other) const {return zindex < other.zindex || (zindex == other.zindex && seq < other.seq);}
+	};
+
+	// an entity in a znode incremental ordering list, with its order key
+	struct SZOrderEntry
+	{
+		SZOrderKey		key;
+		RenderablePtr	renderable;
+
+		NESSENGINE_API bool operator<(const SZOrderEntry& other) const {return key < other.key;}
+	};
+
+	// a z-index converted to a sortable integer key, with the index of the entity in the render list
+	struct SZSortKey
+	{
+		Uint32			key;
+		unsigned int	index;
+	};
+
 	/**
 	* A special node that re-order the entities in realtime based on their z-value, creating a z-ordering effect.
 	*/
@@ -42,10 +68,29 @@ namespace Ness
 		bool			m_break_groups;				// should we break son nodes when z-ordering or treat them as a single entity?
 		float			m_update_list_intervals;	// time in miliseconds between z-ordering refresh
 		float			m_time_until_next_zorder;	// time left until next time we need to z-order
+		bool			m_incremental_ordering;		// if true, will maintain the order incrementally every frame instead of full sort every interval
+		bool			m_radix_sort;				// if true, will use radix sort on extracted keys instead of comparator sort
+
+		// used for radix sort mode
+		Containers::Vector<SZSortKey>		m_sort_keys;		// keys extracted from the render list
+		Containers::Vector<SZSortKey>		m_sort_keys_temp;	// temporary buffer for the radix sort passes
+		RenderablesList						m_sorted_temp;		// temporary list used to reorder the render list
+
+		// used for incremental ordering mode
+		Containers::Vector<SZOrderEntry>					m_ordered_list;		// the render list with cached z-index, always sorted
+		Containers::UnorderedMap<RenderableAPI*, SZOrderKey>	m_ordered_keys;		// the order key of every entity in the ordered list
+		Containers::UnorderedMap<RenderableAPI*, bool>		m_visible_set;		// temporary set used when refreshing the visible entities
+		Containers::UnorderedMap<RenderableAPI*, bool>		m_dirty_sons;		// entities that their transformations changed since last update
+		Containers::UnorderedMap<RenderableAPI*, bool>		m_dirty_temp;		// temporary set used while updating the dirty entities
+		bool												m_all_dirty;		// if true, all entities need to be updated (for example a son node moved)
+		SDL_SpinLock										m_dirty_lock;		// lock for the dirty entities (transformations may change from worker threads)
+		Uint32												m_next_seq;			// next sequence number to give to a new entity in the ordered list
+		Uint32												m_ordered_generation;	// this node transformations generation when the list was updated
 
 	public:
 		// create the znode
-		NESSENGINE_API ZNode(Renderer* renderer) : Node(renderer), m_break_groups(false), m_update_list_intervals(0.075f), m_time_until_next_zorder(0.0f) {}
+		NESSENGINE_API ZNode(Renderer* renderer) : Node(renderer), m_break_groups(false), m_update_list_intervals(0.075f), m_time_until_next_zorder(0.0f),
+			m_incremental_ordering(false), m_radix_sort(false), m_all_dirty(false), m_dirty_lock(0), m_next_seq(0), m_ordered_generation(0) {}
 
 		// this determine how often, in miliseconds, should this z-node update its rendering list,
 		// i.e. recalculate all visible entities and reorder them.
@@ -57,10 +102,63 @@ namespace Ness
 		// if break groups is true, this znode will take ALL entities from all son nodes and arrange them based on zorder.
 		// if break groups is false, the znode will arrange son nodes as son entities, meaning every son node shares the same z-order.
 		// NOTE: if you want a node that never will be broken, set it's flag with: node->set_flag(Ness::RNF_NEVER_BREAK);
-		NESSENGINE_API inline void set_break_groups(bool BreakGroups) {m_break_groups = BreakGroups;}
+		NESSENGINE_API void set_break_groups(bool BreakGroups);
+
+		// set incremental ordering mode.
+		// in this mode the znode keeps the sorted list between frames and every frame only re-position the entities that their
+		// transformations changed, so the order is correct every frame. the visible entities are still refreshed every reorder 
+		// interval, and new visible entities are merged into the sorted list.
+		// use this for large znodes with many entities, where most of them don't change z-order every frame.
+		NESSENGINE_API void set_incremental_ordering(bool enabled);
+		NESSENGINE_API inline bool is_incremental_ordering() const {return m_incremental_ordering;}
+
+		// set if to use radix sort when reordering.
+		// when enabled, the z-index of all entities is extracted once into a contiguous array of integer keys, sorted with a stable
+		// radix sort, and then the render list is reordered in a single pass. this avoids the virtual get_zindex() calls in
+		// the comparator of std::sort and is much faster for large lists.
+		// note: doesn't affect incremental ordering mode.
+		NESSENGINE_API inline void set_radix_sort(bool enabled) {m_radix_sort = enabled;}
+		NESSENGINE_API inline bool is_radix_sort() const {return m_radix_sort;}
+
+		// select son entities from position / rectangle / circle.
+		// same as in BaseNode, but the entities are returned sorted by their absolute z-index (back to front).
+		NESSENGINE_API virtual void select_entities_from_position(EntitiesList& out_list, const Pointf& pos, bool recursive) const;
+		NESSENGINE_API virtual void select_entities_in_rect(EntitiesList& out_list, const Rectangle& rect, bool recursive);
+		NESSENGINE_API virtual void select_entities_in_radius(EntitiesList& out_list, const Pointf& center, float radius, bool recursive);
 
 		// render everything, with z order!
 		NESSENGINE_API virtual void render(const CameraApiPtr& camera);
+
+		// called by son entities when their transformations change (mark them for reordering in incremental mode)
+		NESSENGINE_API virtual void __son_transformations_update(RenderableAPI* son);
+
+	private:
+		// sort the selected entities (from given index to the end of the list) by their absolute z-index
+		static void sort_selected_entities(EntitiesList& out_list, size_t first);
+
+		// sort the render list using radix sort
+		void radix_sort_render_list();
+
+		// add a son to the visible entities list if visible (break it if needed)
+		void add_visible_son(RenderablesList& out_list, const RenderablePtr& son, const CameraApiPtr& camera);
+
+		// collect all the visible entities into the given list
+		void get_visible_entities(RenderablesList& out_list, const CameraApiPtr& camera);
+
+		// return the z-index to order a renderable by
+		inline float get_order_zindex(const RenderablePtr& renderable) const {return m_break_groups ? renderable->get_absolute_zindex() : renderable->get_zindex();}
+
+		// update the z-index of the entities that changed in the incremental list and fix their order
+		void update_incremental_order();
+
+		// update the z-index of all entities in the incremental list and sort it again
+		void sort_incremental_list();
+
+		// clear the incremental list and everything related to it
+		void clear_incremental_list();
+
+		// merge newly visible entities into the incremental list and remove entities that are no longer visible
+		void refresh_incremental_list(const CameraApiPtr& camera);
 	};
 
 	// scene pointer
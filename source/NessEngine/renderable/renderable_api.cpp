@@ -52,6 +52,14 @@ namespace Ness
 		transformations_update();
 	}
 
+	void RenderableAPI::appearance_update()
+	{
+		if (m_parent)
+		{
+			m_parent->__son_appearance_update(this);
+		}
+	}
+
 	Point RenderableAPI::get_absolute_position_with_camera(const CameraApiPtr& camera)
 	{
 		Rectangle ret;
@@ -50,6 +50,18 @@ namespace Ness
 	{
 	};
 
+	// the built-in kinds of renderables, used to check the type of a renderable without RTTI (see RenderableAPI::is_kind()).
+	// a renderable has the kind flags of all the classes it inherits from, for example a light is both an entity and a light.
+	enum ERenderableKind
+	{
+		RENDERABLE_KIND_NODE = 0x1 << 0,		// NodeAPI
+		RENDERABLE_KIND_BASE_NODE = 0x1 << 1,	// BaseNode
+		RENDERABLE_KIND_ENTITY = 0x1 << 2,		// Entity
+		RENDERABLE_KIND_PARTICLE = 0x1 << 3,	// Particle
+		RENDERABLE_KIND_LIGHT = 0x1 << 4,		// Light
+		RENDERABLE_KIND_SHADOW = 0x1 << 5,		// Shadow
+	};
+
 	// the API of any renderable object (entity or node)
 	class RenderableAPI: public Transformable
 	{
@@ -61,10 +73,11 @@ namespace Ness
 		void*					m_user_data;					// optional user data you can attach to this object
 		bool					m_delete_user_data;				// if true, will delete user data once the renderable is deleted
 		String					m_name;							// optional name to assign to this renderable
+		int						m_kind;							// kind flags of this renderable (set by the constructors, see ERenderableKind)
 
 	public:
 		NESSENGINE_API RenderableAPI(Renderer* renderer) : 
-		  m_renderer(renderer), m_parent(nullptr), m_visible(true), m_flags(RNF_SELECTABLE), m_user_data(nullptr) {}
+		  m_renderer(renderer), m_parent(nullptr), m_visible(true), m_flags(RNF_SELECTABLE), m_user_data(nullptr), m_kind(0) {}
 
 		  NESSENGINE_API ~RenderableAPI();
 
@@ -77,9 +90,13 @@ namespace Ness
 		void* get_user_data() {return m_user_data;}
 
 		// enable/disable rendering of this object
-		NESSENGINE_API inline void set_visible(bool Visible) {m_visible = Visible;}
+		NESSENGINE_API inline void set_visible(bool Visible) {if (m_visible == Visible) return; m_visible = Visible; appearance_update();}
 		NESSENGINE_API inline bool is_visible() const {return m_visible;}
 
+		// tell the parent node that something that changes how this renderable looks (but not its transformations) changed,
+		// like visibility or texture. don't call this yourself, ness-engine should call it automatically.
+		NESSENGINE_API void appearance_update();
+
 		// set/get this entity name
 		NESSENGINE_API inline void set_name(const String& name) {m_name = name;}
 		NESSENGINE_API inline const String& get_name() const {return m_name;}
@@ -115,6 +132,11 @@ namespace Ness
 		NESSENGINE_API virtual bool is_node() const = 0;
 		NESSENGINE_API virtual bool is_entity() const = 0;
 
+		// check the kind of this renderable without RTTI (kind is a value from ERenderableKind).
+		// use this instead of ness_ptr_cast in code that runs every frame, and then cast with ness_kind_cast.
+		NESSENGINE_API inline bool is_kind(int kind) const {return (m_kind & kind) != 0;}
+		NESSENGINE_API inline int get_kind() const {return m_kind;}
+
 		// is this renderable object actually visible and inside screen?
 		NESSENGINE_API virtual bool is_really_visible(const CameraApiPtr& camera) = 0;
 
@@ -137,4 +159,10 @@ namespace Ness
 
 	// renderable object pointer
 	NESSENGINE_API typedef SharedPtr<RenderableAPI> RenderablePtr;
+
+	// cast a renderable pointer to a raw pointer of a known type, without RTTI and without touching the reference count.
+	// only use this after checking the type with is_kind(), else the result is undefined.
+	// usage: if (renderable->is_kind(RENDERABLE_KIND_LIGHT)) ness_kind_cast<Light>(renderable)->set_need_redraw(false);
+	template <typename T>
+	inline T* ness_kind_cast(const RenderablePtr& renderable) {return static_cast<T*>(renderable.get());}
 };
\ No newline at end of file
@@ -0,0 +1,68 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+/**
+* A single deferred drawing command. when the renderer works in deferred mode, every blit/draw call is
+* stored as a draw command and all the commands are executed together when the renderer flush them.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include <SDL.h>
+
+// rendering geometry (textured triangles) is only supported from sdl 2.0.18
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	#define NESSENGINE_RENDER_GEOMETRY
+#endif
+
+namespace Ness
+{
+	// the different types of draw commands
+	enum EDrawCommandType
+	{
+		DRAW_CMD_BLIT,				// render a texture
+		DRAW_CMD_FILL_RECT,			// draw a filled rectangle
+		DRAW_CMD_RECT,				// draw rectangle outline
+		DRAW_CMD_LINE,				// draw a line
+		DRAW_CMD_CIRCLE,			// draw circle outline (by pixels)
+	};
+
+	// a single draw command.
+	// note: this is a POD struct, so it can be stored in a big vector and copied around cheaply.
+	struct SDrawCommand
+	{
+		EDrawCommandType	type;			// command type
+		SDL_Texture*		texture;		// texture to render (only for blit)
+		SDL_BlendMode		blend;			// blend mode
+		Uint8				r, g, b, a;		// color (color mod for blit, draw color for the rest)
+		bool				has_source;		// if false, will render the whole texture (no source rect)
+		bool				advanced;		// if true, blit will use the RenderCopyEx (rotation / flip)
+		SDL_RendererFlip	flip;			// flip for advanced rendering
+		SDL_Rect			source;			// source rect (only for blit)
+		SDL_Rect			target;			// blit/rect target. for lines (x,y) is starting point and (w,h) is the ending point. for circle (x,y) is center.
+		SDL_Point			center;			// rotation center, relative to target (only for blit)
+		float				rotation;		// rotation (only for blit)
+		float				radius;			// circle radius (only for circles)
+		SDL_Rect			bounds;			// conservative bounding box of the pixels this command may touch (used for safe reordering)
+	};
+};
@@ -24,6 +24,8 @@
 #include "../exceptions/exceptions.h"
 #include "../scene/scene.h"
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 
 // warning C4355: 'this' : used in base member initializer list (disabled due to Animators::AnimatorsQueue(this))
 #pragma warning(disable:4355)
@@ -109,6 +111,19 @@ namespace Ness
 		m_frameid = 0;
 		m_background_color = Colorb(75, 0, 255, 255);
 		m_auto_animate = true;
+		m_parallel_particles = false;
+		m_animation_tasks_pending = false;
+		m_deferred_rendering = false;
+		m_deferred_lookahead = 32;
+		m_texture_state_cache = true;
+		m_last_state_texture = nullptr;
+		m_last_texture_state = nullptr;
+		m_texture_state_hits = 0;
+		m_texture_state_misses = 0;
+		m_geometry_batching = true;
+#ifdef NESSENGINE_RENDER_GEOMETRY
+		m_geometry_texture = nullptr;
+#endif
 
 		// set render to texture flag
 		m_can_render_to_texture = ((m_flags & RENDERER_FLAG_TARGET_TEXTURE) != 0);
@@ -119,6 +134,7 @@ namespace Ness
 
 	void Renderer::set_renderer_size(const Sizei& newSize)
 	{
+		flush_draw_commands();
 		if (newSize != Sizei::ZERO)
 		{
 			m_renderer_size = newSize;
@@ -163,6 +179,16 @@ namespace Ness
 	// destroy the renderer
 	Renderer::~Renderer()
 	{
+		// stop the workers before destroying anything they might use
+		if (m_workers_pool)
+		{
+			m_workers_pool->stop();
+			m_workers_pool.reset();
+		}
+
+		// drop pending draw commands, they might point on textures that are about to be destroyed
+		m_draw_commands.clear();
+
 		// this is very important! its to make sure all sprites are clear and thus all resources are cleared before
 		// destroying this window
 		m_scenes.clear();
@@ -184,6 +210,11 @@ namespace Ness
 	{
 		// begin scene and clear if needed
 		m_start_frame_time = SDL_GetTicks();
+		join_animation_tasks();
+		flush_draw_commands();
+
+		// create textures that finished loading in the background
+		m_resources->__update_async_loads();
 		if (clearScene) 
 		{
 			SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_NONE);
@@ -195,9 +226,13 @@ namespace Ness
 	// end a rendering frame
 	void Renderer::end_frame()
 	{
+		// render all pending draw commands
+		flush_draw_commands();
+
 		// do animations
 		if (m_auto_animate)
 			do_animations();
+		join_animation_tasks();
 
 		// render everything and set time factor
 		SDL_RenderPresent(m_renderer);
@@ -260,6 +295,7 @@ namespace Ness
 
 	void Renderer::reset_render_target()
 	{
+		flush_draw_commands();
 		SDL_SetRenderTarget(m_renderer, nullptr); 
 		m_render_target.reset(); 
 		m_target_size = &m_renderer_size;
@@ -310,6 +346,7 @@ namespace Ness
 		if (!m_can_render_to_texture) throw IllegalAction("Cannot render to texture without setting the RENDERER_FLAG_TARGET_TEXTURE renderer flag!");
 
 		// set target texture
+		flush_draw_commands();
 		SDL_SetRenderTarget(m_renderer, texture->texture());
 		m_render_target = texture;
 		m_target_size = &texture->get_size();
@@ -317,7 +354,9 @@ namespace Ness
 
 	void Renderer::clear_texture(ManagedResources::ManagedTexturePtr texture)
 	{
+		flush_draw_commands();
 		SDL_SetRenderTarget(m_renderer, texture->texture());
+		SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 0);
 		SDL_RenderClear(m_renderer);
 		set_render_target(m_render_target);
 	}
@@ -329,6 +368,7 @@ namespace Ness
 		screen.y = 0;
 		screen.w = texture->get_size().x;
 		screen.h = texture->get_size().y;
+		flush_draw_commands();
 		SDL_SetRenderTarget(m_renderer, texture->texture());
 		draw_rect(screen, fillColor, true);
 		set_render_target(m_render_target);
@@ -336,90 +376,550 @@ namespace Ness
 
 	void Renderer::draw_rect(const Rectangle& TargetRect, const Color& color, bool filled, EBlendModes mode)
 	{
+		SDrawCommand command;
+		command.type = filled ? DRAW_CMD_FILL_RECT : DRAW_CMD_RECT;
+		command.texture = nullptr;
+		command.blend = (SDL_BlendMode)mode;
+		command.r = (Uint8)(color.r * 255); command.g = (Uint8)(color.g * 255); command.b = (Uint8)(color.b * 255); command.a = (Uint8)(color.a * 255);
+		command.target = TargetRect;
+
+		// bounds are the rectangle itself (fixed for negative size)
+		command.bounds = TargetRect;
+		if (command.bounds.w < 0) {command.bounds.x += command.bounds.w; command.bounds.w *= -1;}
+		if (command.bounds.h < 0) {command.bounds.y += command.bounds.h; command.bounds.h *= -1;}
+
+		push_draw_command(command);
+	}
 
-		// set blend mode and color
-		SDL_SetRenderDrawBlendMode(m_renderer, (SDL_BlendMode)mode);
-		SDL_SetRenderDrawColor(m_renderer, (Uint8)(color.r * 255), (Uint8)(color.g * 255), (Uint8)(color.b * 255), (Uint8)(color.a * 255));
+	NESSENGINE_API void Renderer::draw_circle(const Pointi& position, float radius, const Color& color, EBlendModes mode)
+	{
+		SDrawCommand command;
+		command.type = DRAW_CMD_CIRCLE;
+		command.texture = nullptr;
+		command.blend = (SDL_BlendMode)mode;
+		command.r = (Uint8)(color.r * 255); command.g = (Uint8)(color.g * 255); command.b = (Uint8)(color.b * 255); command.a = (Uint8)(color.a * 255);
+		command.target.x = position.x;
+		command.target.y = position.y;
+		command.radius = radius;
+
+		// bounds are the box containing the circle
+		int bounds_radius = (int)ceil(radius) + 1;
+		command.bounds.x = position.x - bounds_radius;
+		command.bounds.y = position.y - bounds_radius;
+		command.bounds.w = command.bounds.h = bounds_radius * 2 + 1;
+
+		push_draw_command(command);
+	}
 
-		// render filled/hollow rectangle
-		if (filled)
+	void Renderer::draw_line(const Ness::Pointi& a, const Ness::Pointi& b, const Color& color, EBlendModes mode)
+	{
+		SDrawCommand command;
+		command.type = DRAW_CMD_LINE;
+		command.texture = nullptr;
+		command.blend = (SDL_BlendMode)mode;
+		command.r = (Uint8)(color.r * 255); command.g = (Uint8)(color.g * 255); command.b = (Uint8)(color.b * 255); command.a = (Uint8)(color.a * 255);
+		command.target.x = a.x; command.target.y = a.y;
+		command.target.w = b.x; command.target.h = b.y;
+
+		// bounds are the box containing both points
+		command.bounds.x = std::min(a.x, b.x);
+		command.bounds.y = std::min(a.y, b.y);
+		command.bounds.w = std::abs(a.x - b.x) + 1;
+		command.bounds.h = std::abs(a.y - b.y) + 1;
+
+		push_draw_command(command);
+	}
+
+	void Renderer::blit(SDL_Texture* texture, const Rectangle* SrcRect, const Rectangle& TargetRect, EBlendModes mode, const Color& color, float rotation, Point rotation_anchor)
+	{
+		// texture is still loading in the background
+		if (texture == nullptr)
+			return;
+
+		SDrawCommand command;
+		command.type = DRAW_CMD_BLIT;
+		command.texture = texture;
+		command.blend = (SDL_BlendMode)mode;
+		command.r = (Uint8)(color.r * 255); command.g = (Uint8)(color.g * 255); command.b = (Uint8)(color.b * 255); command.a = (Uint8)(color.a * 255);
+		command.has_source = (SrcRect != nullptr);
+		if (SrcRect)
+			command.source = *SrcRect;
+		command.target = TargetRect;
+		command.rotation = rotation;
+		command.flip = SDL_FLIP_NONE;
+
+		// requires advance rendering?
+		command.advanced = ((rotation != 0.0f) || (color.a < 1.0f) || TargetRect.w < 0 || TargetRect.h < 0);
+		if (command.advanced)
 		{
-			SDL_RenderFillRect(m_renderer, &TargetRect);
+			// set flipping for negative scale and fix target size
+			int flip = SDL_FLIP_NONE;
+			if (command.target.w < 0)
+			{
+				command.target.w *= -1;
+				flip |= SDL_FLIP_HORIZONTAL;
+			}
+			if (command.target.h < 0)
+			{
+				command.target.h *= -1;
+				flip |= SDL_FLIP_VERTICAL;
+			}
+			command.flip = (SDL_RendererFlip)flip;
+
+			// set rotation anchor
+			command.center.x = (int)floor(rotation_anchor.x * command.target.w);
+			command.center.y = (int)floor(rotation_anchor.y * command.target.h);
+		}
+
+		// calc bounds. if rotated, take the box around the circle the target rect rotates in
+		if (rotation != 0.0f)
+		{
+			int far_x = std::max(command.center.x, command.target.w - command.center.x);
+			int far_y = std::max(command.center.y, command.target.h - command.center.y);
+			int bounds_radius = (int)ceil(sqrt((float)(far_x * far_x + far_y * far_y))) + 1;
+			command.bounds.x = command.target.x + command.center.x - bounds_radius;
+			command.bounds.y = command.target.y + command.center.y - bounds_radius;
+			command.bounds.w = command.bounds.h = bounds_radius * 2 + 1;
 		}
 		else
 		{
-			SDL_RenderDrawRect(m_renderer, &TargetRect);
+			command.bounds = command.target;
 		}
+
+		push_draw_command(command);
 	}
 
-	NESSENGINE_API void Renderer::draw_circle(const Pointi& position, float radius, const Color& color, EBlendModes mode)
+	const Utils::WorkersPoolPtr& Renderer::get_workers_pool()
+	{
+		if (!m_workers_pool)
+			m_workers_pool = ness_make_ptr<Utils::WorkersPool>();
+		return m_workers_pool;
+	}
+
+	void Renderer::push_animation_task(const Utils::WorkerTaskPtr& task)
+	{
+		get_workers_pool()->push_task(task);
+		m_animation_tasks_pending = true;
+	}
+
+	void Renderer::join_animation_tasks()
 	{
-		// set blend mode and color
-		SDL_SetRenderDrawBlendMode(m_renderer, (SDL_BlendMode)mode);
-		SDL_SetRenderDrawColor(m_renderer, (Uint8)(color.r * 255), (Uint8)(color.g * 255), (Uint8)(color.b * 255), (Uint8)(color.a * 255));
+		if (!m_animation_tasks_pending)
+			return;
+		m_animation_tasks_pending = false;
+		m_workers_pool->wait_all();
+	}
+
+	void Renderer::set_deferred_rendering(bool enable)
+	{
+		// render whatever is pending before switching modes
+		if (!enable)
+			flush_draw_commands();
+		m_deferred_rendering = enable;
+	}
 
-		float two_pi = 6.283f;
-		float angle_inc = 1.0f / radius;
-		for(float angle=0.0f; angle<= two_pi;angle+=angle_inc){
-			int xpos = (int)(position.x + radius * cos(angle));
-			int ypos = (int)(position.y + radius * sin(angle));
-			SDL_RenderDrawPoint(m_renderer, xpos, ypos);
+	void Renderer::push_draw_command(const SDrawCommand& command)
+	{
+		// deferred mode - store for later
+		if (m_deferred_rendering)
+		{
+			m_draw_commands.push_back(command);
+			return;
 		}
+
+		// render immediately
+		if (command.type == DRAW_CMD_BLIT)
+			apply_texture_state(command);
+		else
+			apply_draw_state(command);
+		execute_draw_command(command);
+		submit_batches(command.type);
 	}
 
-	void Renderer::draw_line(const Ness::Pointi& a, const Ness::Pointi& b, const Color& color, EBlendModes mode)
+	void Renderer::apply_texture_state(const SDrawCommand& command)
 	{
-		// set blend mode and color
-		SDL_SetRenderDrawBlendMode(m_renderer, (SDL_BlendMode)mode);
-		SDL_SetRenderDrawColor(m_renderer, (Uint8)(color.r * 255), (Uint8)(color.g * 255), (Uint8)(color.b * 255), (Uint8)(color.a * 255));
+		// no cache? just set everything
+		if (!m_texture_state_cache)
+		{
+			SDL_SetTextureAlphaMod(command.texture, command.a);
+			SDL_SetTextureColorMod(command.texture, command.r, command.g, command.b);
+			SDL_SetTextureBlendMode(command.texture, command.blend);
+			return;
+		}
+
+		// get the texture last known state (most of the time it will be the same texture as last call)
+		if (command.texture != m_last_state_texture)
+		{
+			auto state = m_textures_state.find(command.texture);
+
+			// texture we never touched before - set everything and store its state
+			if (state == m_textures_state.end())
+			{
+				SDL_SetTextureAlphaMod(command.texture, command.a);
+				SDL_SetTextureColorMod(command.texture, command.r, command.g, command.b);
+				SDL_SetTextureBlendMode(command.texture, command.blend);
+				m_texture_state_misses += 3;
+
+				STextureState& new_state = m_textures_state[command.texture];
+				new_state.r = command.r; new_state.g = command.g; new_state.b = command.b; new_state.a = command.a;
+				new_state.blend = command.blend;
+				m_last_state_texture = command.texture;
+				m_last_texture_state = &new_state;
+				return;
+			}
+
+			m_last_state_texture = command.texture;
+			m_last_texture_state = &state->second;
+		}
 
-		// render the line
-		SDL_RenderDrawLine(m_renderer, a.x, a.y, b.x, b.y);
+		// set only what changed
+		STextureState& state = *m_last_texture_state;
+		if (state.a != command.a)
+		{
+			SDL_SetTextureAlphaMod(command.texture, command.a);
+			state.a = command.a;
+			m_texture_state_misses++;
+		}
+		else
+		{
+			m_texture_state_hits++;
+		}
+		if (state.r != command.r || state.g != command.g || state.b != command.b)
+		{
+			SDL_SetTextureColorMod(command.texture, command.r, command.g, command.b);
+			state.r = command.r; state.g = command.g; state.b = command.b;
+			m_texture_state_misses++;
+		}
+		else
+		{
+			m_texture_state_hits++;
+		}
+		if (state.blend != command.blend)
+		{
+			SDL_SetTextureBlendMode(command.texture, command.blend);
+			state.blend = command.blend;
+			m_texture_state_misses++;
+		}
+		else
+		{
+			m_texture_state_hits++;
+		}
 	}
 
-	void Renderer::blit(SDL_Texture* texture, const Rectangle* SrcRect, const Rectangle& TargetRect, EBlendModes mode, const Color& color, float rotation, Point rotation_anchor)
+	void Renderer::set_texture_state_cache(bool enable)
+	{
+		m_texture_state_cache = enable;
+		reset_texture_state_cache();
+	}
+
+	void Renderer::reset_texture_state_cache()
+	{
+		m_textures_state.clear();
+		m_last_state_texture = nullptr;
+		m_last_texture_state = nullptr;
+	}
+
+	void Renderer::apply_draw_state(const SDrawCommand& command)
 	{
+		SDL_SetRenderDrawBlendMode(m_renderer, command.blend);
+		SDL_SetRenderDrawColor(m_renderer, command.r, command.g, command.b, command.a);
+	}
 
-		// set alpha
-		float alpha = color.a;
-		SDL_SetTextureAlphaMod(texture, (int)(alpha * 255));
+	bool Renderer::is_same_state(const SDrawCommand& a, const SDrawCommand& b) const
+	{
+		return (a.type == b.type && a.texture == b.texture && a.blend == b.blend &&
+			a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a);
+	}
 
-		// set color
-		SDL_SetTextureColorMod(texture, (Uint8)(color.r * 255), (Uint8)(color.g * 255), (Uint8)(color.b * 255));
+	bool Renderer::can_group(const SDrawCommand& a, const SDrawCommand& b) const
+	{
+#ifdef NESSENGINE_RENDER_GEOMETRY
+		// in geometry batch color is part of the vertices, so only texture and blend mode matters
+		if (m_geometry_texture && a.type == DRAW_CMD_BLIT)
+		{
+			return (b.type == DRAW_CMD_BLIT && a.texture == b.texture && a.blend == b.blend);
+		}
+#endif
+		return is_same_state(a, b);
+	}
 
-		// set blend mode
-		SDL_SetTextureBlendMode(texture, (SDL_BlendMode)mode);
+	void Renderer::set_geometry_batching(bool enable)
+	{
+		m_geometry_batching = enable;
+	}
 
-		// requires advance rendering?
-		if ((rotation != 0.0f) || (alpha < 1.0f) || TargetRect.w < 0 || TargetRect.h < 0)
+	bool Renderer::is_geometry_batching() const
+	{
+#ifdef NESSENGINE_RENDER_GEOMETRY
+		return m_geometry_batching;
+#else
+		return false;
+#endif
+	}
+
+#ifdef NESSENGINE_RENDER_GEOMETRY
+	void Renderer::begin_geometry_batch(SDL_Texture* texture)
+	{
+		int w, h;
+		SDL_QueryTexture(texture, nullptr, nullptr, &w, &h);
+		m_geometry_texture = texture;
+		m_geometry_texture_w = (float)w;
+		m_geometry_texture_h = (float)h;
+	}
+
+	void Renderer::add_geometry_quad(const SDrawCommand& command)
+	{
+		// get texture coords
+		float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+		if (command.has_source)
 		{
-			// set flipping for negative scale and fix target size
-			Rectangle target = TargetRect;
-			int flip = SDL_FLIP_NONE;
-			if (target.w < 0)
+			u0 = command.source.x / m_geometry_texture_w;
+			v0 = command.source.y / m_geometry_texture_h;
+			u1 = (command.source.x + command.source.w) / m_geometry_texture_w;
+			v1 = (command.source.y + command.source.h) / m_geometry_texture_h;
+		}
+
+		// flip is done by swapping texture coords
+		if (command.advanced && (command.flip & SDL_FLIP_HORIZONTAL))
+			std::swap(u0, u1);
+		if (command.advanced && (command.flip & SDL_FLIP_VERTICAL))
+			std::swap(v0, v1);
+
+		// get corners relative to rotation center
+		float cx = 0.0f, cy = 0.0f;
+		if (command.advanced)
+		{
+			cx = (float)command.center.x;
+			cy = (float)command.center.y;
+		}
+		float left = -cx;
+		float top = -cy;
+		float right = command.target.w - cx;
+		float bottom = command.target.h - cy;
+		float corners[4][2] = {{left, top}, {right, top}, {right, bottom}, {left, bottom}};
+		float uvs[4][2] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+
+		// rotate (same direction as SDL_RenderCopyEx - clockwise, in degrees)
+		float sin_angle = 0.0f, cos_angle = 1.0f;
+		if (command.advanced && command.rotation != 0.0f)
+		{
+			float rad = DEGREE_TO_RADIAN(command.rotation);
+			sin_angle = sin(rad);
+			cos_angle = cos(rad);
+		}
+
+		// add vertices
+		int base = (int)m_geometry_vertices.size();
+		SDL_Vertex vertex;
+		vertex.color.r = command.r; vertex.color.g = command.g; vertex.color.b = command.b; vertex.color.a = command.a;
+		for (int i = 0; i < 4; ++i)
+		{
+			vertex.position.x = command.target.x + cx + (corners[i][0] * cos_angle - corners[i][1] * sin_angle);
+			vertex.position.y = command.target.y + cy + (corners[i][0] * sin_angle + corners[i][1] * cos_angle);
+			vertex.tex_coord.x = uvs[i][0];
+			vertex.tex_coord.y = uvs[i][1];
+			m_geometry_vertices.push_back(vertex);
+		}
+
+		// add the two triangles
+		m_geometry_indices.push_back(base); m_geometry_indices.push_back(base + 1); m_geometry_indices.push_back(base + 2);
+		m_geometry_indices.push_back(base); m_geometry_indices.push_back(base + 2); m_geometry_indices.push_back(base + 3);
+		m_geometry_commands.push_back(&command);
+	}
+#endif
+
+	void Renderer::execute_draw_command(const SDrawCommand& command)
+	{
+		switch (command.type)
+		{
+		case DRAW_CMD_BLIT:
+#ifdef NESSENGINE_RENDER_GEOMETRY
+			if (m_geometry_texture)
 			{
-				target.w *= -1;
-				flip |= SDL_FLIP_HORIZONTAL;
+				add_geometry_quad(command);
+				break;
 			}
-			if (target.h < 0)
+#endif
+			if (command.advanced)
 			{
-				target.h *= -1;
-				flip |= SDL_FLIP_VERTICAL;
+				SDL_RenderCopyEx(m_renderer, command.texture, command.has_source ? &command.source : nullptr,
+					&command.target, command.rotation, &command.center, command.flip);
 			}
+			else
+			{
+				SDL_RenderCopy(m_renderer, command.texture, command.has_source ? &command.source : nullptr, &command.target);
+			}
+			break;
 
+		case DRAW_CMD_FILL_RECT:
+		case DRAW_CMD_RECT:
+			m_rects_batch.push_back(command.target);
+			break;
 
-			// set rotation anchor
-			SDL_Point center;
-			center.x = (int)floor(rotation_anchor.x * target.w);
-			center.y = (int)floor(rotation_anchor.y * target.h);
+		case DRAW_CMD_LINE:
+			SDL_RenderDrawLine(m_renderer, command.target.x, command.target.y, command.target.w, command.target.h);
+			break;
 
-			// render with full settings!
-			SDL_RenderCopyEx(m_renderer, texture, SrcRect, &target, rotation, &center, (SDL_RendererFlip)flip);
+		case DRAW_CMD_CIRCLE:
+			{
+				float two_pi = 6.283f;
+				float angle_inc = 1.0f / command.radius;
+				SDL_Point point;
+				for(float angle=0.0f; angle<= two_pi;angle+=angle_inc){
+					point.x = (int)(command.target.x + command.radius * cos(angle));
+					point.y = (int)(command.target.y + command.radius * sin(angle));
+					m_points_batch.push_back(point);
+				}
+			}
+			break;
+		};
+	}
+
+	void Renderer::submit_batches(EDrawCommandType type)
+	{
+#ifdef NESSENGINE_RENDER_GEOMETRY
+		if (m_geometry_texture)
+		{
+			SDL_Texture* texture = m_geometry_texture;
+			m_geometry_texture = nullptr;
+			if (!m_geometry_vertices.empty())
+			{
+				// render the geometry. if failed (renderer that doesn't support geometry) disable batching and render the blits one by one
+				if (SDL_RenderGeometry(m_renderer, texture, &m_geometry_vertices[0], (int)m_geometry_vertices.size(),
+					&m_geometry_indices[0], (int)m_geometry_indices.size()) != 0)
+				{
+					m_geometry_batching = false;
+					for (auto command = m_geometry_commands.begin(); command != m_geometry_commands.end(); ++command)
+					{
+						apply_texture_state(**command);
+						execute_draw_command(**command);
+					}
+				}
+				m_geometry_vertices.clear();
+				m_geometry_indices.clear();
+				m_geometry_commands.clear();
+			}
 		}
-		// simple rendering - no flip, no rotation
-		else
+#endif
+		if (!m_rects_batch.empty())
+		{
+			if (type == DRAW_CMD_FILL_RECT)
+				SDL_RenderFillRects(m_renderer, &m_rects_batch[0], (int)m_rects_batch.size());
+			else
+				SDL_RenderDrawRects(m_renderer, &m_rects_batch[0], (int)m_rects_batch.size());
+			m_rects_batch.clear();
+		}
+		if (!m_points_batch.empty())
+		{
+			SDL_RenderDrawPoints(m_renderer, &m_points_batch[0], (int)m_points_batch.size());
+			m_points_batch.clear();
+		}
+	}
+
+	void Renderer::flush_draw_commands()
+	{
+		if (m_draw_commands.empty())
+			return;
+
+		const SDrawCommand* commands = &m_draw_commands[0];
+		size_t count = m_draw_commands.size();
+		m_draw_commands_done.assign(count, false);
+
+		// the last draw state we applied, so we won't set the same state twice in a row.
+		// note: for textures we don't need this, the textures state cache takes care of it.
+		const SDrawCommand* last_draw_state = nullptr;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			// skip commands that were already executed as part of a previous group
+			if (m_draw_commands_done[i])
+				continue;
+
+			// set state (only if changed)
+			const SDrawCommand& curr = commands[i];
+			if (curr.type == DRAW_CMD_BLIT)
+			{
+#ifdef NESSENGINE_RENDER_GEOMETRY
+				// when batching geometry the color goes into the vertices, so texture color must be white
+				if (m_geometry_batching)
+				{
+					SDrawCommand white_state = curr;
+					white_state.r = white_state.g = white_state.b = white_state.a = 255;
+					apply_texture_state(white_state);
+					begin_geometry_batch(curr.texture);
+				}
+				else
+#endif
+				apply_texture_state(curr);
+			}
+			else
+			{
+				if (last_draw_state == nullptr || last_draw_state->blend != curr.blend || last_draw_state->r != curr.r ||
+					last_draw_state->g != curr.g || last_draw_state->b != curr.b || last_draw_state->a != curr.a)
+					apply_draw_state(curr);
+				last_draw_state = &curr;
+			}
+
+			// execute the command that starts this group
+			execute_draw_command(curr);
+			m_draw_commands_done[i] = true;
+
+			// look ahead for more commands with the same state we can execute now.
+			// a command can only be pulled forward if it doesn't overlap any command it skips over, so the final
+			// result is exactly like rendering in the original order.
+			m_flush_blockers.clear();
+			unsigned int scanned = 0;
+			for (size_t j = i + 1; j < count && scanned < m_deferred_lookahead; ++j)
+			{
+				if (m_draw_commands_done[j])
+					continue;
+				scanned++;
+
+				const SDrawCommand& next = commands[j];
+				bool can_execute = can_group(curr, next);
+				for (size_t k = 0; can_execute && k < m_flush_blockers.size(); ++k)
+				{
+					if (SDL_HasIntersection(&m_flush_blockers[k], &next.bounds))
+						can_execute = false;
+				}
+
+				// execute or mark as a blocker for the commands after it
+				if (can_execute)
+				{
+					execute_draw_command(next);
+					m_draw_commands_done[j] = true;
+				}
+				else
+				{
+					m_flush_blockers.push_back(next.bounds);
+				}
+			}
+
+			// submit rects, points and geometry collected for this group
+			submit_batches(curr.type);
+		}
+
+		m_draw_commands.clear();
+	}
+
+	void Renderer::__texture_destroyed(SDL_Texture* texture)
+	{
+		// if there are pending commands that use this texture, we must render them now
+		for (auto command = m_draw_commands.begin(); command != m_draw_commands.end(); ++command)
+		{
+			if (command->texture == texture)
+			{
+				flush_draw_commands();
+				break;
+			}
+		}
+
+		// remove from textures state cache (a new texture might get the same address)
+		m_textures_state.erase(texture);
+		if (m_last_state_texture == texture)
 		{
-			SDL_RenderCopy(m_renderer, texture, SrcRect, &TargetRect);
+			m_last_state_texture = nullptr;
+			m_last_texture_state = nullptr;
 		}
 	}
 
@@ -37,6 +37,8 @@
 #include "../scene/viewport.h"
 #include "../gui/gui_manager.h"
 #include "../scene/camera/null_camera.h"
+#include "draw_command.h"
+#include "../utils/threads/workers_pool.h"
 
 namespace Ness
 {
@@ -79,6 +81,13 @@ namespace Ness
 		DEFAULT_RENDERER_FLAGS =			(RENDERER_FLAG_ACCELERATED | RENDERER_FLAG_LIGHTING_NODE)
 	};
 
+	// the last color, alpha and blend mode we set on a texture (used to skip redundant state changes)
+	struct STextureState
+	{
+		Uint8				r, g, b, a;
+		SDL_BlendMode		blend;
+	};
+
 	/**
 	* our main renderer class! manage all the rendering and frames functionality.
 	* usually you only create 1 renderer class, but you can also create multiple renderers.
@@ -106,8 +115,33 @@ namespace Ness
 		Colorb														m_background_color;			// background clear color
 		const int													m_flags;					// init flags (passed in constructor)
 		bool														m_auto_animate;				// do animations automatically (default to true)
+		Utils::WorkersPoolPtr										m_workers_pool;				// workers pool for parallel tasks (created on first use)
+		bool														m_parallel_particles;		// if true, particles nodes are simulated in parallel on the workers pool
+		bool														m_animation_tasks_pending;	// true if animation tasks were pushed and not joined yet
 		bool														m_diff_renderer_size;		// are we using different renderer size? (set_renderer_size)
 		NullCameraPtr												m_null_camera;				// default null camera (when no camera is used)
+		bool														m_deferred_rendering;		// if true, blit and draw calls are stored as draw commands and rendered on flush
+		unsigned int												m_deferred_lookahead;		// how many commands ahead to look for commands with the same state when flushing
+		Containers::Vector<SDrawCommand>							m_draw_commands;			// pending draw commands (deferred rendering mode)
+		Containers::Vector<bool>									m_draw_commands_done;		// while flushing: which draw commands were already executed
+		Containers::Vector<SDL_Rect>								m_flush_blockers;			// while flushing: bounds of skipped commands, that later commands must not overlap
+		Containers::Vector<SDL_Rect>								m_rects_batch;				// rectangles waiting to be submitted in a single call
+		Containers::Vector<SDL_Point>								m_points_batch;				// points waiting to be submitted in a single call
+		bool														m_texture_state_cache;		// if true, will remember the state of every texture and skip setting the same state again
+		Containers::UnorderedMap<SDL_Texture*, STextureState>		m_textures_state;			// last known state of every texture we rendered
+		SDL_Texture*												m_last_state_texture;		// the last texture we looked up in the textures state cache
+		STextureState*												m_last_texture_state;		// the state of the last texture we looked up
+		unsigned int												m_texture_state_hits;		// how many texture state changes were skipped thanks to the cache
+		unsigned int												m_texture_state_misses;		// how many texture state changes were actually performed
+		bool														m_geometry_batching;		// if true, will render groups of blits with the same texture as a single geometry (deferred mode only)
+#ifdef NESSENGINE_RENDER_GEOMETRY
+		SDL_Texture*												m_geometry_texture;			// while flushing: the texture of the current geometry batch (or null if not batching)
+		float														m_geometry_texture_w;		// while flushing: width of the current geometry batch texture
+		float														m_geometry_texture_h;		// while flushing: height of the current geometry batch texture
+		Containers::Vector<SDL_Vertex>								m_geometry_vertices;		// vertices of the current geometry batch
+		Containers::Vector<int>										m_geometry_indices;			// indices of the current geometry batch
+		Containers::Vector<const SDrawCommand*>						m_geometry_commands;		// the commands in the current geometry batch (in case we need to fallback)
+#endif
 
 	public:
 		// create the renderer instance!
@@ -163,6 +197,21 @@ namespace Ness
 		// enable/disable auto animate (default to true)
 		NESSENGINE_API inline void animate_automatically(bool enable) {m_auto_animate = enable;}
 
+		// get the renderer workers pool, used to run tasks in parallel during the frame (created on first use)
+		NESSENGINE_API const Utils::WorkersPoolPtr& get_workers_pool();
+
+		// set if particles nodes (in particles pool mode) should simulate in parallel on the workers pool during the animation phase.
+		// all the parallel simulations are joined at the end of the animation phase, before next frame is rendered.
+		NESSENGINE_API inline void set_parallel_particles(bool enable) {m_parallel_particles = enable;}
+		NESSENGINE_API inline bool is_parallel_particles() const {return m_parallel_particles;}
+
+		// push a task to run on the workers pool during the animation phase.
+		// animation tasks are joined automatically after the animators run (or you can call join_animation_tasks())
+		NESSENGINE_API void push_animation_task(const Utils::WorkerTaskPtr& task);
+
+		// wait until all pending animation tasks are done
+		NESSENGINE_API void join_animation_tasks();
+
 		// set the title of the window
 		NESSENGINE_API void set_window_title(const String& NewTitle);
 
@@ -235,11 +284,20 @@ namespace Ness
 		// return a unique frame id number (increased by 1 every end of frame)
 		NESSENGINE_API inline unsigned int get_frameid() const {return m_frameid;}
 
-		// render managed texture
+		// render managed texture.
+		// if the texture is a region inside an atlas page, source rect is relative to the region.
 		NESSENGINE_API inline void blit(ManagedResources::ManagedTexturePtr texture, const Rectangle* SrcRect, 
 			const Rectangle& TargetRect, EBlendModes mode = BLEND_MODE_NONE, const Color& color = Color::WHITE, float rotation = 0.0f, 
 			Point rotation_anchor = Point::HALF) 
 		{
+			if (texture->is_region())
+			{
+				Rectangle source = SrcRect ? *SrcRect : Rectangle(Pointi::ZERO, texture->get_size());
+				source.x += texture->get_region_offset().x;
+				source.y += texture->get_region_offset().y;
+				blit(texture->texture(), &source, TargetRect, mode, color, rotation, rotation_anchor);
+				return;
+			}
 			blit(texture->texture(), SrcRect, TargetRect, mode, color, rotation, rotation_anchor);
 		}
 
@@ -258,9 +316,50 @@ namespace Ness
 		// draw a line between point a and b
 		NESSENGINE_API void draw_line(const Ness::Pointi& a, const Ness::Pointi& b, const Color& color, EBlendModes mode = BLEND_MODE_NONE);
 
+		// enable/disable deferred rendering.
+		// when enabled, blit() and the draw functions don't render immediately but store a draw command. the commands
+		// are flushed at the end of the frame or when changing render target. while flushing, commands with the same texture,
+		// blend mode and color are grouped together to save state changes, but the order of overlapping objects is always kept.
+		NESSENGINE_API void set_deferred_rendering(bool enable);
+		NESSENGINE_API inline bool is_deferred_rendering() const {return m_deferred_rendering;}
+
+		// set how many commands ahead the flush may search for commands with the same state (default to 32).
+		// higher values means better grouping but more cpu time while flushing.
+		NESSENGINE_API inline void set_deferred_lookahead(unsigned int lookahead) {m_deferred_lookahead = lookahead;}
+
+		// render all the pending draw commands (deferred rendering mode).
+		// you don't need to call this yourself, unless you access the sdl renderer directly.
+		NESSENGINE_API void flush_draw_commands();
+
+		// enable/disable the texture state cache (default to enabled).
+		// when enabled, the renderer remember the color, alpha and blend mode it set on every texture and skip the sdl calls
+		// if they didn't change. if you change textures state directly via sdl, disable this (or call reset_texture_state_cache())
+		NESSENGINE_API void set_texture_state_cache(bool enable);
+		NESSENGINE_API inline bool is_texture_state_cache() const {return m_texture_state_cache;}
+
+		// forget all the cached textures state
+		NESSENGINE_API void reset_texture_state_cache();
+
+		// get texture state cache hits (sdl state calls skipped) and misses (sdl state calls performed).
+		// every blit counts as 3 state calls - alpha, color and blend mode.
+		NESSENGINE_API inline unsigned int get_texture_state_hits() const {return m_texture_state_hits;}
+		NESSENGINE_API inline unsigned int get_texture_state_misses() const {return m_texture_state_misses;}
+		NESSENGINE_API inline void reset_texture_state_counters() {m_texture_state_hits = m_texture_state_misses = 0;}
+
+		// enable/disable geometry batching (default to enabled).
+		// when enabled and in deferred rendering mode, consecutive blits with the same texture and blend mode are rendered as a single
+		// textured geometry, rather than a render-copy per blit. rotation, flipping and color are all baked into the vertices.
+		// note: requires sdl 2.0.18 or newer. with older sdl versions this does nothing and is_geometry_batching() always returns false.
+		NESSENGINE_API void set_geometry_batching(bool enable);
+		NESSENGINE_API bool is_geometry_batching() const;
+
 		// return the sdl renderer
 		inline SDL_Renderer* __sdl_renderer() {return m_renderer;}
 
+		// called before destroying an sdl texture, to make sure there are no pending draw commands using it.
+		// DONT USE THIS ON YOUR OWN, it supposed to happen automatically when texture is deleted.
+		NESSENGINE_API void __texture_destroyed(SDL_Texture* texture);
+
 	protected:
 		// set/remove the current rendering target. note: this does not effect the rendering targets queue, it only set or reset the current target
 		NESSENGINE_API void set_render_target(const ManagedResources::ManagedTexturePtr& texture);
@@ -270,5 +369,32 @@ namespace Ness
 		// set some starting default values
 		NESSENGINE_API void base_init();
 
+		// add a draw command. in deferred mode will store it for later, else will execute it immediately
+		void push_draw_command(const SDrawCommand& command);
+
+		// set the texture state (color, alpha and blend) / renderer draw state (color and blend) for a draw command
+		void apply_texture_state(const SDrawCommand& command);
+		void apply_draw_state(const SDrawCommand& command);
+
+		// return if two draw commands are of the same type and require the same rendering state
+		bool is_same_state(const SDrawCommand& a, const SDrawCommand& b) const;
+
+		// return if two draw commands can be executed in the same group while flushing.
+		// this is like is_same_state(), but blits with different colors can share a geometry batch.
+		bool can_group(const SDrawCommand& a, const SDrawCommand& b) const;
+
+#ifdef NESSENGINE_RENDER_GEOMETRY
+		// start a geometry batch with a given texture (while flushing)
+		void begin_geometry_batch(SDL_Texture* texture);
+
+		// add a blit command to the current geometry batch, as 2 triangles
+		void add_geometry_quad(const SDrawCommand& command);
+#endif
+
+		// execute a single draw command without setting its state.
+		// note: rectangles and circle points are added to batches and will only be rendered when calling submit_batches()
+		void execute_draw_command(const SDrawCommand& command);
+		void submit_batches(EDrawCommandType type);
+
 	};
 };
\ No newline at end of file
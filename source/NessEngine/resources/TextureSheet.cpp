@@ -30,20 +30,33 @@ namespace Ness
 {
 	namespace Resources
 	{
-		TextureSheet::TextureSheet(const String& file_name, SDL_Renderer* renderer, const Colorb* ColorKey) : m_texture(nullptr)
+		TextureSheet::TextureSheet(const String& file_name, SDL_Renderer* renderer, const Colorb* ColorKey) : m_texture(nullptr), m_owns_texture(true)
 		{
 			load_file(file_name.c_str(), renderer, ColorKey);
 		}
 
-		TextureSheet::TextureSheet(SDL_Renderer* renderer, const Sizei& size) : m_texture(nullptr)
+		TextureSheet::TextureSheet(SDL_Renderer* renderer, const Sizei& size) : m_texture(nullptr), m_owns_texture(true)
 		{
 			create_blank(renderer, size);
 		}
 
+		TextureSheet::TextureSheet(const String& file_name) : m_texture(nullptr), m_size(Sizei::ZERO), m_file_name(file_name), m_owns_texture(true)
+		{
+		}
+
+		TextureSheet::TextureSheet(SDL_Texture* texture, const Sizei& size) : m_texture(texture), m_size(size), m_owns_texture(true)
+		{
+		}
+
+		TextureSheet::TextureSheet(SDL_Texture* page, const Rectangle& region, const String& file_name) 
+			: m_texture(page), m_size(region.w, region.h), m_file_name(file_name), m_region_offset(region.x, region.y), m_owns_texture(false)
+		{
+		}
+
 		// destroy the texture
 		TextureSheet::~TextureSheet()
 		{
-			if (m_texture)
+			if (m_texture && m_owns_texture)
 			{
 				SDL_DestroyTexture( m_texture );
 			}
@@ -59,12 +72,27 @@ namespace Ness
 		// load texture from file
 		void TextureSheet::load_file(const char* file_name, SDL_Renderer* renderer, const Colorb* ColorKey)
 		{
+			// load the image
+			String error;
+			SDL_Surface* loadedSurface = decode_file(file_name, ColorKey, error);
+			if( loadedSurface == nullptr )
+			{
+				throw FailedToLoadTextureFile(file_name, error.c_str());
+			}
+
+			// set file_name and create the texture
+			m_file_name = file_name;
+			load_surface(loadedSurface, renderer);
+		}
 
+		SDL_Surface* TextureSheet::decode_file(const String& file_name, const Colorb* ColorKey, String& error)
+		{
 			// load the image
-			SDL_Surface* loadedSurface = IMG_Load( file_name );
+			SDL_Surface* loadedSurface = IMG_Load( file_name.c_str() );
 			if( loadedSurface == nullptr )
 			{
-				throw FailedToLoadTextureFile(file_name, IMG_GetError());
+				error = IMG_GetError();
+				return nullptr;
 			}
 
 			// set color key (if provided)
@@ -73,24 +101,27 @@ namespace Ness
 				SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, ColorKey->r, ColorKey->g, ColorKey->b));
 			}
 
+			return loadedSurface;
+		}
+
+		void TextureSheet::load_surface(SDL_Surface* surface, SDL_Renderer* renderer)
+		{
 			// store size
-			m_size.x = loadedSurface->w;
-			m_size.y = loadedSurface->h;
+			m_size.x = surface->w;
+			m_size.y = surface->h;
 
 			// create the texture
-			m_texture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
+			m_texture = SDL_CreateTextureFromSurface(renderer, surface);
 		
 			// free the surface
-			SDL_FreeSurface( loadedSurface );
+			SDL_FreeSurface( surface );
 
 			// failed to create texture??
 			if( m_texture == nullptr )
 			{
-				throw FailedToLoadTextureFile(file_name, IMG_GetError());
+				m_size = Sizei::ZERO;
+				throw FailedToLoadTextureFile(m_file_name.c_str(), SDL_GetError());
 			}
-
-			// set file_name
-			m_file_name = file_name;
 		}
 	};
 };
\ No newline at end of file
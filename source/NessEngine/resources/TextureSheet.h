@@ -47,6 +47,8 @@ namespace Ness
 			SDL_Texture*	m_texture;
 			Sizei			m_size;
 			String			m_file_name;
+			Pointi			m_region_offset;		// if this texture is a region inside a bigger texture (atlas page), the region position
+			bool			m_owns_texture;			// if false, m_texture belongs to someone else (atlas page) and we won't destroy it
 
 		public:
 			// create the texture sheet from file
@@ -56,6 +58,35 @@ namespace Ness
 			// create the texture sheet as blank texture you can render on
 			NESSENGINE_API TextureSheet(SDL_Renderer* renderer, const Sizei& size);
 
+			// create an empty texture sheet that will be loaded later with load_surface() (used for background loading).
+			// until loaded, texture() will return null and size will be zero.
+			NESSENGINE_API TextureSheet(const String& file_name);
+
+			// create the texture sheet from an existing texture (takes ownership on the texture)
+			NESSENGINE_API TextureSheet(SDL_Texture* texture, const Sizei& size);
+
+			// create the texture sheet as a region inside another texture (like an atlas page).
+			// the page texture is not owned by this sheet and must outlive it.
+			// texture() will return the page texture, and size will be the region size.
+			NESSENGINE_API TextureSheet(SDL_Texture* page, const Rectangle& region, const String& file_name);
+
+			// load an image file into a surface, without creating the texture.
+			// this does not use the renderer, so it's safe to call from other threads.
+			// return null if failed, and set error with the reason.
+			NESSENGINE_API static SDL_Surface* decode_file(const String& file_name, const Colorb* ColorKey, String& error);
+
+			// create the texture from a surface loaded with decode_file(). this must be called from the rendering thread.
+			// note: this takes ownership on the surface and will free it.
+			NESSENGINE_API void load_surface(SDL_Surface* surface, SDL_Renderer* renderer);
+
+			// return if this texture is loaded (false only while waiting for load_surface())
+			NESSENGINE_API inline bool is_loaded() const {return m_texture != nullptr;}
+
+			// return if this texture is a region inside a bigger texture (atlas page).
+			// when rendering regions, source rects are relative to the region and should be offset by get_region_offset().
+			NESSENGINE_API inline bool is_region() const {return !m_owns_texture;}
+			NESSENGINE_API inline const Pointi& get_region_offset() const {return m_region_offset;}
+
 			// return texture file_name (if not loaded from file will be empty string)
 			NESSENGINE_API inline const String& get_file_name() const {return m_file_name;}
 
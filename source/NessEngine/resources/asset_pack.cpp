@@ -0,0 +1,422 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+#include "asset_pack.h"
+#include "../exceptions/exceptions.h"
+#include <algorithm>
+#include <fstream>
+#include <string.h>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace Ness
+{
+	namespace Resources
+	{
+		// the pixel format of textures in asset packs (R, G, B, A bytes on little-endian machines)
+		static const Uint32 ASSET_PACK_PIXEL_FORMAT = SDL_PIXELFORMAT_ABGR8888;
+
+		// data alignment inside the pack
+		static const Uint64 ASSET_PACK_DATA_ALIGNMENT = 16;
+
+		// return entry name with back slashes converted to forward slashes
+		static String normalize_name(const String& name)
+		{
+			String ret = name;
+			std::replace(ret.begin(), ret.end(), '\\', '/');
+			return ret;
+		}
+
+		// used to binary-search entries by hash
+		static bool compare_entry_hash(const SAssetPackEntry& entry, Uint64 hash)
+		{
+			return entry.name_hash < hash;
+		}
+
+		Uint64 AssetPack::hash_name(const String& name)
+		{
+			return ness_hash_path(name);
+		}
+
+		AssetPack::AssetPack(const String& file_name) 
+			: m_file_name(file_name), m_data(nullptr), m_size(0), m_header(nullptr), m_entries(nullptr), m_file_handle(nullptr), m_mapping_handle(nullptr)
+		{
+#ifdef _WIN32
+			// open the file
+			HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+			{
+				throw FileNotFound(file_name.c_str());
+			}
+			m_file_handle = file;
+
+			// get size
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size) || size.QuadPart < sizeof(SAssetPackHeader))
+			{
+				close();
+				throw WrongFormatError(("Invalid asset pack file: " + file_name).c_str());
+			}
+			m_size = (Uint64)size.QuadPart;
+
+			// map it
+			m_mapping_handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (m_mapping_handle)
+			{
+				m_data = (const Uint8*)MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0);
+			}
+			if (m_data == nullptr)
+			{
+				close();
+				throw UnexpectedError(("Failed to map asset pack file: " + file_name).c_str());
+			}
+#else
+			// open the file
+			int file = open(file_name.c_str(), O_RDONLY);
+			if (file < 0)
+			{
+				throw FileNotFound(file_name.c_str());
+			}
+
+			// get size
+			struct stat file_stat;
+			if (fstat(file, &file_stat) != 0 || (Uint64)file_stat.st_size < sizeof(SAssetPackHeader))
+			{
+				::close(file);
+				throw WrongFormatError(("Invalid asset pack file: " + file_name).c_str());
+			}
+			m_size = (Uint64)file_stat.st_size;
+
+			// map it (the mapping stays valid after closing the file)
+			void* data = mmap(nullptr, (size_t)m_size, PROT_READ, MAP_PRIVATE, file, 0);
+			::close(file);
+			if (data == MAP_FAILED)
+			{
+				throw UnexpectedError(("Failed to map asset pack file: " + file_name).c_str());
+			}
+			m_data = (const Uint8*)data;
+#endif
+
+			// validate the pack
+			m_header = (const SAssetPackHeader*)m_data;
+			m_entries = (const SAssetPackEntry*)(m_data + sizeof(SAssetPackHeader));
+			try
+			{
+				validate();
+			}
+			catch (...)
+			{
+				close();
+				throw;
+			}
+		}
+
+		AssetPack::~AssetPack()
+		{
+			close();
+		}
+
+		void AssetPack::close()
+		{
+#ifdef _WIN32
+			if (m_data)
+				UnmapViewOfFile(m_data);
+			if (m_mapping_handle)
+				CloseHandle(m_mapping_handle);
+			if (m_file_handle)
+				CloseHandle(m_file_handle);
+#else
+			if (m_data)
+				munmap((void*)m_data, (size_t)m_size);
+#endif
+			m_data = nullptr;
+			m_mapping_handle = nullptr;
+			m_file_handle = nullptr;
+		}
+
+		void AssetPack::validate() const
+		{
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+			throw WrongFormatError("Asset packs are not supported on big-endian machines!");
+#endif
+			// check header
+			if (memcmp(m_header->magic, NESS_ASSET_PACK_MAGIC, sizeof(m_header->magic)) != 0 || m_header->version != NESS_ASSET_PACK_VERSION)
+			{
+				throw WrongFormatError(("Invalid asset pack header or version: " + m_file_name).c_str());
+			}
+
+			// check entries and names are inside the file
+			Uint64 entries_end = sizeof(SAssetPackHeader) + (Uint64)m_header->entries_count * sizeof(SAssetPackEntry);
+			if (entries_end > m_size || m_header->names_offset < entries_end || m_header->names_offset > m_size)
+			{
+				throw WrongFormatError(("Invalid asset pack index: " + m_file_name).c_str());
+			}
+
+			// check all entries
+			Uint64 names_size = m_size - m_header->names_offset;
+			for (unsigned int i = 0; i < m_header->entries_count; i++)
+			{
+				const SAssetPackEntry& entry = m_entries[i];
+				bool valid = ((Uint64)entry.name_offset + entry.name_length <= names_size) &&
+					(entry.data_offset <= m_size) && (entry.data_size <= m_size - entry.data_offset) &&
+					(i == 0 || m_entries[i - 1].name_hash <= entry.name_hash);
+				if (valid && entry.type == ASSET_PACK_TEXTURE)
+				{
+					valid = (entry.format == ASSET_PACK_PIXEL_FORMAT) && (entry.data_size >= (Uint64)entry.width * entry.height * 4);
+				}
+				if (!valid)
+				{
+					throw WrongFormatError(("Invalid asset pack entry: " + m_file_name).c_str());
+				}
+			}
+		}
+
+		String AssetPack::get_name(const SAssetPackEntry& entry) const
+		{
+			const char* name = (const char*)(m_data + m_header->names_offset + entry.name_offset);
+			return String(name, entry.name_length);
+		}
+
+		const SAssetPackEntry* AssetPack::find(const String& name) const
+		{
+			// find the first entry with this hash
+			Uint64 hash = hash_name(name);
+			const SAssetPackEntry* end = m_entries + m_header->entries_count;
+			const SAssetPackEntry* curr = std::lower_bound(m_entries, end, hash, compare_entry_hash);
+
+			// check names (in case of hash collision)
+			String normalized = normalize_name(name);
+			for (; curr != end && curr->name_hash == hash; ++curr)
+			{
+				if (curr->name_length == normalized.length() && 
+					memcmp(m_data + m_header->names_offset + curr->name_offset, normalized.c_str(), curr->name_length) == 0)
+				{
+					return curr;
+				}
+			}
+			return nullptr;
+		}
+
+		SDL_Texture* AssetPack::create_texture(const SAssetPackEntry& entry, SDL_Renderer* renderer) const
+		{
+			SDL_Texture* texture = SDL_CreateTexture(renderer, entry.format, SDL_TEXTUREACCESS_STATIC, entry.width, entry.height);
+			if (texture == nullptr)
+			{
+				throw FailedToLoadTextureFile(get_name(entry).c_str(), SDL_GetError());
+			}
+			if (SDL_UpdateTexture(texture, nullptr, get_data(entry), entry.width * 4) != 0)
+			{
+				SDL_DestroyTexture(texture);
+				throw FailedToLoadTextureFile(get_name(entry).c_str(), SDL_GetError());
+			}
+			SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+			return texture;
+		}
+
+		SDL_Surface* AssetPack::create_surface(const SAssetPackEntry& entry) const
+		{
+			Uint32 rmask, gmask, bmask, amask;
+			int bpp;
+			SDL_PixelFormatEnumToMasks(entry.format, &bpp, &rmask, &gmask, &bmask, &amask);
+			SDL_Surface* surface = SDL_CreateRGBSurfaceFrom((void*)get_data(entry), entry.width, entry.height, bpp, entry.width * 4, rmask, gmask, bmask, amask);
+			if (surface == nullptr)
+			{
+				throw FailedToLoadTextureFile(get_name(entry).c_str(), SDL_GetError());
+			}
+			return surface;
+		}
+
+		AssetPackWriter::SPendingEntry& AssetPackWriter::add_entry(const String& name, EAssetPackEntryType type)
+		{
+			String normalized = normalize_name(name);
+			for (unsigned int i = 0; i < m_entries.size(); i++)
+			{
+				if (m_entries[i].name == normalized)
+				{
+					throw IllegalAction(("Asset pack entry already exist: " + normalized).c_str());
+				}
+			}
+
+			SPendingEntry entry;
+			entry.name = normalized;
+			entry.type = type;
+			entry.width = entry.height = entry.format = 0;
+			m_entries.push_back(entry);
+			return m_entries.back();
+		}
+
+		void AssetPackWriter::read_file(const String& file_name, Containers::Vector<Uint8>& out_data)
+		{
+			std::ifstream infile(file_name.c_str(), std::ios::in | std::ios::binary);
+			if (!infile.is_open())
+			{
+				throw FileNotFound(file_name.c_str());
+			}
+			infile.seekg(0, std::ios::end);
+			out_data.resize((size_t)infile.tellg());
+			infile.seekg(0, std::ios::beg);
+			if (!out_data.empty())
+				infile.read((char*)&out_data[0], out_data.size());
+		}
+
+		void AssetPackWriter::add_texture(const String& name, SDL_Surface* surface)
+		{
+			// convert to the pack pixel format by blitting on a transparent surface (so color key pixels stay transparent)
+			Uint32 rmask, gmask, bmask, amask;
+			int bpp;
+			SDL_PixelFormatEnumToMasks(ASSET_PACK_PIXEL_FORMAT, &bpp, &rmask, &gmask, &bmask, &amask);
+			SDL_Surface* rgba = SDL_CreateRGBSurface(0, surface->w, surface->h, bpp, rmask, gmask, bmask, amask);
+			if (rgba == nullptr)
+			{
+				throw FailedToLoadTextureFile(name.c_str(), SDL_GetError());
+			}
+			SDL_FillRect(rgba, nullptr, 0);
+			SDL_BlendMode prev_blend;
+			SDL_GetSurfaceBlendMode(surface, &prev_blend);
+			SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(surface, nullptr, rgba, nullptr);
+			SDL_SetSurfaceBlendMode(surface, prev_blend);
+
+			// copy the pixels without rows padding
+			SPendingEntry& entry = add_entry(name, ASSET_PACK_TEXTURE);
+			entry.width = rgba->w;
+			entry.height = rgba->h;
+			entry.format = ASSET_PACK_PIXEL_FORMAT;
+			unsigned int row_size = rgba->w * 4;
+			entry.data.resize(row_size * rgba->h);
+			SDL_LockSurface(rgba);
+			for (int y = 0; y < rgba->h; y++)
+			{
+				memcpy(&entry.data[y * row_size], (const Uint8*)rgba->pixels + y * rgba->pitch, row_size);
+			}
+			SDL_UnlockSurface(rgba);
+			SDL_FreeSurface(rgba);
+		}
+
+		void AssetPackWriter::add_font(const String& name, const String& file_name)
+		{
+			Containers::Vector<Uint8> data;
+			read_file(file_name, data);
+			add_entry(name, ASSET_PACK_FONT).data.swap(data);
+		}
+
+		void AssetPackWriter::add_file(const String& name, const String& file_name)
+		{
+			Containers::Vector<Uint8> data;
+			read_file(file_name, data);
+			add_entry(name, ASSET_PACK_FILE).data.swap(data);
+		}
+
+		// used to sort pending entries by hash before writing
+		struct SEntryOrder
+		{
+			Uint64			hash;
+			unsigned int	index;
+			bool operator<(const SEntryOrder& other) const {return hash < other.hash;}
+		};
+
+		void AssetPackWriter::write(const String& file_name)
+		{
+			// sort entries by name hash
+			Containers::Vector<SEntryOrder> order;
+			order.resize(m_entries.size());
+			for (unsigned int i = 0; i < m_entries.size(); i++)
+			{
+				order[i].hash = AssetPack::hash_name(m_entries[i].name);
+				order[i].index = i;
+			}
+			std::sort(order.begin(), order.end());
+
+			// build the index and the names
+			SAssetPackHeader header;
+			memcpy(header.magic, NESS_ASSET_PACK_MAGIC, sizeof(header.magic));
+			header.version = NESS_ASSET_PACK_VERSION;
+			header.entries_count = (Uint32)m_entries.size();
+			header.names_offset = sizeof(SAssetPackHeader) + m_entries.size() * sizeof(SAssetPackEntry);
+
+			Containers::Vector<SAssetPackEntry> index;
+			index.resize(m_entries.size());
+			String names;
+			for (unsigned int i = 0; i < order.size(); i++)
+			{
+				const SPendingEntry& pending = m_entries[order[i].index];
+				SAssetPackEntry& entry = index[i];
+				memset(&entry, 0, sizeof(entry));
+				entry.name_hash = order[i].hash;
+				entry.name_offset = (Uint32)names.length();
+				entry.name_length = (Uint32)pending.name.length();
+				entry.type = pending.type;
+				entry.width = pending.width;
+				entry.height = pending.height;
+				entry.format = pending.format;
+				entry.data_size = pending.data.size();
+				names += pending.name;
+			}
+
+			// set data offsets (aligned)
+			Uint64 offset = header.names_offset + names.length();
+			for (unsigned int i = 0; i < index.size(); i++)
+			{
+				offset = (offset + ASSET_PACK_DATA_ALIGNMENT - 1) / ASSET_PACK_DATA_ALIGNMENT * ASSET_PACK_DATA_ALIGNMENT;
+				index[i].data_offset = offset;
+				offset += index[i].data_size;
+			}
+
+			// write the file
+			std::ofstream outfile(file_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!outfile.is_open())
+			{
+				throw IllegalAction(("Failed to create asset pack file: " + file_name).c_str());
+			}
+			outfile.write((const char*)&header, sizeof(header));
+			if (!index.empty())
+				outfile.write((const char*)&index[0], index.size() * sizeof(SAssetPackEntry));
+			outfile.write(names.c_str(), names.length());
+			Uint64 written = header.names_offset + names.length();
+			for (unsigned int i = 0; i < index.size(); i++)
+			{
+				// padding
+				static const char zeros[ASSET_PACK_DATA_ALIGNMENT] = {0};
+				outfile.write(zeros, (std::streamsize)(index[i].data_offset - written));
+
+				// data
+				const Containers::Vector<Uint8>& data = m_entries[order[i].index].data;
+				if (!data.empty())
+					outfile.write((const char*)&data[0], data.size());
+				written = index[i].data_offset + data.size();
+			}
+			if (!outfile.good())
+			{
+				throw IllegalAction(("Failed to write asset pack file: " + file_name).c_str());
+			}
+		}
+	};
+};
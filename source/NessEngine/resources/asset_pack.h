@@ -0,0 +1,181 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+/**
+* Asset pack - a single file with many pre-decoded resources, loaded with memory mapping
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include "../exports.h"
+#include <SDL.h>
+#include "../basic_types/containers.h"
+#include "../basic_types/all_basic_types.h"
+
+namespace Ness
+{
+	namespace Resources
+	{
+		// asset pack file layout (all numbers are little-endian):
+		//	SAssetPackHeader
+		//	SAssetPackEntry * entries_count (sorted by name hash)
+		//	names of all entries (not null-terminated)
+		//	data of all entries (every entry data is aligned to 16 bytes)
+		#define NESS_ASSET_PACK_MAGIC	"NESSPACK"
+		#define NESS_ASSET_PACK_VERSION	1
+
+		// types of entries in asset pack
+		enum EAssetPackEntryType
+		{
+			ASSET_PACK_TEXTURE = 1,		// pre-decoded texture pixels (width * height * 4 bytes, in 'format' pixel format)
+			ASSET_PACK_FONT = 2,		// font file data
+			ASSET_PACK_FILE = 3,		// any other file (like gui settings)
+		};
+
+		// asset pack file header
+		struct SAssetPackHeader
+		{
+			char		magic[8];			// must be NESS_ASSET_PACK_MAGIC
+			Uint32		version;			// must be NESS_ASSET_PACK_VERSION
+			Uint32		entries_count;		// how many entries in pack
+			Uint64		names_offset;		// where the names start
+		};
+
+		// a single resource in asset pack
+		struct SAssetPackEntry
+		{
+			Uint64		name_hash;			// hash of the entry name (see AssetPack::hash_name())
+			Uint64		data_offset;		// where the data starts (from the beginning of the file)
+			Uint64		data_size;			// data size in bytes
+			Uint32		name_offset;		// where the name starts (from names_offset)
+			Uint32		name_length;		// name length in bytes
+			Uint32		type;				// entry type (EAssetPackEntryType)
+			Uint32		width;				// texture width (textures only)
+			Uint32		height;				// texture height (textures only)
+			Uint32		format;				// texture SDL pixel format (textures only)
+		};
+
+		/**
+		* a read-only asset pack, mapped into memory.
+		* the pack is created offline with AssetPackWriter (see the AssetBaker example), and contains textures pixels that are
+		* already decoded, so loading them is just uploading the mapped memory to the GPU.
+		* usually you don't use this class directly, but mount it with ResourcesManager::mount_pack().
+		*/
+		class AssetPack
+		{
+		private:
+			String						m_file_name;		// pack file name
+			const Uint8*				m_data;				// the mapped file data
+			Uint64						m_size;				// the mapped file size
+			const SAssetPackHeader*		m_header;			// the pack header (points to mapped data)
+			const SAssetPackEntry*		m_entries;			// the pack entries (points to mapped data)
+			void*						m_file_handle;		// os handle of the opened file
+			void*						m_mapping_handle;	// os handle of the file mapping (windows only)
+
+		public:
+			// open and map the pack file.
+			// will throw FileNotFound if can't open the file, or WrongFormatError if the file is not a valid pack.
+			NESSENGINE_API AssetPack(const String& file_name);
+
+			// unmap the pack file
+			NESSENGINE_API ~AssetPack();
+
+			// find an entry by name. return null if not found.
+			NESSENGINE_API const SAssetPackEntry* find(const String& name) const;
+
+			// get the data of an entry (points to the mapped file and valid as long as this pack exists)
+			NESSENGINE_API inline const void* get_data(const SAssetPackEntry& entry) const {return m_data + entry.data_offset;}
+
+			// get the name of an entry
+			NESSENGINE_API String get_name(const SAssetPackEntry& entry) const;
+
+			// get entries
+			NESSENGINE_API inline unsigned int get_entries_count() const {return m_header->entries_count;}
+			NESSENGINE_API inline const SAssetPackEntry& get_entry(unsigned int index) const {return m_entries[index];}
+
+			// get pack file name
+			NESSENGINE_API inline const String& get_file_name() const {return m_file_name;}
+
+			// create a texture from a texture entry, uploaded directly from the mapped memory
+			NESSENGINE_API SDL_Texture* create_texture(const SAssetPackEntry& entry, SDL_Renderer* renderer) const;
+
+			// create a surface from a texture entry. the surface pixels point to the mapped memory, so it's valid only as long as
+			// this pack exists, and you must not change its pixels.
+			NESSENGINE_API SDL_Surface* create_surface(const SAssetPackEntry& entry) const;
+
+			// return the hash of an entry name (see ness_hash_path())
+			NESSENGINE_API static Uint64 hash_name(const String& name);
+
+		private:
+			// make sure the mapped data is a valid pack
+			void validate() const;
+
+			// unmap and close the file
+			void close();
+		};
+
+		// asset pack pointer
+		NESSENGINE_API typedef SharedPtr<AssetPack> AssetPackPtr;
+
+		/**
+		* create asset pack files.
+		* add all the resources and then call write().
+		*/
+		class AssetPackWriter
+		{
+		private:
+			// an entry waiting to be written
+			struct SPendingEntry
+			{
+				String						name;
+				Uint32						type;
+				Uint32						width;
+				Uint32						height;
+				Uint32						format;
+				Containers::Vector<Uint8>	data;
+			};
+			Containers::Vector<SPendingEntry>	m_entries;
+
+		public:
+			// add a texture from a surface (converted to RGBA, color key is converted to transparent pixels)
+			NESSENGINE_API void add_texture(const String& name, SDL_Surface* surface);
+
+			// add a font or any other file as-is
+			NESSENGINE_API void add_font(const String& name, const String& file_name);
+			NESSENGINE_API void add_file(const String& name, const String& file_name);
+
+			// return how many entries were added
+			NESSENGINE_API inline unsigned int get_entries_count() const {return (unsigned int)m_entries.size();}
+
+			// write the pack file
+			NESSENGINE_API void write(const String& file_name);
+
+		private:
+			// add a new entry (throw exception if name already exist)
+			SPendingEntry& add_entry(const String& name, EAssetPackEntryType type);
+
+			// read a file into entry data
+			void read_file(const String& file_name, Containers::Vector<Uint8>& out_data);
+		};
+	};
+};
@@ -37,6 +37,19 @@ namespace Ness
 			}
 		}
 
+		LoadedFont::LoadedFont(const void* data, size_t data_size, const String& file_name, unsigned int font_size) : m_font(nullptr), m_file_name(file_name), m_font_size(font_size)
+		{
+			SDL_RWops* rw = SDL_RWFromConstMem(data, (int)data_size);
+			if (rw)
+			{
+				m_font = TTF_OpenFontRW(rw, 1, font_size);
+			}
+			if (!m_font)
+			{
+				throw FailedToLoadFont(file_name.c_str(), TTF_GetError());
+			}
+		}
+
 		LoadedFont::~LoadedFont()
 		{
 			if (m_font)
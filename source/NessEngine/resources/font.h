@@ -50,6 +50,9 @@ namespace Ness
 			// create the font from file
 			NESSENGINE_API LoadedFont(const String& file_name, unsigned int font_size = 12);
 
+			// create the font from font file data in memory (data must remain valid as long as the font exists)
+			NESSENGINE_API LoadedFont(const void* data, size_t data_size, const String& file_name, unsigned int font_size = 12);
+
 			// destroy the font
 			NESSENGINE_API ~LoadedFont();
 
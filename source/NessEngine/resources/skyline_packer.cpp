@@ -0,0 +1,143 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+#include "skyline_packer.h"
+
+namespace Ness
+{
+	namespace Resources
+	{
+		SkylinePacker::SkylinePacker(const Sizei& size) : m_size(size)
+		{
+			reset();
+		}
+
+		void SkylinePacker::reset()
+		{
+			// start with a single segment at the bottom of the whole area
+			m_skyline.clear();
+			SSkylineSegment segment;
+			segment.x = 0;
+			segment.y = 0;
+			segment.width = m_size.x;
+			m_skyline.push_back(segment);
+			m_used_area = 0;
+		}
+
+		int SkylinePacker::fit(unsigned int index, const Sizei& size) const
+		{
+			// check if exceed area width
+			int x = m_skyline[index].x;
+			if (x + size.x > m_size.x)
+				return -1;
+
+			// the rectangle must sit above all the segments it covers
+			int width_left = size.x;
+			int y = m_skyline[index].y;
+			while (width_left > 0)
+			{
+				if (m_skyline[index].y > y)
+					y = m_skyline[index].y;
+				if (y + size.y > m_size.y)
+					return -1;
+				width_left -= m_skyline[index].width;
+				index++;
+			}
+			return y;
+		}
+
+		bool SkylinePacker::insert(const Sizei& size, Pointi& out_position)
+		{
+			// invalid size?
+			if (size.x <= 0 || size.y <= 0)
+				return false;
+
+			// find the segment where the rectangle bottom will be the lowest (if equal, prefer the narrower segment)
+			int best_index = -1;
+			int best_bottom = 0;
+			int best_width = 0;
+			for (unsigned int i = 0; i < m_skyline.size(); i++)
+			{
+				int y = fit(i, size);
+				if (y < 0)
+					continue;
+
+				int bottom = y + size.y;
+				if (best_index == -1 || bottom < best_bottom || (bottom == best_bottom && m_skyline[i].width < best_width))
+				{
+					best_index = (int)i;
+					best_bottom = bottom;
+					best_width = m_skyline[i].width;
+					out_position.x = m_skyline[i].x;
+					out_position.y = y;
+				}
+			}
+
+			// no room?
+			if (best_index == -1)
+				return false;
+
+			add_level((unsigned int)best_index, out_position, size);
+			m_used_area += size.x * size.y;
+			return true;
+		}
+
+		void SkylinePacker::add_level(unsigned int index, const Pointi& position, const Sizei& size)
+		{
+			// add the new segment on top of the rectangle
+			SSkylineSegment segment;
+			segment.x = position.x;
+			segment.y = position.y + size.y;
+			segment.width = size.x;
+			m_skyline.insert(m_skyline.begin() + index, segment);
+
+			// shrink or remove the segments the new segment covers
+			for (unsigned int i = index + 1; i < m_skyline.size(); i++)
+			{
+				SSkylineSegment& prev = m_skyline[i - 1];
+				SSkylineSegment& curr = m_skyline[i];
+				if (curr.x >= prev.x + prev.width)
+					break;
+
+				int shrink = prev.x + prev.width - curr.x;
+				curr.x += shrink;
+				curr.width -= shrink;
+				if (curr.width > 0)
+					break;
+
+				m_skyline.erase(m_skyline.begin() + i);
+				i--;
+			}
+
+			// merge neighbor segments with the same height
+			for (unsigned int i = 0; i + 1 < m_skyline.size(); i++)
+			{
+				if (m_skyline[i].y == m_skyline[i + 1].y)
+				{
+					m_skyline[i].width += m_skyline[i + 1].width;
+					m_skyline.erase(m_skyline.begin() + i + 1);
+					i--;
+				}
+			}
+		}
+	};
+};
@@ -0,0 +1,85 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+/**
+* A skyline rectangles packer, used to pack many small images into big texture pages
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include "../exports.h"
+#include "../basic_types/containers.h"
+#include "../basic_types/all_basic_types.h"
+
+namespace Ness
+{
+	namespace Resources
+	{
+		/**
+		* pack rectangles into a fixed-size area using the skyline bottom-left algorithm.
+		* the packer keeps the top edge ("skyline") of everything packed so far, and puts every new rectangle where its
+		* bottom will be the lowest. this is fast and gives good results when rectangles are added sorted by height.
+		* note: packed rectangles cannot be removed, only reset the whole packer.
+		*/
+		class SkylinePacker
+		{
+		private:
+			// a single horizontal segment of the skyline
+			struct SSkylineSegment
+			{
+				int x;
+				int y;
+				int width;
+			};
+
+			Containers::Vector<SSkylineSegment>		m_skyline;			// the skyline segments, ordered from left to right
+			Sizei									m_size;				// the size of the area to pack into
+			int										m_used_area;		// total area of all packed rectangles
+
+		public:
+			// create the packer with the size of the area to pack into
+			NESSENGINE_API SkylinePacker(const Sizei& size);
+
+			// remove all packed rectangles
+			NESSENGINE_API void reset();
+
+			// find a place for a rectangle and add it.
+			// return false if there's no room left for this rectangle.
+			NESSENGINE_API bool insert(const Sizei& size, Pointi& out_position);
+
+			// get the size of the area we pack into
+			NESSENGINE_API inline const Sizei& get_size() const {return m_size;}
+
+			// return how much of the area is used (0.0 - 1.0)
+			NESSENGINE_API inline float get_occupancy() const {return (float)m_used_area / (float)(m_size.x * m_size.y);}
+
+		private:
+			// check if a rectangle can be placed at the beginning of a segment.
+			// return the y position it will be placed at, or -1 if it doesn't fit.
+			int fit(unsigned int index, const Sizei& size) const;
+
+			// add a rectangle at the beginning of a segment and update the skyline
+			void add_level(unsigned int index, const Pointi& position, const Sizei& size);
+		};
+	};
+};
@@ -76,6 +76,13 @@ namespace Ness
 		return false;
 	}
 
+	bool BasicCamera::get_visible_region(Rectangle& out_region) const
+	{
+		const Sizei& target_size = m_renderer->get_target_size();
+		out_region = Rectangle((int)floor(position.x), (int)floor(position.y), target_size.x, target_size.y);
+		return true;
+	}
+
 	Point BasicCamera::get_abs_position(const RenderableAPI* entity, const Rectangle& target_rect, const SRenderTransformations& transformations)
 	{
 		Rectangle rect = target_rect;
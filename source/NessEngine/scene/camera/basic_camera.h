@@ -69,6 +69,9 @@ namespace Ness
 		// return camera position
 		NESSENGINE_API virtual const Point& get_position() const {return position;}
 
+		// return the region this camera sees (camera position and the render target size)
+		NESSENGINE_API virtual bool get_visible_region(Rectangle& out_region) const;
+
 		// some useful operators
 		NESSENGINE_API void operator*=(float scalar) {position *= scalar;}
 		NESSENGINE_API void operator/=(float scalar) {position /= scalar;}
@@ -84,6 +84,11 @@ namespace Ness
 		// get the position of this camera
 		NESSENGINE_API virtual const Point& get_position() const = 0;
 
+		// get the region this camera sees, in the coordinates of non-static entities (before the camera is applied).
+		// used by nodes with spatial index to skip sons outside the screen. if the camera cannot describe what it sees
+		// as a single rectangle it should return false, and the nodes will test all their sons.
+		NESSENGINE_API virtual bool get_visible_region(Rectangle& out_region) const {return false;}
+
 		// check if entity should be culled out BEFORE camera transformations apply.
 		// note: this should be the minimal culling tests, just the basics. both pre and post checks will be called.
 		// entity is the renderable to test
@@ -23,6 +23,7 @@
 #include "scene.h"
 #include "camera/all_cameras.h"
 #include "../renderer/renderer.h"
+#include "../renderable/entities/entity.h"
 
 namespace Ness
 {
@@ -43,4 +44,94 @@ namespace Ness
 		m_renderer->pop_render_target();
 
 	}
-};
\ No newline at end of file
+
+	void Scene::render(const CameraApiPtr& camera)
+	{
+		if (m_flat_transformations)
+			update_flat_transformations();
+		Node::render(camera);
+	}
+
+	void Scene::set_flat_transformations(bool enable)
+	{
+		m_flat_transformations = enable;
+
+		// free the flat records when disabled and force rebuild when enabled again
+		if (!enable)
+		{
+			m_flat_records.clear();
+			m_flat_absolute.clear();
+			m_flat_generations.clear();
+		}
+		m_flat_structure_generation = m_structure_generation - 1;
+	}
+
+	void Scene::rebuild_flat_records()
+	{
+		m_flat_records.clear();
+		m_flat_absolute.clear();
+
+		// add the scene itself as the root
+		SFlatRecord root;
+		root.parent = -1;
+		root.node = this;
+		root.entity = nullptr;
+		m_flat_records.push_back(root);
+		m_flat_absolute.push_back(&m_absolute_trans);
+
+		// breadth-first iteration, so every record comes after its parent
+		for (unsigned int i = 0; i < m_flat_records.size(); i++)
+		{
+			BaseNode* node = m_flat_records[i].node;
+			if (node == nullptr || !node->__flatten_sons())
+				continue;
+
+			for (unsigned int j = 0; j < node->get_sons_count(); j++)
+			{
+				RenderablePtr son = node->get_son(j);
+				SFlatRecord record;
+				record.parent = (int)i;
+				record.node = son->is_kind(RENDERABLE_KIND_BASE_NODE) ? ness_kind_cast<BaseNode>(son) : nullptr;
+				record.entity = son->is_kind(RENDERABLE_KIND_ENTITY) ? ness_kind_cast<Entity>(son) : nullptr;
+
+				// other kind of renderables (tilemaps etc.) update themselves when needed
+				if (record.node == nullptr && record.entity == nullptr)
+					continue;
+
+				m_flat_records.push_back(record);
+				m_flat_absolute.push_back(record.node ? &record.node->get_absolute_transformations_const() : nullptr);
+			}
+		}
+
+		m_flat_generations.resize(m_flat_records.size());
+		m_flat_structure_generation = m_structure_generation;
+	}
+
+	void Scene::update_flat_transformations()
+	{
+		// rebuild if structure changed
+		if (m_flat_structure_generation != m_structure_generation)
+			rebuild_flat_records();
+
+		// scene is the root so its absolute transformations are always up-to-date
+		m_flat_generations[0] = m_trans_generation;
+
+		// update all records. parents always come before their sons so their transformations are already updated.
+		const SFlatRecord* records = &m_flat_records[0];
+		const SRenderTransformations* const* absolute = &m_flat_absolute[0];
+		Uint32* generations = &m_flat_generations[0];
+		unsigned int count = (unsigned int)m_flat_records.size();
+		for (unsigned int i = 1; i < count; i++)
+		{
+			const SFlatRecord& record = records[i];
+			if (record.node)
+			{
+				generations[i] = record.node->__update_flat_transformations(*absolute[record.parent], generations[record.parent]);
+			}
+			else
+			{
+				record.entity->__update_flat_transformations(*absolute[record.parent], generations[record.parent]);
+			}
+		}
+	}
+};
@@ -36,14 +36,32 @@
 
 namespace Ness
 {
+	// predeclare entity
+	class Entity;
+
 	/**
 	* a scene is just the root node, you first create a scene and from that you can create entities and other son nodes.
 	* you create a scene via the renderer class.
 	*/
 	class Scene : public Node
 	{
+	private:
+		// a single renderable in the flattened scene (see set_flat_transformations())
+		struct SFlatRecord
+		{
+			int			parent;			// index of the parent record
+			BaseNode*	node;			// if this record is a node, pointer to it (else null)
+			Entity*		entity;			// if this record is an entity, pointer to it (else null)
+		};
+
+		bool										m_flat_transformations;			// is flattened transformations mode enabled?
+		Uint32										m_flat_structure_generation;	// structure generation the flat records were built with
+		Containers::Vector<SFlatRecord>				m_flat_records;					// flattened scene, every record comes after its parent
+		Containers::Vector<const SRenderTransformations*>	m_flat_absolute;		// absolute transformations of node records (points to node cache)
+		Containers::Vector<Uint32>					m_flat_generations;				// transformations generation of node records
+
 	public:
-		NESSENGINE_API Scene(Renderer* renderer) : Node(renderer) {}
+		NESSENGINE_API Scene(Renderer* renderer) : Node(renderer), m_flat_transformations(false), m_flat_structure_generation(0) {}
 
 		// scene should never have parent, so it's easy - absolute transformation is self transformation
 		NESSENGINE_API virtual const SRenderTransformations& get_absolute_transformations() {return m_absolute_trans;}
@@ -54,8 +72,30 @@ namespace Ness
 		// render on a viewport
 		NESSENGINE_API virtual void render_on_viewport(const ViewportPtr& viewport, const CameraApiPtr& camera);
 
+		// render the scene (if flattened transformations are enabled, will update them first)
+		NESSENGINE_API virtual void render(const CameraApiPtr& camera);
+		NESSENGINE_API virtual void render() {Node::render();}
+
+		// enable / disable flattened transformations mode.
+		// normally every entity calculates its absolute transformations when needed, by asking its parent (which asks its own parent, etc.)
+		// in this mode the scene keeps a flat array of all its nodes and entities, ordered so that parents always come before their sons,
+		// and once per render updates all the absolute transformations and target rects in a single linear pass.
+		// the array is only rebuilt when nodes or entities are added or removed.
+		// this is useful for scenes with many entities that move every frame. note: sons of tilemaps, nodes-maps and particles nodes are
+		// not part of the flat array and still update themselves when needed.
+		NESSENGINE_API void set_flat_transformations(bool enable);
+		NESSENGINE_API inline bool is_flat_transformations() const {return m_flat_transformations;}
+
+		// update all the absolute transformations using the flat array (rebuild it if the scene structure changed).
+		// called automatically when rendering the scene with flattened transformations mode enabled.
+		NESSENGINE_API void update_flat_transformations();
+
 		// disable the possibility to add a scene as a son
 		NESSENGINE_API virtual void __change_parent(NodeAPI* parent) {throw IllegalAction("cannot assign scene under another scene or node!");}
+
+	private:
+		// rebuild the flat records from the scene graph
+		void rebuild_flat_records();
 	};
 
 	// scene pointer
@@ -0,0 +1,174 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+#include "workers_pool.h"
+#include "../../exceptions/exceptions.h"
+#include "../../exceptions/log.h"
+
+namespace Ness
+{
+	namespace Utils
+	{
+		WorkersPool::WorkersPool(unsigned int threads_count) : m_busy(0), m_stop(false)
+		{
+			// get default threads count
+			if (threads_count == 0)
+			{
+				int cpus = SDL_GetCPUCount();
+				threads_count = (cpus > 2) ? (unsigned int)(cpus - 1) : 1;
+			}
+
+			// create sync objects
+			m_mutex = SDL_CreateMutex();
+			m_has_tasks = SDL_CreateCond();
+			m_tasks_done = SDL_CreateCond();
+			if (m_mutex == nullptr || m_has_tasks == nullptr || m_tasks_done == nullptr)
+			{
+				throw UnexpectedError(SDL_GetError());
+			}
+
+			// create the workers
+			for (unsigned int i = 0; i < threads_count; ++i)
+			{
+				SDL_Thread* thread = SDL_CreateThread(WorkersPool::worker_main, "ness_worker", this);
+				if (thread == nullptr)
+				{
+					throw UnexpectedError(SDL_GetError());
+				}
+				m_threads.push_back(thread);
+			}
+		}
+
+		WorkersPool::~WorkersPool()
+		{
+			stop();
+			SDL_DestroyCond(m_tasks_done);
+			SDL_DestroyCond(m_has_tasks);
+			SDL_DestroyMutex(m_mutex);
+		}
+
+		void WorkersPool::stop()
+		{
+			// tell all workers to stop and drop pending tasks
+			SDL_LockMutex(m_mutex);
+			m_stop = true;
+			m_tasks.clear();
+			SDL_CondBroadcast(m_has_tasks);
+			SDL_UnlockMutex(m_mutex);
+
+			// wait for all the workers to exit
+			for (auto thread = m_threads.begin(); thread != m_threads.end(); ++thread)
+			{
+				SDL_WaitThread(*thread, nullptr);
+			}
+			m_threads.clear();
+		}
+
+		void WorkersPool::push_task(const WorkerTaskPtr& task)
+		{
+			SDL_LockMutex(m_mutex);
+			if (m_stop)
+			{
+				SDL_UnlockMutex(m_mutex);
+				throw IllegalAction("Cannot push tasks to a stopped workers pool!");
+			}
+			m_tasks.push_back(task);
+			SDL_CondSignal(m_has_tasks);
+			SDL_UnlockMutex(m_mutex);
+		}
+
+		void WorkersPool::wait_all()
+		{
+			SDL_LockMutex(m_mutex);
+			while (!m_tasks.empty() || m_busy > 0)
+			{
+				SDL_CondWait(m_tasks_done, m_mutex);
+			}
+			std::exception_ptr error = m_error;
+			m_error = std::exception_ptr();
+			SDL_UnlockMutex(m_mutex);
+
+			// rethrow tasks errors on the waiting thread
+			if (error != std::exception_ptr())
+			{
+				std::rethrow_exception(error);
+			}
+		}
+
+		unsigned int WorkersPool::get_pending_tasks_count()
+		{
+			SDL_LockMutex(m_mutex);
+			unsigned int ret = (unsigned int)m_tasks.size() + m_busy;
+			SDL_UnlockMutex(m_mutex);
+			return ret;
+		}
+
+		int WorkersPool::worker_main(void* pool)
+		{
+			((WorkersPool*)pool)->worker_loop();
+			return 0;
+		}
+
+		void WorkersPool::worker_loop()
+		{
+			SDL_LockMutex(m_mutex);
+			while (true)
+			{
+				// wait for tasks
+				while (m_tasks.empty() && !m_stop)
+				{
+					SDL_CondWait(m_has_tasks, m_mutex);
+				}
+
+				// stop?
+				if (m_stop)
+					break;
+
+				// take the next task and execute it without holding the lock
+				WorkerTaskPtr task = m_tasks.front();
+				m_tasks.pop_front();
+				m_busy++;
+				SDL_UnlockMutex(m_mutex);
+				std::exception_ptr error;
+				try
+				{
+					task->execute();
+				}
+				catch (...)
+				{
+					// keep the worker alive and pass the error to whoever waits for the tasks
+					NESS_ERROR("exception in worker task!");
+					error = std::current_exception();
+				}
+				task.reset();
+				SDL_LockMutex(m_mutex);
+				if (error != std::exception_ptr() && m_error == std::exception_ptr())
+				{
+					m_error = error;
+				}
+				m_busy--;
+				SDL_CondBroadcast(m_tasks_done);
+			}
+			SDL_UnlockMutex(m_mutex);
+		}
+	};
+};
@@ -0,0 +1,106 @@
+/* 
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Ronen Ness
+  ronenness@gmail.com
+
+*/
+
+/**
+* A simple pool of worker threads you can push tasks to.
+* Author: Ronen Ness
+* Since: 10/2026
+*/
+
+#pragma once
+#include <SDL.h>
+#include <exception>
+#include "../../exports.h"
+#include "../../basic_types/containers.h"
+#include "../../basic_types/pointers.h"
+
+namespace Ness
+{
+	namespace Utils
+	{
+		// a task to run on a worker thread.
+		// inherit from this class and implement execute().
+		class WorkerTask
+		{
+		public:
+			NESSENGINE_API virtual ~WorkerTask() {}
+
+			// the actual work to do. this is called from one of the workers threads!
+			NESSENGINE_API virtual void execute() = 0;
+		};
+
+		// worker task pointer
+		NESSENGINE_API typedef SharedPtr<WorkerTask> WorkerTaskPtr;
+
+		/**
+		* a pool of worker threads that execute tasks in the background.
+		* tasks are executed by the order they were pushed, but since there are multiple workers they may end in any order.
+		*/
+		class WorkersPool
+		{
+		private:
+			Containers::Vector<SDL_Thread*>			m_threads;			// the worker threads
+			Containers::Deque<WorkerTaskPtr>		m_tasks;			// tasks waiting to be executed
+			SDL_mutex*								m_mutex;			// mutex to protect the tasks queue
+			SDL_cond*								m_has_tasks;		// signaled when new tasks are pushed (or when stopping)
+			SDL_cond*								m_tasks_done;		// signaled when a worker finish a task
+			unsigned int							m_busy;				// how many workers are currently executing a task
+			bool									m_stop;				// if true, workers will exit
+			std::exception_ptr						m_error;			// the first exception a task threw since the last wait_all()
+
+		public:
+			// create the workers pool.
+			// threads_count is how many workers to create. if 0, will create one worker per cpu core minus one (at least one worker)
+			NESSENGINE_API WorkersPool(unsigned int threads_count = 0);
+
+			// stop all workers and destroy the pool
+			NESSENGINE_API ~WorkersPool();
+
+			// push a task to be executed in the background
+			NESSENGINE_API void push_task(const WorkerTaskPtr& task);
+
+			// block until all the pushed tasks are done.
+			// if tasks threw exceptions, the first one is rethrown here (on the waiting thread) and the rest are dropped.
+			NESSENGINE_API void wait_all();
+
+			// stop all workers. tasks that are already running will finish, tasks that didn't start yet are dropped.
+			// after calling this the pool is no longer useable.
+			NESSENGINE_API void stop();
+
+			// return how many worker threads we have
+			NESSENGINE_API inline unsigned int get_threads_count() const {return (unsigned int)m_threads.size();}
+
+			// return how many tasks are waiting or running
+			NESSENGINE_API unsigned int get_pending_tasks_count();
+
+		private:
+			// the main function of the workers threads
+			static int worker_main(void* pool);
+
+			// the loop every worker runs - wait for tasks and execute them
+			void worker_loop();
+		};
+
+		// workers pool pointer
+		NESSENGINE_API typedef SharedPtr<WorkersPool> WorkersPoolPtr;
+	};
+};